@@ -0,0 +1,106 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_BENCH_H
+#define G_BENCH_H
+
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace giada {
+namespace bench
+{
+/* State
+Handle passed to each benchmark. A benchmark prepares its data, describes the
+variant being measured with param() and items(), then calls run() once per 
+variant. Each run() produces one entry in the JSON report. */
+
+class State
+{
+public:
+
+	State(const std::string& name, int iterations);
+
+	/* param
+	Adds a parameter to the next run(), e.g. the number of channels. */
+
+	void param(const std::string& key, double value);
+
+	/* items
+	How many items (frames, actions, ...) a single iteration processes. Used to
+	compute the throughput of the next run(). */
+
+	void items(double n);
+
+	/* iterations
+	Caps the number of iterations of the next run(), for heavy operations. */
+
+	void iterations(int n);
+
+	/* run
+	Times 'f' over the requested iterations, after a warm-up call. 'setup', if 
+	any, is called before each iteration and is not timed. */
+
+	void run(std::function<void()> f, std::function<void()> setup=nullptr);
+
+private:
+
+	std::string m_name;
+	int         m_defaultIterations;
+	int         m_iterations;
+	double      m_items;
+	std::vector<std::pair<std::string, double>> m_params;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+/* Registrar
+Adds a benchmark to the global list at static initialization time. Use the 
+G_BENCHMARK macro below instead. */
+
+struct Registrar
+{
+	Registrar(const char* name, void (*f)(State&));
+};
+
+#define G_BENCHMARK_CAT_(a, b) a##b
+#define G_BENCHMARK_ID_(a, b)  G_BENCHMARK_CAT_(a, b)
+
+#define G_BENCHMARK(name) \
+	static void G_BENCHMARK_ID_(bench_, __LINE__)(giada::bench::State&); \
+	static giada::bench::Registrar G_BENCHMARK_ID_(registrar_, __LINE__)(name, \
+		G_BENCHMARK_ID_(bench_, __LINE__)); \
+	static void G_BENCHMARK_ID_(bench_, __LINE__)(giada::bench::State& state)
+}} // giada::bench::
+
+
+#endif
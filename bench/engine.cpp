@@ -0,0 +1,63 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "../src/core/channels/channelManager.h"
+#include "../src/core/mixerHandler.h"
+#include "../src/core/waveManager.h"
+#include "../src/core/kernelAudio.h"
+#include "../src/core/recorder.h"
+#include "../src/core/patch.h"
+#include "../src/core/clock.h"
+#include "../src/core/conf.h"
+#include "engine.h"
+
+
+namespace giada {
+namespace bench
+{
+void startEngine()
+{
+	using namespace giada::m;
+
+	kernelAudio::openOffline();
+	channelManager::init();
+	waveManager::init();
+	patch::init();
+	clock::init(conf::samplerate, conf::midiTCfps);
+	mh::init();
+	recorder::init();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void stopEngine()
+{
+	m::mh::close();
+}
+}} // giada::bench::
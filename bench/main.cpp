@@ -0,0 +1,234 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <jansson.h>
+#include "../src/utils/log.h"
+#include "../src/core/const.h"
+#include "bench.h"
+
+
+/* There's no main.cpp in the benchmark suite and the following global var is 
+unfortunately defined there. Let's fake it. */
+
+class gdMainWindow* G_MainWin;
+
+
+namespace giada {
+namespace bench
+{
+namespace
+{
+struct Benchmark
+{
+	std::string name;
+	void (*f)(State&);
+};
+
+
+std::vector<Benchmark>& getBenchmarks_()
+{
+	static std::vector<Benchmark> benchmarks;
+	return benchmarks;
+}
+
+
+json_t* results_ = nullptr;
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void usage_()
+{
+	std::fprintf(stderr, "Usage: giada_bench [--filter text] [--iterations N] "
+		"[--out file.json] [--list]\n");
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+Registrar::Registrar(const char* name, void (*f)(State&))
+{
+	getBenchmarks_().push_back({ name, f });
+}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+State::State(const std::string& name, int iterations)
+: m_name             (name),
+  m_defaultIterations(iterations),
+  m_iterations       (iterations),
+  m_items            (0.0)
+{
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void State::param(const std::string& key, double value)
+{
+	m_params.push_back({ key, value });
+}
+
+
+void State::items(double n)
+{
+	m_items = n;
+}
+
+
+void State::iterations(int n)
+{
+	m_iterations = std::max(1, std::min(n, m_defaultIterations));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void State::run(std::function<void()> f, std::function<void()> setup)
+{
+	using clock = std::chrono::steady_clock;
+
+	if (setup != nullptr) setup();
+	f(); // Warm-up
+
+	std::vector<double> times(m_iterations);
+	for (double& t : times) {
+		if (setup != nullptr) setup();
+		clock::time_point start = clock::now();
+		f();
+		t = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+	}
+	std::sort(times.begin(), times.end());
+
+	double mean   = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+	double median = times[times.size() / 2];
+	double var    = 0.0;
+	for (double t : times)
+		var += (t - mean) * (t - mean);
+
+	std::string fullName = m_name;
+	json_t* jparams = json_object();
+	for (const auto& p : m_params) {
+		char value[32];
+		std::snprintf(value, sizeof(value), "%g", p.second);
+		fullName += "/" + p.first + ":" + value;
+		json_object_set_new(jparams, p.first.c_str(), json_real(p.second));
+	}
+
+	json_t* j = json_object();
+	json_object_set_new(j, "name",       json_string(fullName.c_str()));
+	json_object_set_new(j, "params",     jparams);
+	json_object_set_new(j, "iterations", json_integer(m_iterations));
+	json_object_set_new(j, "min_ns",     json_real(times.front()));
+	json_object_set_new(j, "median_ns",  json_real(median));
+	json_object_set_new(j, "mean_ns",    json_real(mean));
+	json_object_set_new(j, "max_ns",     json_real(times.back()));
+	json_object_set_new(j, "stddev_ns",  json_real(std::sqrt(var / times.size())));
+	if (m_items > 0.0)
+		json_object_set_new(j, "items_per_second", json_real(m_items / (median / 1e9)));
+	json_array_append_new(results_, j);
+
+	std::fprintf(stderr, "%-60s %12.0f ns\n", fullName.c_str(), median);
+
+	m_params.clear();
+	m_items      = 0.0;
+	m_iterations = m_defaultIterations;
+}
+}} // giada::bench::
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+int main(int argc, char** argv)
+{
+	using namespace giada::bench;
+
+	std::string filter;
+	std::string out;
+	int         iterations = 100;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--list") {
+			for (const Benchmark& b : getBenchmarks_())
+				std::printf("%s\n", b.name.c_str());
+			return 0;
+		}
+		if (i + 1 == argc) {
+			usage_();
+			return 1;
+		}
+		if      (arg == "--filter")     filter     = argv[++i];
+		else if (arg == "--out")        out        = argv[++i];
+		else if (arg == "--iterations") iterations = std::max(1, std::atoi(argv[++i]));
+		else {
+			usage_();
+			return 1;
+		}
+	}
+
+	giada::u::log::init(LOG_MODE_MUTE);
+
+	results_ = json_array();
+
+	for (const Benchmark& b : getBenchmarks_()) {
+		if (filter != "" && b.name.find(filter) == std::string::npos)
+			continue;
+		State s(b.name, iterations);
+		b.f(s);
+	}
+
+	json_t* j = json_object();
+	json_object_set_new(j, "version",    json_string(G_VERSION_STR));
+	json_object_set_new(j, "benchmarks", results_);
+
+	int res = out == "" ? json_dumpf(j, stdout, JSON_INDENT(2)) : 
+	                      json_dump_file(j, out.c_str(), JSON_INDENT(2));
+	json_decref(j);
+
+	return res == 0 ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <memory>
+#include <cmath>
+#include "../src/core/model/model.h"
+#include "../src/core/channels/sampleChannel.h"
+#include "../src/core/mixerHandler.h"
+#include "../src/core/mixer.h"
+#include "../src/core/kernelAudio.h"
+#include "../src/core/audioBuffer.h"
+#include "../src/core/clock.h"
+#include "../src/core/conf.h"
+#include "../src/core/wave.h"
+#include "../src/core/waveManager.h"
+#include "../src/core/const.h"
+#include "../src/core/types.h"
+#include "engine.h"
+#include "bench.h"
+
+
+using namespace giada;
+using namespace giada::m;
+
+
+namespace
+{
+/* addPlayingChannel_
+Adds a Sample Channel with a 10 seconds Wave, playing in loop. */
+
+void addPlayingChannel_()
+{
+	const int size = conf::samplerate * 10;
+
+	std::unique_ptr<Wave> w = waveManager::createEmpty(size, G_MAX_IO_CHANS, 
+		conf::samplerate, "bench.wav");
+	for (int i = 0; i < size; i++)
+		for (int j = 0; j < G_MAX_IO_CHANS; j++)
+			w->editFrame(i)[j] = std::sin(i * 0.01f);
+
+	mh::addAndLoadChannel(/*columnId=*/1, std::move(w));
+
+	model::channels.lock();
+	ID id = model::channels.back()->id;
+	model::channels.unlock();
+
+	model::onSwap(model::channels, id, [](Channel& c)
+	{
+		SampleChannel& sc = static_cast<SampleChannel&>(c);
+		sc.mode       = ChannelMode::LOOP_BASIC;
+		sc.playStatus = ChannelStatus::PLAY;
+	});
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* mixer.masterPlay
+masterPlay() itself returns early without an audio device: renderOffline() 
+runs the very same processing chain. */
+
+G_BENCHMARK("mixer.masterPlay")
+{
+	bench::startEngine();
+
+	AudioBuffer out;
+	out.alloc(kernelAudio::getRealBufSize(), G_MAX_IO_CHANS);
+
+	clock::setStatus(ClockStatus::RUNNING);
+
+	int channels = 0;
+	for (int n : { 1, 8, 32, 128 }) {
+		for (; channels < n; channels++)
+			addPlayingChannel_();
+		state.param("channels", n);
+		state.param("threads", conf::renderThreads);
+		state.items(out.countFrames());
+		state.run([&]() { mixer::renderOffline(out); });
+	}
+
+	clock::setStatus(ClockStatus::STOPPED);
+
+	bench::stopEngine();
+}
@@ -0,0 +1,123 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "../src/core/model/model.h"
+#include "../src/core/mixerHandler.h"
+#include "../src/core/recorder.h"
+#include "../src/core/midiEvent.h"
+#include "../src/core/action.h"
+#include "../src/core/patch.h"
+#include "../src/core/const.h"
+#include "../src/core/types.h"
+#include "engine.h"
+#include "bench.h"
+
+
+using namespace giada;
+using namespace giada::m;
+
+
+namespace
+{
+const char* PATCH_FILE = "./bench-patch.gptc";
+const int   CHANNELS   = 256;
+const int   ACTIONS    = 100000;
+const int   ITERATIONS = 10;
+
+
+/* makeSession_
+Fills the engine with CHANNELS empty channels, half Sample and half MIDI, and 
+ACTIONS actions spread over them. */
+
+void makeSession_()
+{
+	std::vector<ID> channels;
+	for (int i = 0; i < CHANNELS; i++)
+		channels.push_back(mh::addChannel(i % 2 ? ChannelType::MIDI : 
+			ChannelType::SAMPLE, /*columnId=*/1));
+
+	std::mt19937 rng(0);
+	std::uniform_int_distribution<Frame> frame(0, 44100 * 60);
+
+	std::vector<Action> actions;
+	for (int i = 0; i < ACTIONS; i++)
+		actions.push_back(recorder::makeAction(0, channels[i % CHANNELS], 
+			frame(rng), MidiEvent(MidiEvent::NOTE_ON, 0x00, 0x00)));
+	
+	model::onSwap(model::actions, [&](model::Actions& as)
+	{
+		as.timeline.assign(actions);
+	});
+}
+
+
+void restart_()
+{
+	bench::stopEngine();
+	bench::startEngine();
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+G_BENCHMARK("patch.write")
+{
+	bench::startEngine();
+	makeSession_();
+
+	state.iterations(ITERATIONS);
+	state.param("channels", CHANNELS);
+	state.param("actions", ACTIONS);
+	state.run([]() { patch::write("bench", PATCH_FILE, /*isProject=*/false); });
+
+	bench::stopEngine();
+	std::remove(PATCH_FILE);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+G_BENCHMARK("patch.read")
+{
+	bench::startEngine();
+	makeSession_();
+	patch::write("bench", PATCH_FILE, /*isProject=*/false);
+
+	state.iterations(ITERATIONS);
+	state.param("channels", CHANNELS);
+	state.param("actions", ACTIONS);
+	state.run([]() { patch::read(PATCH_FILE, ""); }, restart_);
+
+	bench::stopEngine();
+	std::remove(PATCH_FILE);
+}
@@ -0,0 +1,145 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../src/core/rcuList.h"
+#include "../src/core/types.h"
+#include "bench.h"
+
+
+using namespace giada;
+using namespace giada::m;
+
+
+namespace
+{
+const int ITEMS = 64;
+
+
+struct Object
+{
+	Object(ID id) : id(id), value(0) {}
+	ID  id;
+	int value;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void fill_(RCUList<Object>& list)
+{
+	for (int i = 0; i < ITEMS; i++)
+		list.push(std::make_unique<Object>(i + 1));
+}
+
+
+int read_(RCUList<Object>& list)
+{
+	RCUList<Object>::Lock l(list);
+	int sum = 0;
+	for (const Object* o : list)
+		sum += o->value;
+	return sum;
+}
+
+
+void swap_(RCUList<Object>& list, size_t i)
+{
+	std::unique_ptr<Object> o = list.clone(i);
+	o->value++;
+	list.swap(std::move(o), i);
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* RCUList.read
+Full scan of the list by the measuring thread, while 'writers' threads keep 
+swapping elements. */
+
+G_BENCHMARK("RCUList.read")
+{
+	RCUList<Object> list;
+	fill_(list);
+
+	for (int writers : { 0, 1, 4 }) {
+		std::atomic<bool>        stop(false);
+		std::vector<std::thread> threads;
+		for (int i = 0; i < writers; i++)
+			threads.emplace_back([&list, &stop, i]()
+			{
+				while (!stop.load())
+					swap_(list, i % ITEMS);
+			});
+
+		volatile int sink = 0;
+		state.param("writers", writers);
+		state.items(ITEMS);
+		state.run([&]() { sink = read_(list); });
+
+		stop.store(true);
+		for (std::thread& t : threads)
+			t.join();
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* RCUList.swap
+Clone + swap of a single element by the measuring thread, while 'readers' 
+threads keep scanning the list. */
+
+G_BENCHMARK("RCUList.swap")
+{
+	RCUList<Object> list;
+	fill_(list);
+
+	for (int readers : { 0, 1, 4 }) {
+		std::atomic<bool>        stop(false);
+		std::vector<std::thread> threads;
+		for (int i = 0; i < readers; i++)
+			threads.emplace_back([&list, &stop]()
+			{
+				while (!stop.load())
+					read_(list);
+			});
+
+		size_t i = 0;
+		state.param("readers", readers);
+		state.run([&]() { swap_(list, i++ % ITEMS); });
+
+		stop.store(true);
+		for (std::thread& t : threads)
+			t.join();
+	}
+}
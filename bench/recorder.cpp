@@ -0,0 +1,128 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <random>
+#include <vector>
+#include "../src/core/model/model.h"
+#include "../src/core/recorder.h"
+#include "../src/core/midiEvent.h"
+#include "../src/core/action.h"
+#include "../src/core/types.h"
+#include "bench.h"
+
+
+using namespace giada;
+using namespace giada::m;
+
+
+namespace
+{
+const int   CHANNELS = 64;
+const Frame LOOP     = 44100 * 60;
+const Frame BLOCK    = 1024;
+
+
+/* record_
+Fills the recorder with 'count' actions spread over CHANNELS channels and a 
+one minute loop. */
+
+void record_(int count)
+{
+	recorder::init();
+
+	std::mt19937 rng(count);
+	std::uniform_int_distribution<Frame> frame(0, LOOP - 1);
+
+	std::vector<Action> actions;
+	for (int i = 0; i < count; i++)
+		actions.push_back(recorder::makeAction(0, i % CHANNELS, frame(rng), 
+			MidiEvent(MidiEvent::NOTE_ON, 0x00, 0x00)));
+	model::onSwap(model::actions, [&](model::Actions& as)
+	{
+		as.timeline.assign(actions);
+	});
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* recorder.getActionsOnFrame
+Queries every frame of a block, as the mixer does while playing. 'sequential'
+walks the loop block after block, otherwise blocks are picked at random. */
+
+G_BENCHMARK("recorder.getActionsOnFrame")
+{
+	for (int count : { 1000, 100000 }) {
+		record_(count);
+
+		for (bool sequential : { true, false }) {
+			std::mt19937 rng(0);
+			std::uniform_int_distribution<Frame> start(0, LOOP - BLOCK);
+
+			Frame        f    = 0;
+			volatile int sink = 0;
+
+			state.param("actions", count);
+			state.param("sequential", sequential);
+			state.items(BLOCK);
+			state.run([&]()
+			{
+				f = sequential ? (f + BLOCK) % (LOOP - BLOCK) : start(rng);
+				int found = 0;
+				for (Frame i = f; i < f + BLOCK; i++)
+					for (const Action& a : recorder::getActionsOnFrame(i)) {
+						(void) a;
+						found++;
+					}
+				sink = found;
+			});
+		}
+	}
+	recorder::init();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+G_BENCHMARK("recorder.rec")
+{
+	for (int count : { 1000, 100000 }) {
+		record_(count);
+
+		std::mt19937 rng(0);
+		std::uniform_int_distribution<Frame> frame(0, LOOP - 1);
+
+		state.param("actions", count);
+		state.run([&]()
+		{
+			recorder::rec(0, frame(rng), MidiEvent(MidiEvent::NOTE_ON, 0x00, 0x00));
+		});
+	}
+	recorder::init();
+}
@@ -0,0 +1,125 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <memory>
+#include <cmath>
+#include "../src/core/model/model.h"
+#include "../src/core/channels/sampleChannel.h"
+#include "../src/core/channels/sampleChannelProc.h"
+#include "../src/core/audioBuffer.h"
+#include "../src/core/wave.h"
+#include "../src/core/const.h"
+#include "../src/core/types.h"
+#include "bench.h"
+
+
+using namespace giada;
+using namespace giada::m;
+
+
+namespace
+{
+const ID  WAVE_ID     = 1;
+const int BUFFER_SIZE = 1024;
+const int SAMPLE_RATE = 44100;
+const int WAVE_SIZE   = SAMPLE_RATE * 60;
+
+
+void makeWave_()
+{
+	std::unique_ptr<Wave> w = std::make_unique<Wave>(WAVE_ID);
+	w->alloc(WAVE_SIZE, G_MAX_IO_CHANS, SAMPLE_RATE, 32, "bench.wav");
+	for (int i = 0; i < WAVE_SIZE; i++)
+		for (int j = 0; j < G_MAX_IO_CHANS; j++)
+			w->editFrame(i)[j] = std::sin(i * 0.01f);
+
+	model::waves.clear();
+	model::waves.push(std::move(w));
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+G_BENCHMARK("sampleChannel.fillBuffer")
+{
+	makeWave_();
+
+	SampleChannel ch(false, BUFFER_SIZE, 1, 1);
+	ch.pushWave(WAVE_ID, WAVE_SIZE);
+
+	for (float pitch : { 1.0f, 0.5f, 1.5f }) {
+		for (ResamplerQuality q : { ResamplerQuality::LINEAR, ResamplerQuality::CUBIC, 
+		                            ResamplerQuality::SINC }) {
+			if (pitch == 1.0f && q != ResamplerQuality::LINEAR) // Not resampled
+				continue;
+			ch.setPitch(pitch);
+			ch.resampler.setQuality(q);
+			Frame tracker = 0;
+			state.param("pitch", pitch);
+			state.param("resampler", static_cast<int>(q));
+			state.items(BUFFER_SIZE);
+			state.run([&]()
+			{
+				tracker += ch.fillBuffer(ch.buffer, tracker, 0);
+				if (tracker >= WAVE_SIZE - BUFFER_SIZE * 2)
+					tracker = 0;
+			});
+		}
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+G_BENCHMARK("sampleChannelProc.render")
+{
+	makeWave_();
+
+	SampleChannel ch(false, BUFFER_SIZE, 1, 1);
+	ch.pushWave(WAVE_ID, WAVE_SIZE);
+	ch.mode       = ChannelMode::LOOP_BASIC;
+	ch.playStatus = ChannelStatus::PLAY;
+
+	AudioBuffer out, in, inToOut;
+	out.alloc(BUFFER_SIZE, G_MAX_IO_CHANS);
+	inToOut.alloc(BUFFER_SIZE, G_MAX_IO_CHANS);
+
+	for (float pitch : { 1.0f, 1.5f }) {
+		ch.setPitch(pitch);
+		state.param("pitch", pitch);
+		state.items(BUFFER_SIZE);
+		state.run([&]()
+		{
+			out.clear();
+			sampleChannelProc::render(&ch, out, in, inToOut, /*audible=*/true, 
+				/*running=*/false);
+		});
+	}
+}
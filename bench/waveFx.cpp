@@ -0,0 +1,160 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <memory>
+#include <cmath>
+#include "../src/core/model/model.h"
+#include "../src/core/wave.h"
+#include "../src/core/waveFx.h"
+#include "../src/core/const.h"
+#include "../src/core/types.h"
+#include "bench.h"
+
+
+using namespace giada;
+using namespace giada::m;
+
+
+namespace
+{
+const ID  WAVE_ID     = 1;
+const int SAMPLE_RATE = 44100;
+const int WAVE_SIZE   = SAMPLE_RATE * 60 * 5; // 5 minutes, stereo
+const int ITERATIONS  = 10;
+const int A           = WAVE_SIZE / 4;   // Selection
+const int B           = WAVE_SIZE / 2;
+
+
+std::unique_ptr<Wave> makeWave_(ID id, int size)
+{
+	std::unique_ptr<Wave> w = std::make_unique<Wave>(id);
+	w->alloc(size, G_MAX_IO_CHANS, SAMPLE_RATE, 32, "bench.wav");
+	for (int i = 0; i < size; i++)
+		for (int j = 0; j < G_MAX_IO_CHANS; j++)
+			w->editFrame(i)[j] = std::sin(i * 0.01f) * 0.5f;
+	return w;
+}
+
+
+/* reset_
+Puts a brand new long Wave in the model. Operations that change the Wave size
+reset it before each iteration, so that all iterations work on the same data. */
+
+void reset_()
+{
+	model::waves.clear();
+	model::waves.push(makeWave_(WAVE_ID, WAVE_SIZE));
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+G_BENCHMARK("waveFx.normalizeHard")
+{
+	reset_();
+	state.iterations(ITERATIONS);
+	state.items(B - A);
+	state.run([]() { wfx::normalizeHard(WAVE_ID, A, B); });
+}
+
+
+G_BENCHMARK("waveFx.silence")
+{
+	reset_();
+	state.iterations(ITERATIONS);
+	state.items(B - A);
+	state.run([]() { wfx::silence(WAVE_ID, A, B); });
+}
+
+
+G_BENCHMARK("waveFx.fade")
+{
+	reset_();
+	state.iterations(ITERATIONS);
+	state.items(B - A);
+	state.run([]() { wfx::fade(WAVE_ID, A, B, wfx::FADE_IN); });
+}
+
+
+G_BENCHMARK("waveFx.smooth")
+{
+	reset_();
+	state.iterations(ITERATIONS);
+	state.items(B - A);
+	state.run([]() { wfx::smooth(WAVE_ID, A, B); });
+}
+
+
+G_BENCHMARK("waveFx.reverse")
+{
+	reset_();
+	state.iterations(ITERATIONS);
+	state.items(B - A);
+	state.run([]() { wfx::reverse(WAVE_ID, A, B); });
+}
+
+
+G_BENCHMARK("waveFx.shift")
+{
+	reset_();
+	state.iterations(ITERATIONS);
+	state.items(WAVE_SIZE);
+	state.run([]() { wfx::shift(WAVE_ID, SAMPLE_RATE); });
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+G_BENCHMARK("waveFx.cut")
+{
+	state.iterations(ITERATIONS);
+	state.items(WAVE_SIZE);
+	state.run([]() { wfx::cut(WAVE_ID, A, B); }, reset_);
+}
+
+
+G_BENCHMARK("waveFx.trim")
+{
+	state.iterations(ITERATIONS);
+	state.items(WAVE_SIZE);
+	state.run([]() { wfx::trim(WAVE_ID, A, B); }, reset_);
+}
+
+
+G_BENCHMARK("waveFx.paste")
+{
+	std::unique_ptr<Wave> clip = makeWave_(WAVE_ID + 1, SAMPLE_RATE * 10);
+
+	state.iterations(ITERATIONS);
+	state.items(WAVE_SIZE);
+	state.run([&]() { wfx::paste(*clip, WAVE_ID, A); }, reset_);
+
+	model::waves.clear();
+}
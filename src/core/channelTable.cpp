@@ -0,0 +1,79 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+
+#include "core/channels/channel.h"
+#include "core/mixer.h"
+#include "channelTable.h"
+
+
+namespace giada {
+namespace m
+{
+namespace
+{
+bool isMaster_(const Channel& ch)
+{
+	return ch.id == mixer::MASTER_OUT_CHANNEL_ID || 
+	       ch.id == mixer::MASTER_IN_CHANNEL_ID;
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+void ChannelTable::load(const std::vector<Channel*>& channels)
+{
+	channel.clear();
+	id.clear();
+	idle.clear();
+	render.clear();
+
+	for (Channel* ch : channels) {
+		bool master = isMaster_(*ch);
+		bool empty  = ch->type == ChannelType::SAMPLE && ch->playStatus == ChannelStatus::EMPTY;
+		if (!master)
+			render.push_back(channel.size());
+		channel.push_back(ch);
+		id.push_back(ch->id);
+		idle.push_back(master || empty);
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+size_t ChannelTable::size() const
+{
+	return channel.size();
+}
+}} // giada::m::
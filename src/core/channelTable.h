@@ -0,0 +1,82 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+
+#ifndef G_CHANNEL_TABLE_H
+#define G_CHANNEL_TABLE_H
+
+
+#include <cstdint>
+#include <vector>
+#include "core/types.h"
+
+
+namespace giada {
+namespace m
+{
+class Channel;
+
+/* ChannelTable
+Per-snapshot data of the channel list, laid out as a struct-of-arrays: slot 'i'
+of each array belongs to the i-th channel of the snapshot. It is built by the 
+writer when a new snapshot is published (see RCUList::publish) and never 
+changes afterwards, so the audio thread only reads it: no allocations, no
+pointer chasing to find out which channels have work to do. */
+
+class ChannelTable
+{
+public:
+
+	/* load
+	Fills the table with the channels in 'channels'. Called by the writer, 
+	before the snapshot is published. */
+
+	void load(const std::vector<Channel*>& channels);
+
+	size_t size() const;
+
+	std::vector<Channel*> channel;
+	std::vector<ID>       id;
+
+	/* idle
+	Whether the channel has nothing to do when parsing events, i.e. it is a 
+	master channel or a Sample channel without Wave. Both never change in 
+	place: they are set on a copy before it is published. */
+
+	std::vector<uint8_t> idle;
+
+	/* render
+	Slots of the channels that are rendered into their own buffer, i.e. all but
+	the master channels, in list order. */
+
+	std::vector<size_t> render;
+};
+}} // giada::m::
+
+
+#endif
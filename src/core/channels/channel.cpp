@@ -27,6 +27,7 @@
 
 #include <cassert>
 #include "utils/log.h"
+#include "utils/math.h"
 #include "core/channels/channelManager.h"
 #include "core/const.h"
 #include "core/pluginManager.h"
@@ -64,6 +65,8 @@ Channel::Channel(ChannelType type, ChannelStatus playStatus, int bufferSize,
   solo           (false),
   volume_i       (1.0f),
   volume_d       (0.0f),
+  volumeEnvelope (bufferSize, 1.0f),
+  volumeEnvelopeFrame(0),
   hasActions     (false),
   readActions    (false),
   midiIn         (true),
@@ -79,12 +82,18 @@ Channel::Channel(ChannelType type, ChannelStatus playStatus, int bufferSize,
   midiOutLplaying(0x0),
   midiOutLmute   (0x0),
   midiOutLsolo   (0x0)
+#ifdef WITH_VST
+ ,midiQueue      (std::make_shared<MpscQueue<MidiEvent>>(conf::midiQueueSize))
+#endif
 {
 	buffer.alloc(bufferSize, G_MAX_IO_CHANS);
+	bufferOut.alloc(bufferSize, G_MAX_IO_CHANS);
 
 #ifdef WITH_VST
 
 	midiBuffer.ensureSize(bufferSize);
+	pluginBuffer.setSize(G_MAX_IO_CHANS, bufferSize);
+	pluginParamChanges.reserve(G_MAX_PARAM_CHANGES);
 
 #endif
 }
@@ -109,6 +118,8 @@ Channel::Channel(const Channel& o)
   solo           (o.solo),
   volume_i       (o.volume_i.load()),
   volume_d       (o.volume_d),
+  volumeEnvelope (o.volumeEnvelope),
+  volumeEnvelopeFrame(o.volumeEnvelopeFrame),
   hasActions     (o.hasActions),
   readActions    (o.readActions),
   midiIn         (o.midiIn.load()),
@@ -125,10 +136,20 @@ Channel::Channel(const Channel& o)
   midiOutLmute   (o.midiOutLmute.load()),
   midiOutLsolo   (o.midiOutLsolo.load())
 #ifdef WITH_VST
- ,pluginIds      (o.pluginIds)
+ ,pluginIds      (o.pluginIds),
+  midiQueue      (o.midiQueue)
 #endif
 {
 	buffer.alloc(o.buffer.countFrames(), G_MAX_IO_CHANS);
+	bufferOut.alloc(o.buffer.countFrames(), G_MAX_IO_CHANS);
+
+#ifdef WITH_VST
+
+	pluginBuffer.setSize(G_MAX_IO_CHANS, o.buffer.countFrames());
+	pluginParamChanges.reserve(G_MAX_PARAM_CHANGES);
+	pluginParamChanges = o.pluginParamChanges;
+
+#endif
 }
 
 
@@ -151,6 +172,8 @@ Channel::Channel(const patch::Channel& p, int bufferSize)
   solo           (p.solo),
   volume_i       (1.0),
   volume_d       (0.0),
+  volumeEnvelope (bufferSize, 1.0f),
+  volumeEnvelopeFrame(0),
   hasActions     (p.hasActions),
   readActions    (p.readActions),
   midiIn         (p.midiIn),
@@ -167,10 +190,19 @@ Channel::Channel(const patch::Channel& p, int bufferSize)
   midiOutLmute   (p.midiOutLmute),
   midiOutLsolo   (p.midiOutLsolo)
 #ifdef WITH_VST
- ,pluginIds      (p.pluginIds)
+ ,pluginIds      (p.pluginIds),
+  midiQueue      (std::make_shared<MpscQueue<MidiEvent>>(conf::midiQueueSize))
 #endif
 {
 	buffer.alloc(bufferSize, G_MAX_IO_CHANS);
+	bufferOut.alloc(bufferSize, G_MAX_IO_CHANS);
+
+#ifdef WITH_VST
+
+	pluginBuffer.setSize(G_MAX_IO_CHANS, bufferSize);
+	pluginParamChanges.reserve(G_MAX_PARAM_CHANGES);
+
+#endif
 }
 
 
@@ -287,14 +319,27 @@ float Channel::calcPanning(int ch) const
 /* -------------------------------------------------------------------------- */
 
 
-void Channel::calcVolumeEnvelope()
+void Channel::renderVolumeEnvelope(Frame to)
 {
-	volume_i = volume_i + volume_d;
-	if (volume_i < 0.0f)
-		volume_i = 0.0f;
-	else
-	if (volume_i > 1.0f)
-		volume_i = 1.0f;	
+	assert(to <= static_cast<Frame>(volumeEnvelope.size()));
+
+	/* Each value is computed from the segment start rather than accumulated
+	frame by frame: no loop-carried dependency, the compiler can vectorize 
+	it. Segments are straight lines, so clamping each value gives the same 
+	result as clamping the running sum. */
+
+	const Frame  from  = volumeEnvelopeFrame;
+	const double start = volume_i.load();
+	const double delta = volume_d;
+
+	if (to <= from)
+		return;
+
+	for (Frame i = from; i < to; i++)
+		volumeEnvelope[i] = u::math::bound(start + delta * (i - from + 1), 0.0, 1.0);
+
+	volume_i.store(u::math::bound(start + delta * (to - from), 0.0, 1.0));
+	volumeEnvelopeFrame = to;
 }
 
 
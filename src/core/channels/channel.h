@@ -29,6 +29,7 @@
 #define G_CHANNEL_H
 
 
+#include <memory>
 #include <vector>
 #include <string>
 #include "core/types.h"
@@ -42,7 +43,7 @@
 #include "deps/juce-config.h"
 #include "core/plugin.h"
 #include "core/pluginHost.h"
-#include "core/queue.h"
+#include "core/mpscQueue.h"
 #endif
 
 
@@ -176,13 +177,24 @@ public:
 
 	void setPan(float v);
 
-	void calcVolumeEnvelope();
+	/* renderVolumeEnvelope
+	Fills volumeEnvelope up to frame 'to' (excluded), following the current 
+	envelope segment, i.e. volume_i and volume_d. */
+
+	void renderVolumeEnvelope(Frame to);
 
 	/* buffer
 	Working buffer for internal processing. */
 	
 	AudioBuffer buffer;
 
+	/* bufferOut
+	Final output of the channel, summed into the main output by the Mixer once
+	all channels have been rendered. Each channel owns one, so that channels can
+	be rendered in parallel. */
+
+	AudioBuffer bufferOut;
+
 	ChannelType   type;
 	ChannelStatus playStatus;
 	ChannelStatus recStatus;
@@ -210,6 +222,14 @@ public:
 	
 	std::atomic<double> volume_i;
 	double volume_d;
+
+	/* volumeEnvelope, volumeEnvelopeFrame
+	Per-buffer gain ramp built from volume envelope actions, and the frame it 
+	has been filled up to so far. Envelope actions close the current segment
+	as they are parsed; the rest is filled right before rendering. */
+
+	std::vector<float> volumeEnvelope;
+	Frame              volumeEnvelopeFrame;
 	
 	bool hasActions;  // If has some actions recorded
 	bool readActions; // If should read recorded actions
@@ -250,12 +270,27 @@ public:
 	
 	juce::MidiBuffer midiBuffer;
 
+	/* pluginBuffer
+	Working buffer for the plug-in stack. Per-channel for the same reason as
+	bufferOut above. */
+
+	juce::AudioBuffer<float> pluginBuffer;
+
+	/* pluginParamChanges
+	Plug-in parameter changes from recorded actions, due in the current buffer
+	and sorted by frame. Capacity is fixed to G_MAX_PARAM_CHANGES: changes 
+	beyond that are ignored. */
+
+	std::vector<pluginHost::ParamChange> pluginParamChanges;
+
 	/* midiQueue
-	FIFO queue for collecting MIDI events from the MIDI thread and passing them
-	to the audio thread. */
-	/* TODO - magic number */
+	FIFO queue for collecting MIDI events from the MIDI thread and the 
+	sequencer and passing them to the audio thread. Sized by 
+	conf::midiQueueSize; events that don't fit are counted as dropped. Shared 
+	by all copies of the Channel, so that no event is lost when the model gets
+	swapped. */
 
-	Queue<MidiEvent, 32> midiQueue;
+	std::shared_ptr<MpscQueue<MidiEvent>> midiQueue;
 
 #endif
 
@@ -32,6 +32,7 @@
 #include "core/channels/masterChannel.h"
 #include "core/channels/channel.h"
 #include "core/const.h"
+#include "core/conf.h"
 #include "core/patch.h"
 #include "core/mixer.h"
 #include "core/idManager.h"
@@ -112,6 +113,15 @@ std::unique_ptr<Channel> create(const Channel& o)
 	if (o.type != ChannelType::MASTER)
 		ch->id = channelId_.get();
 
+#ifdef WITH_VST
+
+	/* The copy constructor shares the MIDI queue, meant for copies of the same
+	channel: a new channel needs its own. */
+
+	ch->midiQueue = std::make_shared<MpscQueue<MidiEvent>>(conf::midiQueueSize);
+
+#endif
+
 	return ch;
 }
 
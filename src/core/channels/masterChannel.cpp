@@ -77,10 +77,10 @@ void MasterChannel::render(AudioBuffer& out, const AudioBuffer& in,
 	if (pluginIds.size() == 0)
 		return;
 	if (id == mixer::MASTER_OUT_CHANNEL_ID)
-		pluginHost::processStack(out, pluginIds);
+		pluginHost::processStack(out, pluginIds, pluginBuffer);
 	else
 	if (id == mixer::MASTER_IN_CHANNEL_ID)
-		pluginHost::processStack(inToOut, pluginIds);
+		pluginHost::processStack(inToOut, pluginIds, pluginBuffer);
 #endif
 }
 
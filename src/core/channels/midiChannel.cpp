@@ -25,6 +25,7 @@
  * -------------------------------------------------------------------------- */
 
 
+#include <algorithm>
 #include <cassert>
 #include "utils/log.h"
 #include "core/channels/midiChannelProc.h"
@@ -170,21 +171,38 @@ void MidiChannel::empty()
 
 
 void MidiChannel::sendMidi(const MidiEvent& e, int localFrame)
+{
+	sendMidi(&e, 1, localFrame);
+}
+
+
+void MidiChannel::sendMidi(const MidiEvent* events, size_t count, int localFrame)
 {
 	if (midiOut) {
-		MidiEvent e_ = e;
-		e_.setChannel(midiOutChan);
-		kernelMidi::send(e_.getRaw());
+		profiler::Time t = mixer::getOutputTime(localFrame);
+		for (size_t i = 0; i < count; i++) {
+			MidiEvent e_ = events[i];
+			e_.setChannel(midiOutChan);
+			kernelMidi::send(e_.getRaw(), t);
+		}
 	}
 
 #ifdef WITH_VST
 
-	/* Enqueue this MIDI event for plug-ins processing. Will be read and
-	rendered later on by the audio thread. */
-
-	MidiEvent e_ = e;
-	e_.setDelta(localFrame);
-	midiQueue.push(e_);
+	/* Enqueue these MIDI events for plug-ins processing, all at once. Will be 
+	read and rendered later on by the audio thread. */
+
+	MidiEvent batch[G_MIDI_BATCH_SIZE];
+	while (count > 0) {
+		size_t n = std::min(count, static_cast<size_t>(G_MIDI_BATCH_SIZE));
+		for (size_t i = 0; i < n; i++) {
+			batch[i] = events[i];
+			batch[i].setDelta(localFrame);
+		}
+		midiQueue->push(batch, n);
+		events += n;
+		count  -= n;
+	}
 
 #endif
 }
@@ -213,7 +231,7 @@ void MidiChannel::receiveMidi(const MidiEvent& midiEvent)
 	/* Enqueue this MIDI event for plug-ins processing. Will be read and
 	rendered later on by the audio thread. */
 
-	midiQueue.push(midiEventFlat);
+	midiQueue->push(midiEventFlat);
 
 #endif
 
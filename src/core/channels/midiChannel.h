@@ -61,9 +61,11 @@ public:
 	void receiveMidi(const MidiEvent& midiEvent) override;
 
 	/* sendMidi
-	Sends Midi event to the outside world. */
+	Sends Midi event to the outside world. The second version sends 'count' 
+	events at once, all happening on frame 'localFrame'. */
 
 	void sendMidi(const MidiEvent& e, int localFrame);
+	void sendMidi(const MidiEvent* events, size_t count, int localFrame);
 	
 	bool midiOut;      // enable midi output
 	int  midiOutChan;  // midi output channel
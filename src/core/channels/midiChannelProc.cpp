@@ -31,6 +31,7 @@
 #include "core/pluginHost.h"
 #include "core/kernelMidi.h"
 #include "core/const.h"
+#include "core/dsp.h"
 #include "core/action.h"
 #include "core/mixerHandler.h"
 #include "midiChannelProc.h"
@@ -77,10 +78,25 @@ void parseEvents(MidiChannel* ch, mixer::FrameEvents fe)
 {
 	if (fe.onFirstBeat)
 		onFirstBeat_(ch);
-	if (fe.actions != nullptr)
-		for (const Action& action : *fe.actions)
-			if (action.channelId == ch->id && ch->isPlaying() && !ch->mute)
-				ch->sendMidi(action.event, fe.frameLocal);
+	if (!ch->isPlaying() || ch->mute)
+		return;
+
+	/* Collect the events of this channel and send them in batches. */
+
+	MidiEvent events[G_MIDI_BATCH_SIZE];
+	size_t    count = 0;
+
+	for (const Action& action : fe.actions) {
+		if (action.channelId != ch->id)
+			continue;
+		events[count++] = action.event;
+		if (count == G_MIDI_BATCH_SIZE) {
+			ch->sendMidi(events, count, fe.frameLocal);
+			count = 0;
+		}
+	}
+	if (count > 0)
+		ch->sendMidi(events, count, fe.frameLocal);
 }
 
 
@@ -97,15 +113,19 @@ void process(MidiChannel* ch, AudioBuffer& out, const AudioBuffer& in, bool audi
 	filled by the MIDI thread. This is for live events, e.g. piano keyboards,
 	controllers, ... */
 
-	MidiEvent e;
-	while (ch->midiQueue.pop(e)) {
-		juce::MidiMessage message = juce::MidiMessage(
-			e.getStatus(), 
-			e.getNote(), 
-			e.getVelocity());
-		ch->midiBuffer.addEvent(message, e.getDelta());
+	MidiEvent events[G_MIDI_BATCH_SIZE];
+	size_t    count;
+	while ((count = ch->midiQueue->pop(events, G_MIDI_BATCH_SIZE)) > 0) {
+		for (size_t i = 0; i < count; i++) {
+			const MidiEvent& e = events[i];
+			juce::MidiMessage message = juce::MidiMessage(
+				e.getStatus(), 
+				e.getNote(), 
+				e.getVelocity());
+			ch->midiBuffer.addEvent(message, e.getDelta());
+		}
 	}
-	pluginHost::processStack(ch->buffer, ch->pluginIds, &ch->midiBuffer);
+	pluginHost::processStack(ch->buffer, ch->pluginIds, ch->pluginBuffer, &ch->midiBuffer);
 	
 	/* Process the plugin stack first, then quit if the channel is muted/soloed. 
 	This way there's no risk of cutting midi event pairs such as note-on and 
@@ -114,9 +134,7 @@ void process(MidiChannel* ch, AudioBuffer& out, const AudioBuffer& in, bool audi
 	if (!audible)
 		return;
 
-	for (int i=0; i<out.countFrames(); i++)
-		for (int j=0; j<out.countChannels(); j++)
-			out[i][j] += ch->buffer[i][j] * ch->volume;	
+	dsp::addGain(out[0], ch->buffer[0], out.countSamples(), ch->volume);
 
 #endif
 }
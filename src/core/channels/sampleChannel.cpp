@@ -25,7 +25,9 @@
  * -------------------------------------------------------------------------- */
 
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include "utils/log.h"
 #include "core/const.h"
 #include "core/wave.h"
@@ -39,6 +41,23 @@
 namespace giada {
 namespace m 
 {
+namespace
+{
+/* getReadWindowSize_
+Frames needed to resample a whole buffer at max pitch, plus filter taps. */
+
+Frame getReadWindowSize_(int bufferSize)
+{
+	return bufferSize * static_cast<Frame>(G_MAX_PITCH) + Resampler::MARGIN * 2 + 1;
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
 SampleChannel::SampleChannel(bool inputMonitor, int bufferSize,
 	ID columnId, ID id)
 : Channel          (ChannelType::SAMPLE, ChannelStatus::EMPTY, bufferSize,
@@ -59,13 +78,10 @@ SampleChannel::SampleChannel(bool inputMonitor, int bufferSize,
   midiInPitch      (0x0),
   bufferOffset     (0),
   rewinding        (false),
-  rsmp_state       (src_new(SRC_LINEAR, G_MAX_IO_CHANS, nullptr))
+  resampler        (ResamplerQuality::LINEAR)
 {
-	if (rsmp_state == nullptr) {
-		u::log::print("[SampleChannel] unable to alloc memory for SRC_STATE!\n");
-		throw std::bad_alloc();
-	}
 	bufferPreview.alloc(bufferSize, G_MAX_IO_CHANS);
+	readWindow.alloc(getReadWindowSize_(bufferSize), G_MAX_IO_CHANS);
 }
 
 
@@ -90,14 +106,10 @@ SampleChannel::SampleChannel(const SampleChannel& o)
   midiInPitch      (o.midiInPitch.load()),
   bufferOffset     (o.bufferOffset),
   rewinding        (o.rewinding),
-  rsmp_state       (src_new(SRC_LINEAR, G_MAX_IO_CHANS, nullptr))
+  resampler        (o.resampler)
 {
-	if (rsmp_state == nullptr) {
-		u::log::print("[SampleChannel] unable to alloc memory for SRC_STATE!\n");
-		throw std::bad_alloc();
-	}
-	
 	bufferPreview.alloc(o.bufferPreview.countFrames(), G_MAX_IO_CHANS);
+	readWindow.alloc(o.readWindow.countFrames(), G_MAX_IO_CHANS);
 }
 
 
@@ -122,14 +134,10 @@ SampleChannel::SampleChannel(const patch::Channel& p, int bufferSize)
   midiInPitch      (p.midiInPitch),
   bufferOffset     (0),
   rewinding        (0),
-  rsmp_state       (src_new(SRC_LINEAR, G_MAX_IO_CHANS, nullptr))
+  resampler        (p.resampler)
 {
-	if (rsmp_state == nullptr) {
-		u::log::print("[SampleChannel] unable to alloc memory for SRC_STATE!\n");
-		throw std::bad_alloc();
-	}
-	
 	bufferPreview.alloc(bufferSize, G_MAX_IO_CHANS);
+	readWindow.alloc(getReadWindowSize_(bufferSize), G_MAX_IO_CHANS);
 }
 
 
@@ -145,16 +153,6 @@ SampleChannel* SampleChannel::clone() const
 /* -------------------------------------------------------------------------- */
 
 
-SampleChannel::~SampleChannel()
-{
-	if (rsmp_state != nullptr)
-		src_delete(rsmp_state);
-}
-
-
-/* -------------------------------------------------------------------------- */
-
-
 void SampleChannel::parseEvents(mixer::FrameEvents fe)
 {
 	sampleChannelProc::parseEvents(this, fe);
@@ -383,11 +381,6 @@ void SampleChannel::setPitch(float v)
 		pitch = G_MIN_PITCH;
 	else 
 		pitch = v;
-
-// ???? 	/* if status is off don't slide between frequencies */
-// ???? 
-// ???? 	if (status & (STATUS_OFF | STATUS_WAIT))
-// ???? 		src_set_ratio(rsmp_state, 1/pitch);
 }
 
 
@@ -493,17 +486,26 @@ int SampleChannel::fillBufferResampled(AudioBuffer& dest, int start, int offset)
 {
 	model::WavesLock lock(model::waves);
 	const Wave& wave = model::get(model::waves, waveId);
-	
-	rsmp_data.data_in       = wave.getFrame(start);        // Source data
-	rsmp_data.input_frames  = end - start;                  // How many readable frames
-	rsmp_data.data_out      = dest[offset];                 // Destination (processed data)
-	rsmp_data.output_frames = dest.countFrames() - offset;  // How many frames to process
-	rsmp_data.end_of_input  = false;
-	rsmp_data.src_ratio     = 1 / pitch;
 
-	src_process(rsmp_state, &rsmp_data);
+	Frame outFrames = dest.countFrames() - offset;
+
+	/* Portion of data the resampler is going to work on, filter taps included.
+	Use it in place if contiguous in memory, otherwise read it first: it spans 
+	two blocks or comes from the disk stream. Streamed Waves are always read, as
+	Wave::read() also keeps the stream cued while playing the preloaded part. */
+
+	Frame first = std::max(0, start - Resampler::MARGIN);
+	Frame last  = std::min(wave.getSize(), 
+		start + static_cast<Frame>(std::ceil(outFrames * pitch)) + Resampler::MARGIN);
+
+	const float* data = wave.isStreamed() ? nullptr : wave.getData(first, last - first);
+	if (data == nullptr) {
+		wave.read(first, last - first, readWindow[0]);
+		data = readWindow[0];
+	}
 
-	return rsmp_data.input_frames_used; // Returns used frames
+	return resampler.process(data, last - first, start, end, 
+		dest[offset], outFrames, pitch, first);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -518,7 +520,7 @@ int SampleChannel::fillBufferCopy(AudioBuffer& dest, int start, int offset)
 	if (used > wave.getSize() - start)
 		used = wave.getSize() - start;
 
-	dest.copyData(wave.getFrame(start), used, offset);
+	wave.read(start, used, dest[offset]);
 
 	return used;
 }
@@ -31,8 +31,8 @@
 
 #include <memory>
 #include <functional>
-#include <samplerate.h>
 #include "core/types.h"
+#include "core/resampler.h"
 #include "core/channels/channel.h"
 
 
@@ -48,7 +48,6 @@ public:
 	SampleChannel(bool inputMonitor, int bufferSize, ID columnId, ID id);
 	SampleChannel(const SampleChannel& o);
 	SampleChannel(const patch::Channel& p, int bufferSize);
-	~SampleChannel();
 
 	SampleChannel* clone() const override;
 	void parseEvents(mixer::FrameEvents fe) override;
@@ -157,13 +156,18 @@ public:
 
 	bool rewinding;	
 
+	/* resampler
+	Pitch shifter used when pitch != 1.0f. Quality is selectable per channel. */
+
+	Resampler resampler;
+
 private:
 
-	/* rsmp_state, rsmp_data
-	Structs from libsamplerate. */
+	/* readWindow
+	Data read from a Wave before resampling it, when not contiguous in memory.
+	See fillBufferResampled(). */
 
-	SRC_STATE* rsmp_state;
-	SRC_DATA   rsmp_data;
+	AudioBuffer readWindow;
 
 	int fillBufferResampled(AudioBuffer& dest, int start, int offset);
 	int fillBufferCopy     (AudioBuffer& dest, int start, int offset);
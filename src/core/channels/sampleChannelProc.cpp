@@ -30,6 +30,7 @@
 #include "core/model/model.h"
 #include "core/channels/sampleChannel.h"
 #include "core/const.h"
+#include "core/dsp.h"
 #include "core/pluginHost.h"
 #include "core/mixerHandler.h"
 #include "sampleChannelProc.h"
@@ -194,23 +195,38 @@ void processIO_(SampleChannel* ch, m::AudioBuffer& out, const m::AudioBuffer& in
 	pluginHost::processStack, so that you would record "clean" audio 
 	(i.e. not plugin-processed). */
 
-	if (ch->armed && in.isAllocd() && ch->inputMonitor) {
-		for (int i=0; i<ch->buffer.countFrames(); i++)
-			for (int j=0; j<ch->buffer.countChannels(); j++)
-				ch->buffer[i][j] += in[i][j];   // add, don't overwrite
-	}
+	if (ch->armed && in.isAllocd() && ch->inputMonitor)
+		dsp::addGain(ch->buffer[0], in[0], ch->buffer.countSamples(), 1.0f); // add, don't overwrite
 
 #ifdef WITH_VST
-	pluginHost::processStack(ch->buffer, ch->pluginIds);
+	pluginHost::processStack(ch->buffer, ch->pluginIds, ch->pluginBuffer, 
+		nullptr, &ch->pluginParamChanges);
 #endif
 
-	for (int i=0; i<out.countFrames(); i++) {
-		if (running)
-			ch->calcVolumeEnvelope();
-		if (!ch->mute)
-			for (int j=0; j<out.countChannels(); j++)
-				out[i][j] += ch->buffer[i][j] * ch->volume * ch->volume_i * ch->calcPanning(j);	
+	assert(out.countChannels() == G_MAX_IO_CHANS);
+
+	float panL = ch->calcPanning(0);
+	float panR = ch->calcPanning(1);
+
+	/* No volume envelope to follow: the gain is constant for the whole 
+	buffer. */
+
+	if (!running || (ch->volume_d == 0.0 && ch->volumeEnvelopeFrame == 0)) {
+		if (!ch->mute) {
+			float gain = ch->volume * ch->volume_i.load();
+			dsp::addPanGain(out[0], ch->buffer[0], out.countFrames(), gain * panL, 
+				gain * panR);
+		}
+		return;
 	}
+
+	/* Complete the envelope ramp started by envelope actions (if any), then 
+	apply it in one go. The envelope moves on even if the channel is muted. */
+
+	ch->renderVolumeEnvelope(out.countFrames());
+	if (!ch->mute)
+		dsp::addPanGainRamp(out[0], ch->buffer[0], ch->volumeEnvelope.data(), 
+			out.countFrames(), ch->volume * panL, ch->volume * panR);
 }
 
 
@@ -240,9 +256,10 @@ void processPreview_(SampleChannel* ch, m::AudioBuffer& out)
 	else
 		ch->trackerPreview += ch->fillBuffer(ch->bufferPreview, ch->trackerPreview, 0);
 
-	for (int i=0; i<out.countFrames(); i++)
-		for (int j=0; j<out.countChannels(); j++)
-			out[i][j] += ch->bufferPreview[i][j] * ch->volume * ch->calcPanning(j);	
+	assert(out.countChannels() == G_MAX_IO_CHANS);
+
+	dsp::addPanGain(out[0], ch->bufferPreview[0], out.countFrames(), 
+		ch->volume * ch->calcPanning(0), ch->volume * ch->calcPanning(1));
 }
 
 
@@ -502,6 +519,13 @@ void render(SampleChannel* ch, AudioBuffer& out, const AudioBuffer& in,
 
 	if (ch->isPreview())
 		processPreview_(ch, out);
+
+	/* Envelope ramp and parameter changes belong to this buffer only. */
+
+	ch->volumeEnvelopeFrame = 0;
+#ifdef WITH_VST
+	ch->pluginParamChanges.clear();
+#endif
 }
 
 
@@ -88,17 +88,20 @@ bool recorderCanRec_(SampleChannel* ch)
 
 
 /* calcVolumeEnv
-Computes any changes in volume done via envelope tool. */
+Computes any changes in volume done via envelope tool. The envelope ramp is 
+filled up to 'localFrame' with the previous segment, the new one starts 
+there. */
 
-void calcVolumeEnv_(SampleChannel* ch, const Action& a1)
+void calcVolumeEnv_(SampleChannel* ch, const Action& a1, int localFrame)
 {
-	assert(a1.next != nullptr);
+	const Action a2 = recorder::getAction(a1.nextId);
 
-	const Action a2 = *a1.next;
+	assert(a2.isValid());
 
 	double vf1 = u::math::map<int, double>(a1.event.getVelocity(), 0, G_MAX_VELOCITY, 0, 1.0);
 	double vf2 = u::math::map<int, double>(a2.event.getVelocity(), 0, G_MAX_VELOCITY, 0, 1.0);
 
+	ch->renderVolumeEnvelope(localFrame);
 	ch->volume_i = vf1;
 	ch->volume_d = a2.frame == a1.frame ? 0 : (vf2 - vf1) / (a2.frame - a1.frame);
 }
@@ -107,6 +110,27 @@ void calcVolumeEnv_(SampleChannel* ch, const Action& a1)
 /* -------------------------------------------------------------------------- */
 
 
+#ifdef WITH_VST
+
+/* scheduleParamChange_
+Schedules a plug-in parameter change from an envelope action at 'localFrame' 
+of the current buffer. Actions are parsed in frame order, so the list stays 
+sorted. */
+
+void scheduleParamChange_(SampleChannel* ch, const Action& a, int localFrame)
+{
+	if (ch->pluginParamChanges.size() >= static_cast<size_t>(G_MAX_PARAM_CHANGES))
+		return;
+	float value = u::math::map<int, float>(a.event.getVelocity(), 0, G_MAX_VELOCITY, 0.0f, 1.0f);
+	ch->pluginParamChanges.push_back({ localFrame, a.pluginId, a.pluginParam, value });
+}
+
+#endif
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void parseAction_(SampleChannel* ch, const Action& a, int localFrame, int globalFrame)
 {
 	switch (a.event.getStatus()) {
@@ -123,7 +147,12 @@ void parseAction_(SampleChannel* ch, const Action& a, int localFrame, int global
 				ch->kill(localFrame);
 			break;
 		case MidiEvent::ENVELOPE:
-			calcVolumeEnv_(ch, a);
+			if (a.isVolumeEnvelope())
+				calcVolumeEnv_(ch, a, localFrame);
+#ifdef WITH_VST
+			else
+				scheduleParamChange_(ch, a, localFrame);
+#endif
 			break;
 	}
 }
@@ -176,8 +205,8 @@ void parseEvents(SampleChannel* ch, mixer::FrameEvents fe)
 	quantize_(ch, fe.quantoPassed);
 	if (fe.onFirstBeat)
 		onFirstBeat_(ch, conf::recsStopOnChanHalt);
-	if (ch->readActions && fe.actions != nullptr)
-		for (const Action& action : *fe.actions)
+	if (ch->readActions)
+		for (const Action& action : fe.actions)
 			if (action.channelId == ch->id)
 				parseAction_(ch, action, fe.frameLocal, fe.frameGlobal);
 }
@@ -25,8 +25,10 @@
  * -------------------------------------------------------------------------- */
 
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <limits>
 #include "glue/main.h"
 #include "utils/math.h"
 #include "core/model/model.h"
@@ -77,6 +79,20 @@ void updateFrameBars_(model::Clock& c)
 	if (c.quantize != 0)
 		quanto_ = c.framesInBeat / c.quantize;
 }
+
+
+/* -------------------------------------------------------------------------- */
+
+/* framesToBoundary_
+Returns how many frames are left from frame 'f' to the next multiple of 'step'.
+A frame already on a boundary is one full step away from the next one. */
+
+Frame framesToBoundary_(Frame f, Frame step)
+{
+	if (step <= 0)
+		return std::numeric_limits<Frame>::max();
+	return step - (f % step);
+}
 }; // {anonymous}
 
 
@@ -230,36 +246,86 @@ void setStatus(ClockStatus s)
 /* -------------------------------------------------------------------------- */
 
 
-void incrCurrentFrame() 
+void advance(Frame frames) 
 {
 	model::ClockLock lock(model::clock);
 	
 	const model::Clock* c = model::clock.get();
 
 	if (c->status == ClockStatus::WAITING) {
-		int f = currentFrameWait_.load() + 1;
+		int f = currentFrameWait_.load() + frames;
 		if (f >= c->framesInLoop)
-				f = 0;
+			f = 0;
 		currentFrameWait_.store(f);
 		return;
 	}
 
-	int f = currentFrame_.load() + 1;
+	int f = currentFrame_.load();
 	int b = currentBeat_.load();
 
-	if (f >= c->framesInLoop) {
+	/* 'frames' comes from getFramesToNextEvent(), computed on a previous clock
+	snapshot: a bpm or beats change in the meantime might have shortened the
+	loop. Never go past its end, wrap around instead. */
+
+	frames = std::min(frames, std::max(0, c->framesInLoop - f));
+
+	if (f + frames >= c->framesInLoop) {
 		f = 0;
 		b = 0;
 	}
-	else
-	if (f % c->framesInBeat == 0) // If is on beat
-		b++;
+	else {
+		b += ((f + frames) / c->framesInBeat) - (f / c->framesInBeat); // Beats crossed
+		f += frames;
+	}
 	
 	currentFrame_.store(f);
 	currentBeat_.store(b);
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+
+Frame getFramesToNextEvent(Frame max)
+{
+	model::ClockLock lock(model::clock);
+	
+	const model::Clock* c = model::clock.get();
+
+	/* While waiting only beats are meaningful (for the metronome). */
+
+	if (c->status == ClockStatus::WAITING) {
+		int f = currentFrameWait_.load();
+		return std::min({ max, 
+			framesToBoundary_(f, c->framesInBeat), 
+			std::max(1, c->framesInLoop - f) });
+	}
+
+	int   f    = currentFrame_.load();
+	Frame next = std::min({ max, 
+		framesToBoundary_(f, c->framesInBar), 
+		framesToBoundary_(f, c->framesInBeat), 
+		std::max(1, c->framesInLoop - f) });
+
+	/* Quantizer steps are events only if the quantizer is enabled: nothing can
+	be waiting for a quantizer step otherwise. */
+
+	if (c->quantize != 0)
+		next = std::min(next, framesToBoundary_(f, quanto_));
+
+	if (conf::midiSync == MIDI_SYNC_CLOCK_M)
+		next = std::min(next, framesToBoundary_(f, c->framesInBeat / 24));
+	else
+	if (conf::midiSync == MIDI_SYNC_MTC_M)
+		next = std::min(next, framesToBoundary_(f, midiTCrate_));
+
+	return next;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void rewind()
 {
 	currentFrame_.store(0);
@@ -273,7 +339,7 @@ void rewind()
 /* -------------------------------------------------------------------------- */
 
 
-void sendMIDIsync()
+void sendMIDIsync(profiler::Time t)
 {
 	model::ClockLock lock(model::clock);
 	
@@ -290,7 +356,7 @@ void sendMIDIsync()
 
 	if (conf::midiSync == MIDI_SYNC_CLOCK_M) {
 		if (currentFrame % (c->framesInBeat / 24) == 0)
-			kernelMidi::send(MIDI_CLOCK, -1, -1);
+			kernelMidi::send(MIDI_CLOCK, -1, -1, t);
 		return;
 	}
 
@@ -310,10 +376,10 @@ void sendMIDIsync()
 		 * seconds high nibble */
 
 		if (midiTCframes_ % 2 == 0) {
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCframes_ & 0x0F)  | 0x00, -1);
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCframes_ >> 4)    | 0x10, -1);
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCseconds_ & 0x0F) | 0x20, -1);
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCseconds_ >> 4)   | 0x30, -1);
+			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCframes_ & 0x0F)  | 0x00, -1, t);
+			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCframes_ >> 4)    | 0x10, -1, t);
+			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCseconds_ & 0x0F) | 0x20, -1, t);
+			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCseconds_ >> 4)   | 0x30, -1, t);
 		}
 
 		/* minutes low nibble
@@ -322,10 +388,10 @@ void sendMIDIsync()
 		 * hours high nibble SMPTE frame rate */
 
 		else {
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCminutes_ & 0x0F) | 0x40, -1);
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCminutes_ >> 4)   | 0x50, -1);
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTChours_ & 0x0F)   | 0x60, -1);
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTChours_ >> 4)     | 0x70, -1);
+			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCminutes_ & 0x0F) | 0x40, -1, t);
+			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCminutes_ >> 4)   | 0x50, -1, t);
+			kernelMidi::send(MIDI_MTC_QUARTER, (midiTChours_ & 0x0F)   | 0x60, -1, t);
+			kernelMidi::send(MIDI_MTC_QUARTER, (midiTChours_ >> 4)     | 0x70, -1, t);
 		}
 
 		midiTCframes_++;
@@ -29,6 +29,7 @@
 #define G_CLOCK_H
 
 
+#include "profiler.h"
 #include "types.h"
 
 
@@ -39,9 +40,10 @@ namespace clock
 void init(int sampleRate, float midiTCfps);
 
 /* sendMIDIsync
-Generates MIDI sync output data. */
+Generates MIDI sync output data, to be sent at time 't' (see 
+kernelMidi::send). */
 
-void sendMIDIsync();
+void sendMIDIsync(profiler::Time t);
 
 /* sendMIDIrewind
 Rewinds timecode to beat 0 and also send a MTC full frame to cue the slave. */
@@ -65,10 +67,20 @@ int getQuantize();
 int getQuanto();
 ClockStatus getStatus();
 
-/* incrCurrentFrame
-Increases current frame of a single step (+1). */
+/* advance
+Moves the current frame forward by 'frames' steps. Same as increasing it one 
+frame at a time, without the per-frame overhead. 'frames' must not go past the 
+end of the loop: use getFramesToNextEvent() to compute a safe value. */
 
-void incrCurrentFrame();
+void advance(Frame frames);
+
+/* getFramesToNextEvent
+Returns how many frames are left before the next clock event (bar, beat, 
+quantizer step, end of loop or MIDI sync tick) starting from the current frame, 
+up to 'max'. The current frame is not taken into account: the result is always 
+greater than zero. */
+
+Frame getFramesToNextEvent(Frame max);
 
 /* quantoHasPassed
 Tells whether a quanto unit has passed yet. */
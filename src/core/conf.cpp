@@ -103,6 +103,12 @@ void sanitize()
 	if (aboutY < 0) aboutY = 0;
 	if (samplerate < 8000) samplerate = G_DEFAULT_SAMPLERATE;
 	if (rsmpQuality < 0 || rsmpQuality > 4) rsmpQuality = 0;
+	if (renderThreads < 0 || renderThreads > G_MAX_RENDER_THREADS) renderThreads = 0;
+	if (streamThreshold < 0) streamThreshold = 0;
+	if (streamPreload < 1) streamPreload = G_DEFAULT_STREAM_PRELOAD;
+	if (loadThreads < 0) loadThreads = 0;
+	if (midiQueueSize < G_MIN_MIDI_QUEUE_SIZE || midiQueueSize > G_MAX_MIDI_QUEUE_SIZE) 
+		midiQueueSize = G_DEFAULT_MIDI_QUEUE_SIZE;
 }
 
 
@@ -158,10 +164,16 @@ int  samplerate     = G_DEFAULT_SAMPLERATE;
 int  buffersize     = G_DEFAULT_BUFSIZE;
 bool limitOutput    = false;
 int  rsmpQuality    = 0;
+int  renderThreads  = 0;
+int  streamThreshold = G_DEFAULT_STREAM_THRESHOLD;
+int  streamPreload   = G_DEFAULT_STREAM_PRELOAD;
+bool sampleCache     = true;
+int  loadThreads     = 0;
 
 int         midiSystem  = 0;
 int         midiPortOut = G_DEFAULT_MIDI_PORT_OUT;
 int         midiPortIn  = G_DEFAULT_MIDI_PORT_IN;
+int         midiQueueSize = G_DEFAULT_MIDI_QUEUE_SIZE;
 std::string midiMapPath = "";
 std::string lastFileMap = "";
 int         midiSync    = MIDI_SYNC_NONE;
@@ -321,9 +333,15 @@ bool read()
 	buffersize     = uj::readInt(j, CONF_KEY_BUFFER_SIZE);
 	limitOutput    = uj::readBool(j, CONF_KEY_LIMIT_OUTPUT);
 	rsmpQuality    = uj::readInt(j, CONF_KEY_RESAMPLE_QUALITY);
+	renderThreads  = uj::readInt(j, CONF_KEY_RENDER_THREADS);
+	streamThreshold = uj::readInt(j, CONF_KEY_STREAM_THRESHOLD, G_DEFAULT_STREAM_THRESHOLD);
+	streamPreload   = uj::readInt(j, CONF_KEY_STREAM_PRELOAD, G_DEFAULT_STREAM_PRELOAD);
+	sampleCache     = uj::readBool(j, CONF_KEY_SAMPLE_CACHE, true);
+	loadThreads     = uj::readInt(j, CONF_KEY_LOAD_THREADS);
 	midiSystem     = uj::readInt(j, CONF_KEY_MIDI_SYSTEM);
 	midiPortOut    = uj::readInt(j, CONF_KEY_MIDI_PORT_OUT);
 	midiPortIn     = uj::readInt(j, CONF_KEY_MIDI_PORT_IN);
+	midiQueueSize  = uj::readInt(j, CONF_KEY_MIDI_QUEUE_SIZE, G_DEFAULT_MIDI_QUEUE_SIZE);
 	midiMapPath    = uj::readString(j, CONF_KEY_MIDIMAP_PATH);
 	lastFileMap    = uj::readString(j, CONF_KEY_LAST_MIDIMAP);
 	midiSync       = uj::readInt(j, CONF_KEY_MIDI_SYNC);
@@ -433,9 +451,15 @@ bool write()
 	json_object_set_new(j, CONF_KEY_BUFFER_SIZE,               json_integer(buffersize));
 	json_object_set_new(j, CONF_KEY_LIMIT_OUTPUT,              json_boolean(limitOutput));
 	json_object_set_new(j, CONF_KEY_RESAMPLE_QUALITY,          json_integer(rsmpQuality));
+	json_object_set_new(j, CONF_KEY_RENDER_THREADS,            json_integer(renderThreads));
+	json_object_set_new(j, CONF_KEY_STREAM_THRESHOLD,          json_integer(streamThreshold));
+	json_object_set_new(j, CONF_KEY_STREAM_PRELOAD,            json_integer(streamPreload));
+	json_object_set_new(j, CONF_KEY_SAMPLE_CACHE,              json_boolean(sampleCache));
+	json_object_set_new(j, CONF_KEY_LOAD_THREADS,              json_integer(loadThreads));
 	json_object_set_new(j, CONF_KEY_MIDI_SYSTEM,               json_integer(midiSystem));
 	json_object_set_new(j, CONF_KEY_MIDI_PORT_OUT,             json_integer(midiPortOut));
 	json_object_set_new(j, CONF_KEY_MIDI_PORT_IN,              json_integer(midiPortIn));
+	json_object_set_new(j, CONF_KEY_MIDI_QUEUE_SIZE,           json_integer(midiQueueSize));
 	json_object_set_new(j, CONF_KEY_MIDIMAP_PATH,              json_string(midiMapPath.c_str()));
 	json_object_set_new(j, CONF_KEY_LAST_MIDIMAP,              json_string(lastFileMap.c_str()));
 	json_object_set_new(j, CONF_KEY_MIDI_SYNC,                 json_integer(midiSync));
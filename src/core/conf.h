@@ -59,10 +59,16 @@ extern int  samplerate;
 extern int  buffersize;
 extern bool limitOutput;
 extern int  rsmpQuality;
+extern int  renderThreads; // 0 = render channels on the audio thread only
+extern int  streamThreshold; // MB of audio data above which Waves are streamed, 0 = never
+extern int  streamPreload;   // Seconds of a streamed Wave kept in memory
+extern bool sampleCache;     // Keep decoded samples in an on-disk cache
+extern int  loadThreads;     // Threads loading or saving samples, 0 = one per core
 
 extern int  midiSystem;
 extern int  midiPortOut;
 extern int  midiPortIn;
+extern int  midiQueueSize; // Incoming MIDI events a channel can hold per buffer
 extern std::string midiMapPath;
 extern std::string lastFileMap;
 extern int   midiSync;  // see const.h
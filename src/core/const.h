@@ -114,6 +114,12 @@ constexpr int    G_MAX_IO_CHANS     = 2;
 constexpr int    G_MAX_VELOCITY     = 0x7F;
 constexpr int    G_MAX_MIDI_CHANS   = 16;
 constexpr int    G_MAX_POLYPHONY    = 32;
+constexpr int    G_MAX_RENDER_THREADS = 16;
+constexpr int    G_MIDI_OUT_QUEUE_SIZE = 1024;
+constexpr int    G_MIN_MIDI_QUEUE_SIZE = 16;
+constexpr int    G_MAX_MIDI_QUEUE_SIZE = 65536;
+constexpr int    G_MIDI_BATCH_SIZE     = 64;  // MIDI events moved at once
+constexpr int    G_MAX_PARAM_CHANGES   = 64;  // Plug-in parameter changes per buffer
 
 
 
@@ -152,6 +158,7 @@ constexpr int   G_DEFAULT_SOUNDDEV_IN       = -1;     // no recording by default
 constexpr int   G_DEFAULT_MIDI_SYSTEM       = 0;
 constexpr int   G_DEFAULT_MIDI_PORT_IN      = -1;
 constexpr int   G_DEFAULT_MIDI_PORT_OUT     = -1;
+constexpr int   G_DEFAULT_MIDI_QUEUE_SIZE   = 256;    // events per channel
 constexpr int   G_DEFAULT_SAMPLERATE        = 44100;
 constexpr int   G_DEFAULT_BUFSIZE           = 1024;
 constexpr int   G_DEFAULT_BIT_DEPTH         = 32;     // float
@@ -169,6 +176,11 @@ constexpr int   G_DEFAULT_MIDI_INPUT_UI_H   = 350;
 constexpr int   G_DEFAULT_ACTION_SIZE       = 8192;  // frames
 constexpr int   G_DEFAULT_ZOOM_RATIO        = 128;
 constexpr float G_DEFAULT_REC_TRIGGER_LEVEL = -10.0f;
+constexpr int   G_DEFAULT_STREAM_THRESHOLD  = 64;     // MB
+constexpr int   G_DEFAULT_STREAM_PRELOAD    = 2;      // seconds
+constexpr auto  G_SAMPLE_CACHE_DIR          = "cache";
+constexpr int   G_STREAM_BUFFER_SECONDS     = 4;      // disk stream ring buffer
+constexpr int   G_WAVE_BLOCK_SIZE           = 16384;  // frames
 
 
 
@@ -207,6 +219,7 @@ constexpr int WID_SAMPLE_NAME   = -11;
 constexpr int WID_FX_CHOOSER    = -12;
 constexpr int WID_MIDI_INPUT    = -13;
 constexpr int WID_MIDI_OUTPUT   = -14;
+constexpr int WID_DSP_LOAD      = -15;
 
 
 
@@ -313,6 +326,7 @@ constexpr auto PATCH_KEY_CHANNEL_END                  = "end";
 constexpr auto PATCH_KEY_CHANNEL_HAS_ACTIONS          = "has_actions";
 constexpr auto PATCH_KEY_CHANNEL_READ_ACTIONS         = "read_actions";
 constexpr auto PATCH_KEY_CHANNEL_PITCH                = "pitch";
+constexpr auto PATCH_KEY_CHANNEL_RESAMPLER            = "resampler";
 constexpr auto PATCH_KEY_CHANNEL_INPUT_MONITOR        = "input_monitor";
 constexpr auto PATCH_KEY_CHANNEL_MIDI_IN_READ_ACTIONS = "midi_in_read_actions";
 constexpr auto PATCH_KEY_CHANNEL_MIDI_IN_PITCH        = "midi_in_pitch";
@@ -358,9 +372,15 @@ constexpr auto CONF_KEY_BUFFER_SIZE              = "buffer_size";
 constexpr auto CONF_KEY_DELAY_COMPENSATION       = "delay_compensation";
 constexpr auto CONF_KEY_LIMIT_OUTPUT             = "limit_output";
 constexpr auto CONF_KEY_RESAMPLE_QUALITY         = "resample_quality";
+constexpr auto CONF_KEY_RENDER_THREADS           = "render_threads";
+constexpr auto CONF_KEY_STREAM_THRESHOLD         = "stream_threshold";
+constexpr auto CONF_KEY_STREAM_PRELOAD           = "stream_preload";
+constexpr auto CONF_KEY_SAMPLE_CACHE             = "sample_cache";
+constexpr auto CONF_KEY_LOAD_THREADS             = "load_threads";
 constexpr auto CONF_KEY_MIDI_SYSTEM              = "midi_system";
 constexpr auto CONF_KEY_MIDI_PORT_OUT            = "midi_port_out";
 constexpr auto CONF_KEY_MIDI_PORT_IN             = "midi_port_in";
+constexpr auto CONF_KEY_MIDI_QUEUE_SIZE          = "midi_queue_size";
 constexpr auto CONF_KEY_MIDIMAP_PATH             = "midimap_path";
 constexpr auto CONF_KEY_LAST_MIDIMAP             = "last_midimap";
 constexpr auto CONF_KEY_MIDI_SYNC                = "midi_sync";
@@ -0,0 +1,133 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "utils/log.h"
+#include "core/waveStream.h"
+#include "diskReader.h"
+
+
+namespace giada {
+namespace m {
+namespace diskReader
+{
+namespace
+{
+/* IDLE_WAIT
+How long the thread sleeps when all ring buffers are full. Must be much 
+shorter than the time a ring buffer takes to drain. */
+
+constexpr auto IDLE_WAIT = std::chrono::milliseconds(2);
+
+std::vector<WaveStream*> streams_;
+std::mutex               mutex_;
+std::condition_variable  cond_;
+std::thread              thread_;
+bool                     running_  = false;
+std::atomic<bool>        blocking_(false);
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void run_()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (running_) {
+		bool busy = false;
+		for (WaveStream* s : streams_)
+			busy |= s->fill();
+		if (!busy)
+			cond_.wait_for(lock, IDLE_WAIT);
+	}
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+void init()
+{
+	if (thread_.joinable())
+		return;
+	running_ = true;
+	thread_  = std::thread(run_);
+	u::log::print("[diskReader::init] disk reader thread started\n");
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void close()
+{
+	if (!thread_.joinable())
+		return;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		running_ = false;
+	}
+	cond_.notify_one();
+	thread_.join();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void add(WaveStream* s)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		streams_.push_back(s);
+	}
+	cond_.notify_one();
+}
+
+
+void remove(WaveStream* s)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	streams_.erase(std::remove(streams_.begin(), streams_.end(), s), streams_.end());
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void setBlocking(bool v) { blocking_.store(v); }
+bool isBlocking()        { return blocking_.load(); }
+}}} // giada::m::diskReader::
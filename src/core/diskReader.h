@@ -0,0 +1,65 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_DISK_READER_H
+#define G_DISK_READER_H
+
+
+namespace giada {
+namespace m 
+{
+class WaveStream;
+namespace diskReader
+{
+/* init
+Starts the disk reader thread, which keeps the ring buffers of all streamed 
+Waves filled. */
+
+void init();
+
+/* close
+Stops the disk reader thread. */
+
+void close();
+
+/* add, remove
+Registers/unregisters a stream. Called by WaveStream itself on construction 
+and destruction. */
+
+void add(WaveStream* s);
+void remove(WaveStream* s);
+
+/* setBlocking
+When blocking, streams read their data synchronously instead of playing 
+silence on underruns. Enable it while rendering faster than real time. */
+
+void setBlocking(bool v);
+bool isBlocking();
+}}} // giada::m::diskReader::
+
+
+#endif
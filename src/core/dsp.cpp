@@ -0,0 +1,594 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <algorithm>
+#include <cmath>
+#include "dsp.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#define G_DSP_X86
+	#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+	#define G_DSP_NEON
+	#include <arm_neon.h>
+#endif
+
+
+namespace giada {
+namespace m {
+namespace dsp
+{
+namespace
+{
+struct Kernels
+{
+	Isa   isa;
+	void  (*addGain)   (float*, const float*, int, float);
+	void  (*addPanGain)(float*, const float*, int, float, float);
+	void  (*addPanGainRamp)(float*, const float*, const float*, int, float, float);
+	void  (*copyGain)  (float*, const float*, int, float);
+	void  (*clamp)     (float*, int, float, float);
+	float (*peakAbs)   (const float*, int);
+	void  (*dotStereo) (const float*, const float*, int, float*);
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+/* mulAdd_
+Returns a + b * c. The AArch64 compiler contracts it into a fused multiply-add 
+anyway: make it explicit, so that the scalar and the NEON kernels always round
+the same way. */
+
+inline float mulAdd_(float a, float b, float c)
+{
+#if defined(__aarch64__)
+	return std::fma(b, c, a);
+#else
+	return a + b * c;
+#endif
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void addGainScalar_(float* dst, const float* src, int samples, float gain)
+{
+	for (int i=0; i<samples; i++)
+		dst[i] = mulAdd_(dst[i], src[i], gain);
+}
+
+
+void addPanGainScalar_(float* dst, const float* src, int frames, float gainL, 
+	float gainR)
+{
+	for (int i=0; i<frames * 2; i+=2) {
+		dst[i]   = mulAdd_(dst[i],   src[i],   gainL);
+		dst[i+1] = mulAdd_(dst[i+1], src[i+1], gainR);
+	}
+}
+
+
+/* addPanGainRampScalar_
+The per-frame gain is computed first (ramp * pan gain), then multiplied: the
+vector versions do the same, to stay bit-exact. */
+
+void addPanGainRampScalar_(float* dst, const float* src, const float* ramp, 
+	int frames, float gainL, float gainR)
+{
+	for (int i=0; i<frames; i++) {
+		dst[i*2]     = mulAdd_(dst[i*2],     src[i*2],     ramp[i] * gainL);
+		dst[i*2 + 1] = mulAdd_(dst[i*2 + 1], src[i*2 + 1], ramp[i] * gainR);
+	}
+}
+
+
+void copyGainScalar_(float* dst, const float* src, int samples, float gain)
+{
+	for (int i=0; i<samples; i++)
+		dst[i] = src[i] * gain;
+}
+
+
+void clampScalar_(float* buf, int samples, float min, float max)
+{
+	for (int i=0; i<samples; i++)
+		buf[i] = buf[i] < min ? min : buf[i] > max ? max : buf[i];
+}
+
+
+float peakAbsScalar_(const float* buf, int samples)
+{
+	float peak = 0.0f;
+	for (int i=0; i<samples; i++)
+		peak = std::max(peak, std::fabs(buf[i]));
+	return peak;
+}
+
+
+/* dotStereoScalar_
+Accumulates in four lanes, two frames at a time, exactly as the vector versions
+do: this keeps the results bit-exact across instruction sets. */
+
+void dotStereoScalar_(const float* src, const float* coeffs, int frames, 
+	float* out)
+{
+	float a[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	int i = 0;
+	for (; i + 2 <= frames; i+=2) {
+		a[0] = mulAdd_(a[0], src[i*2],     coeffs[i]);
+		a[1] = mulAdd_(a[1], src[i*2 + 1], coeffs[i]);
+		a[2] = mulAdd_(a[2], src[i*2 + 2], coeffs[i + 1]);
+		a[3] = mulAdd_(a[3], src[i*2 + 3], coeffs[i + 1]);
+	}
+	if (i < frames) {
+		a[0] = mulAdd_(a[0], src[i*2],     coeffs[i]);
+		a[1] = mulAdd_(a[1], src[i*2 + 1], coeffs[i]);
+	}
+	out[0] = a[0] + a[2];
+	out[1] = a[1] + a[3];
+}
+
+
+const Kernels scalar_ = { Isa::SCALAR, addGainScalar_, addPanGainScalar_, 
+	addPanGainRampScalar_, copyGainScalar_, clampScalar_, peakAbsScalar_, dotStereoScalar_ };
+
+
+/* -------------------------------------------------------------------------- */
+
+
+#if defined(G_DSP_X86)
+
+__attribute__((target("sse2")))
+void addGainSse2_(float* dst, const float* src, int samples, float gain)
+{
+	const __m128 g = _mm_set1_ps(gain);
+	int i = 0;
+	for (; i + 4 <= samples; i+=4) {
+		__m128 d = _mm_loadu_ps(dst + i);
+		__m128 s = _mm_loadu_ps(src + i);
+		_mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(s, g)));
+	}
+	addGainScalar_(dst + i, src + i, samples - i, gain);
+}
+
+
+__attribute__((target("sse2")))
+void addPanGainSse2_(float* dst, const float* src, int frames, float gainL, 
+	float gainR)
+{
+	const __m128 g = _mm_setr_ps(gainL, gainR, gainL, gainR);
+	int i = 0;
+	for (; i + 4 <= frames * 2; i+=4) {
+		__m128 d = _mm_loadu_ps(dst + i);
+		__m128 s = _mm_loadu_ps(src + i);
+		_mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(s, g)));
+	}
+	addPanGainScalar_(dst + i, src + i, frames - i / 2, gainL, gainR);
+}
+
+
+__attribute__((target("sse2")))
+void addPanGainRampSse2_(float* dst, const float* src, const float* ramp, 
+	int frames, float gainL, float gainR)
+{
+	const __m128 g = _mm_setr_ps(gainL, gainR, gainL, gainR);
+	int i = 0;
+	for (; i + 2 <= frames; i+=2) {
+		__m128 r = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(ramp + i)));
+		r = _mm_mul_ps(_mm_unpacklo_ps(r, r), g); // r0 r0 r1 r1
+		__m128 d = _mm_loadu_ps(dst + i*2);
+		__m128 s = _mm_loadu_ps(src + i*2);
+		_mm_storeu_ps(dst + i*2, _mm_add_ps(d, _mm_mul_ps(s, r)));
+	}
+	addPanGainRampScalar_(dst + i*2, src + i*2, ramp + i, frames - i, gainL, gainR);
+}
+
+
+__attribute__((target("sse2")))
+void copyGainSse2_(float* dst, const float* src, int samples, float gain)
+{
+	const __m128 g = _mm_set1_ps(gain);
+	int i = 0;
+	for (; i + 4 <= samples; i+=4)
+		_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+	copyGainScalar_(dst + i, src + i, samples - i, gain);
+}
+
+
+__attribute__((target("sse2")))
+void clampSse2_(float* buf, int samples, float min, float max)
+{
+	const __m128 lo = _mm_set1_ps(min);
+	const __m128 hi = _mm_set1_ps(max);
+	int i = 0;
+	for (; i + 4 <= samples; i+=4)
+		_mm_storeu_ps(buf + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(buf + i), lo), hi));
+	clampScalar_(buf + i, samples - i, min, max);
+}
+
+
+__attribute__((target("sse2")))
+float peakAbsSse2_(const float* buf, int samples)
+{
+	const __m128 sign = _mm_set1_ps(-0.0f);
+	__m128 peak = _mm_setzero_ps();
+	int i = 0;
+	for (; i + 4 <= samples; i+=4)
+		peak = _mm_max_ps(peak, _mm_andnot_ps(sign, _mm_loadu_ps(buf + i)));
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, peak);
+	float out = peakAbsScalar_(buf + i, samples - i);
+	for (float l : lanes)
+		out = std::max(out, l);
+	return out;
+}
+
+
+__attribute__((target("sse2")))
+void dotStereoSse2_(const float* src, const float* coeffs, int frames, 
+	float* out)
+{
+	__m128 acc = _mm_setzero_ps();
+	int i = 0;
+	for (; i + 2 <= frames; i+=2) {
+		__m128 c = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(coeffs + i)));
+		c = _mm_unpacklo_ps(c, c); // c0 c0 c1 c1
+		acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(src + i*2), c));
+	}
+
+	float a[4];
+	_mm_storeu_ps(a, acc);
+	if (i < frames) {
+		a[0] = mulAdd_(a[0], src[i*2],     coeffs[i]);
+		a[1] = mulAdd_(a[1], src[i*2 + 1], coeffs[i]);
+	}
+	out[0] = a[0] + a[2];
+	out[1] = a[1] + a[3];
+}
+
+
+const Kernels sse2_ = { Isa::SSE2, addGainSse2_, addPanGainSse2_, 
+	addPanGainRampSse2_, copyGainSse2_, clampSse2_, peakAbsSse2_, dotStereoSse2_ };
+
+
+/* -------------------------------------------------------------------------- */
+
+
+__attribute__((target("avx2")))
+void addGainAvx2_(float* dst, const float* src, int samples, float gain)
+{
+	const __m256 g = _mm256_set1_ps(gain);
+	int i = 0;
+	for (; i + 8 <= samples; i+=8) {
+		__m256 d = _mm256_loadu_ps(dst + i);
+		__m256 s = _mm256_loadu_ps(src + i);
+		_mm256_storeu_ps(dst + i, _mm256_add_ps(d, _mm256_mul_ps(s, g)));
+	}
+	addGainScalar_(dst + i, src + i, samples - i, gain);
+}
+
+
+__attribute__((target("avx2")))
+void addPanGainAvx2_(float* dst, const float* src, int frames, float gainL, 
+	float gainR)
+{
+	const __m256 g = _mm256_setr_ps(gainL, gainR, gainL, gainR, gainL, gainR, 
+		gainL, gainR);
+	int i = 0;
+	for (; i + 8 <= frames * 2; i+=8) {
+		__m256 d = _mm256_loadu_ps(dst + i);
+		__m256 s = _mm256_loadu_ps(src + i);
+		_mm256_storeu_ps(dst + i, _mm256_add_ps(d, _mm256_mul_ps(s, g)));
+	}
+	addPanGainScalar_(dst + i, src + i, frames - i / 2, gainL, gainR);
+}
+
+
+__attribute__((target("avx2")))
+void addPanGainRampAvx2_(float* dst, const float* src, const float* ramp, 
+	int frames, float gainL, float gainR)
+{
+	const __m256 g = _mm256_setr_ps(gainL, gainR, gainL, gainR, gainL, gainR, 
+		gainL, gainR);
+	int i = 0;
+	for (; i + 4 <= frames; i+=4) {
+		__m128 r4 = _mm_loadu_ps(ramp + i);
+		__m256 r  = _mm256_insertf128_ps(_mm256_castps128_ps256(
+			_mm_unpacklo_ps(r4, r4)), _mm_unpackhi_ps(r4, r4), 1); // r0 r0 .. r3 r3
+		r = _mm256_mul_ps(r, g);
+		__m256 d = _mm256_loadu_ps(dst + i*2);
+		__m256 s = _mm256_loadu_ps(src + i*2);
+		_mm256_storeu_ps(dst + i*2, _mm256_add_ps(d, _mm256_mul_ps(s, r)));
+	}
+	addPanGainRampScalar_(dst + i*2, src + i*2, ramp + i, frames - i, gainL, gainR);
+}
+
+
+__attribute__((target("avx2")))
+void copyGainAvx2_(float* dst, const float* src, int samples, float gain)
+{
+	const __m256 g = _mm256_set1_ps(gain);
+	int i = 0;
+	for (; i + 8 <= samples; i+=8)
+		_mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), g));
+	copyGainScalar_(dst + i, src + i, samples - i, gain);
+}
+
+
+__attribute__((target("avx2")))
+void clampAvx2_(float* buf, int samples, float min, float max)
+{
+	const __m256 lo = _mm256_set1_ps(min);
+	const __m256 hi = _mm256_set1_ps(max);
+	int i = 0;
+	for (; i + 8 <= samples; i+=8)
+		_mm256_storeu_ps(buf + i, _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(buf + i), lo), hi));
+	clampScalar_(buf + i, samples - i, min, max);
+}
+
+
+__attribute__((target("avx2")))
+float peakAbsAvx2_(const float* buf, int samples)
+{
+	const __m256 sign = _mm256_set1_ps(-0.0f);
+	__m256 peak = _mm256_setzero_ps();
+	int i = 0;
+	for (; i + 8 <= samples; i+=8)
+		peak = _mm256_max_ps(peak, _mm256_andnot_ps(sign, _mm256_loadu_ps(buf + i)));
+
+	float lanes[8];
+	_mm256_storeu_ps(lanes, peak);
+	float out = peakAbsScalar_(buf + i, samples - i);
+	for (float l : lanes)
+		out = std::max(out, l);
+	return out;
+}
+
+
+/* dotStereo is shared with SSE2: filters are a few frames long, and a wider
+accumulator would change the summation order. */
+
+const Kernels avx2_ = { Isa::AVX2, addGainAvx2_, addPanGainAvx2_, 
+	addPanGainRampAvx2_, copyGainAvx2_, clampAvx2_, peakAbsAvx2_, dotStereoSse2_ };
+
+#endif // G_DSP_X86
+
+
+/* -------------------------------------------------------------------------- */
+
+
+#if defined(G_DSP_NEON)
+
+void addGainNeon_(float* dst, const float* src, int samples, float gain)
+{
+	const float32x4_t g = vdupq_n_f32(gain);
+	int i = 0;
+	for (; i + 4 <= samples; i+=4)
+		vst1q_f32(dst + i, vfmaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), g));
+	addGainScalar_(dst + i, src + i, samples - i, gain);
+}
+
+
+void addPanGainNeon_(float* dst, const float* src, int frames, float gainL, 
+	float gainR)
+{
+	const float gains[4] = { gainL, gainR, gainL, gainR };
+	const float32x4_t g = vld1q_f32(gains);
+	int i = 0;
+	for (; i + 4 <= frames * 2; i+=4)
+		vst1q_f32(dst + i, vfmaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), g));
+	addPanGainScalar_(dst + i, src + i, frames - i / 2, gainL, gainR);
+}
+
+
+void addPanGainRampNeon_(float* dst, const float* src, const float* ramp, 
+	int frames, float gainL, float gainR)
+{
+	const float gains[4] = { gainL, gainR, gainL, gainR };
+	const float32x4_t g = vld1q_f32(gains);
+	int i = 0;
+	for (; i + 2 <= frames; i+=2) {
+		float32x2_t r = vld1_f32(ramp + i);
+		float32x4_t rg = vmulq_f32(vcombine_f32(vdup_lane_f32(r, 0), 
+			vdup_lane_f32(r, 1)), g);
+		vst1q_f32(dst + i*2, vfmaq_f32(vld1q_f32(dst + i*2), vld1q_f32(src + i*2), rg));
+	}
+	addPanGainRampScalar_(dst + i*2, src + i*2, ramp + i, frames - i, gainL, gainR);
+}
+
+
+void copyGainNeon_(float* dst, const float* src, int samples, float gain)
+{
+	const float32x4_t g = vdupq_n_f32(gain);
+	int i = 0;
+	for (; i + 4 <= samples; i+=4)
+		vst1q_f32(dst + i, vmulq_f32(vld1q_f32(src + i), g));
+	copyGainScalar_(dst + i, src + i, samples - i, gain);
+}
+
+
+void clampNeon_(float* buf, int samples, float min, float max)
+{
+	const float32x4_t lo = vdupq_n_f32(min);
+	const float32x4_t hi = vdupq_n_f32(max);
+	int i = 0;
+	for (; i + 4 <= samples; i+=4)
+		vst1q_f32(buf + i, vminq_f32(vmaxq_f32(vld1q_f32(buf + i), lo), hi));
+	clampScalar_(buf + i, samples - i, min, max);
+}
+
+
+float peakAbsNeon_(const float* buf, int samples)
+{
+	float32x4_t peak = vdupq_n_f32(0.0f);
+	int i = 0;
+	for (; i + 4 <= samples; i+=4)
+		peak = vmaxq_f32(peak, vabsq_f32(vld1q_f32(buf + i)));
+	return std::max(vmaxvq_f32(peak), peakAbsScalar_(buf + i, samples - i));
+}
+
+
+void dotStereoNeon_(const float* src, const float* coeffs, int frames, 
+	float* out)
+{
+	float32x4_t acc = vdupq_n_f32(0.0f);
+	int i = 0;
+	for (; i + 2 <= frames; i+=2) {
+		float32x2_t c = vld1_f32(coeffs + i);
+		acc = vfmaq_f32(acc, vld1q_f32(src + i*2), 
+			vcombine_f32(vdup_lane_f32(c, 0), vdup_lane_f32(c, 1)));
+	}
+
+	float a[4];
+	vst1q_f32(a, acc);
+	if (i < frames) {
+		a[0] = mulAdd_(a[0], src[i*2],     coeffs[i]);
+		a[1] = mulAdd_(a[1], src[i*2 + 1], coeffs[i]);
+	}
+	out[0] = a[0] + a[2];
+	out[1] = a[1] + a[3];
+}
+
+
+const Kernels neon_ = { Isa::NEON, addGainNeon_, addPanGainNeon_, 
+	addPanGainRampNeon_, copyGainNeon_, clampNeon_, peakAbsNeon_, dotStereoNeon_ };
+
+#endif // G_DSP_NEON
+
+
+/* -------------------------------------------------------------------------- */
+
+
+const Kernels* getKernels_(Isa isa)
+{
+	switch (isa) {
+#if defined(G_DSP_X86)
+		case Isa::AVX2:
+			return __builtin_cpu_supports("avx2") ? &avx2_ : nullptr;
+		case Isa::SSE2:
+			return __builtin_cpu_supports("sse2") ? &sse2_ : nullptr;
+#endif
+#if defined(G_DSP_NEON)
+		case Isa::NEON:
+			return &neon_;
+#endif
+		case Isa::SCALAR:
+			return &scalar_;
+		default:
+			return nullptr;
+	}
+}
+
+
+const Kernels* detect_()
+{
+#if defined(G_DSP_X86)
+	__builtin_cpu_init();
+#endif
+	for (Isa isa : { Isa::AVX2, Isa::SSE2, Isa::NEON })
+		if (const Kernels* k = getKernels_(isa))
+			return k;
+	return &scalar_;
+}
+
+
+/* kernels_
+Kernels in use, picked once at startup. */
+
+const Kernels* kernels_ = detect_();
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+Isa getIsa()
+{
+	return kernels_->isa;
+}
+
+
+bool setIsa(Isa isa)
+{
+	const Kernels* k = getKernels_(isa);
+	if (k == nullptr)
+		return false;
+	kernels_ = k;
+	return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void addGain(float* dst, const float* src, int samples, float gain)
+{
+	kernels_->addGain(dst, src, samples, gain);
+}
+
+
+void addPanGain(float* dst, const float* src, int frames, float gainL, 
+	float gainR)
+{
+	kernels_->addPanGain(dst, src, frames, gainL, gainR);
+}
+
+
+void addPanGainRamp(float* dst, const float* src, const float* ramp, int frames, 
+	float gainL, float gainR)
+{
+	kernels_->addPanGainRamp(dst, src, ramp, frames, gainL, gainR);
+}
+
+
+void copyGain(float* dst, const float* src, int samples, float gain)
+{
+	kernels_->copyGain(dst, src, samples, gain);
+}
+
+
+void clamp(float* buf, int samples, float min, float max)
+{
+	kernels_->clamp(buf, samples, min, max);
+}
+
+
+float peakAbs(const float* buf, int samples)
+{
+	return kernels_->peakAbs(buf, samples);
+}
+
+
+void dotStereo(const float* src, const float* coeffs, int frames, float* out)
+{
+	kernels_->dotStereo(src, coeffs, frames, out);
+}
+}}} // giada::m::dsp::
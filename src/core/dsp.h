@@ -0,0 +1,97 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_DSP_H
+#define G_DSP_H
+
+
+namespace giada {
+namespace m {
+namespace dsp
+{
+/* Isa
+Instruction sets with a dedicated implementation of the kernels below. */
+
+enum class Isa { SCALAR, SSE2, AVX2, NEON };
+
+/* getIsa
+Returns the instruction set in use, i.e. the best one available on this CPU
+unless changed with setIsa(). */
+
+Isa getIsa();
+
+/* setIsa
+Forces a specific instruction set. Returns false and leaves things untouched
+if the CPU (or the build) doesn't support it. Not thread-safe: meant for 
+testing and benchmarking only. */
+
+bool setIsa(Isa isa);
+
+/* addGain
+dst[i] += src[i] * gain, for 'samples' samples. */
+
+void addGain(float* dst, const float* src, int samples, float gain);
+
+/* addPanGain
+Stereo version of addGain above for interleaved buffers: left samples are 
+multiplied by 'gainL', right ones by 'gainR'. */
+
+void addPanGain(float* dst, const float* src, int frames, float gainL, 
+	float gainR);
+
+/* addPanGainRamp
+Same as addPanGain above, with an additional per-frame gain 'ramp' (one value 
+for each frame), e.g. a volume envelope. */
+
+void addPanGainRamp(float* dst, const float* src, const float* ramp, int frames, 
+	float gainL, float gainR);
+
+/* copyGain
+dst[i] = src[i] * gain. 'dst' and 'src' can be the same buffer. */
+
+void copyGain(float* dst, const float* src, int samples, float gain=1.0f);
+
+/* clamp
+Clamps each sample in the range [min, max]. */
+
+void clamp(float* buf, int samples, float min, float max);
+
+/* peakAbs
+Returns the highest absolute value in the buffer. */
+
+float peakAbs(const float* buf, int samples);
+
+/* dotStereo
+Dot product of 'frames' interleaved stereo frames with the same coefficients
+for both channels: out[0] = sum(src[i*2] * coeffs[i]), out[1] likewise with 
+src[i*2 + 1]. Used by FIR filters. */
+
+void dotStereo(const float* src, const float* coeffs, int frames, float* out);
+}}} // giada::m::dsp::
+
+
+#endif
@@ -0,0 +1,225 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <sndfile.h>
+#include "utils/fs.h"
+#include "core/mixer.h"
+#include "core/mixerHandler.h"
+#include "core/clock.h"
+#include "core/conf.h"
+#include "core/const.h"
+#include "core/patch.h"
+#include "core/recorderHandler.h"
+#include "core/renderer.h"
+#include "core/init.h"
+#include "headless.h"
+
+
+namespace giada {
+namespace m {
+namespace headless
+{
+namespace
+{
+/* loadPatch_
+Same steps of c::storage::loadPatch(), without the UI. */
+
+bool loadPatch_(const std::string& path)
+{
+	std::string fileToLoad = path;
+	std::string basePath   = "";
+	if (u::fs::isProject(path)) {
+		fileToLoad = path + G_SLASH + u::fs::stripExt(u::fs::basename(path)) + ".gptc";
+		basePath   = path + G_SLASH;
+	}
+
+	if (patch::verify(fileToLoad) != G_PATCH_OK || 
+	    patch::read(fileToLoad, basePath) != G_PATCH_OK) {
+		std::fprintf(stderr, "Unable to read patch %s\n", fileToLoad.c_str());
+		return false;
+	}
+
+	mixer::allocVirtualInput(clock::getFramesInLoop());
+	mh::updateSoloCount();
+	recorderHandler::updateSamplerate(conf::samplerate, patch::samplerate);
+
+	return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool readFile_(const std::string& path, std::vector<float>& data, SF_INFO& header)
+{
+	header.format = 0;
+	SNDFILE* file = sf_open(path.c_str(), SFM_READ, &header);
+	if (file == nullptr) {
+		std::fprintf(stderr, "Unable to read %s: %s\n", path.c_str(), sf_strerror(file));
+		return false;
+	}
+	data.resize(header.frames * header.channels);
+	sf_readf_float(file, data.data(), header.frames);
+	sf_close(file);
+	return true;
+}
+}; // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+bool parseArgs(int argc, char** argv, Args& a)
+{
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (i + 1 == argc) {
+			std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+			return false;
+		}
+		std::string val = argv[++i];
+		if      (arg == "--render")    a.patch     = val;
+		else if (arg == "--out")       a.out       = val;
+		else if (arg == "--stems")     a.stems     = val;
+		else if (arg == "--compare")   a.compare   = val;
+		else if (arg == "--bars")      a.bars      = std::atoi(val.c_str());
+		else if (arg == "--tolerance") a.tolerance = std::atof(val.c_str());
+		else {
+			std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+			return false;
+		}
+	}
+	return a.patch != "" && a.out != "" && a.bars > 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+int compare(const std::string& path, const std::string& reference, float tolerance)
+{
+	std::vector<float> out, golden;
+	SF_INFO hOut, hGolden;
+
+	if (!readFile_(path, out, hOut) || !readFile_(reference, golden, hGolden))
+		return 1;
+
+	if (hOut.channels != hGolden.channels || hOut.samplerate != hGolden.samplerate) {
+		std::printf("FAIL: format mismatch (%d ch, %d Hz vs %d ch, %d Hz)\n",
+			hOut.channels, hOut.samplerate, hGolden.channels, hGolden.samplerate);
+		return 2;
+	}
+
+	float  maxDev   = 0.0f;
+	size_t maxDevAt = 0;
+	for (size_t i = 0; i < std::min(out.size(), golden.size()); i++) {
+		float dev = std::fabs(out[i] - golden[i]);
+		if (dev > maxDev) {
+			maxDev   = dev;
+			maxDevAt = i;
+		}
+	}
+
+	std::printf("max deviation: %g at frame %zu\n", maxDev, maxDevAt / hOut.channels);
+
+	if (hOut.frames != hGolden.frames) {
+		std::printf("FAIL: length mismatch (%lld vs %lld frames)\n", 
+			static_cast<long long>(hOut.frames), static_cast<long long>(hGolden.frames));
+		return 2;
+	}
+	if (maxDev > tolerance) {
+		std::printf("FAIL: deviation above tolerance %g\n", tolerance);
+		return 2;
+	}
+	std::printf("PASS\n");
+	return 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool isRequested(int argc, char** argv)
+{
+	for (int i = 1; i < argc; i++)
+		if (std::string(argv[i]) == "--render")
+			return true;
+	return false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+int run(int argc, char** argv)
+{
+	Args a;
+	if (!parseArgs(argc, argv, a)) {
+		std::fprintf(stderr, "Usage: giada --render patch.gptc --bars N --out file.wav "
+			"[--stems dir] [--compare golden.wav [--tolerance x]]\n");
+		return 1;
+	}
+
+	init::startupHeadless();
+
+	if (!loadPatch_(a.patch)) {
+		init::shutdownHeadless();
+		return 1;
+	}
+
+	renderer::Options o;
+	o.path      = a.out;
+	o.stemsPath = a.stems;
+	o.frames    = renderer::getFramesInBars(a.bars);
+
+	auto start = std::chrono::steady_clock::now();
+	int  res   = renderer::render(o);
+	auto end   = std::chrono::steady_clock::now();
+
+	init::shutdownHeadless();
+
+	if (res != G_RES_OK)
+		return 1;
+
+	double elapsed  = std::chrono::duration<double>(end - start).count();
+	double duration = static_cast<double>(o.frames) / conf::samplerate;
+
+	std::printf("rendered %d bars (%.2f s) in %.3f s, %.1fx real time\n", a.bars, 
+		duration, elapsed, elapsed > 0.0 ? duration / elapsed : 0.0);
+
+	return a.compare != "" ? compare(a.out, a.compare, a.tolerance) : 0;
+}
+}}}; // giada::m::headless::
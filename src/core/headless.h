@@ -0,0 +1,82 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_HEADLESS_H
+#define G_HEADLESS_H
+
+
+#include <string>
+
+
+namespace giada {
+namespace m {
+namespace headless
+{
+struct Args
+{
+	std::string patch;
+	std::string out;
+	std::string stems;
+	std::string compare;
+	int         bars      = 0;
+	float       tolerance = 0.00001f;
+};
+
+/* isRequested
+True if the command line asks for a headless render, i.e. contains --render. */
+
+bool isRequested(int argc, char** argv);
+
+/* run
+Renders a patch to file with no GUI and no audio device, then optionally 
+compares the result against a reference file:
+
+	giada --render patch.gptc --bars N --out file.wav [--stems dir] 
+		[--compare golden.wav [--tolerance x]]
+
+Returns the process exit code: 0 on success, 1 on errors, 2 if the render 
+deviates from the reference more than the tolerance. */
+
+int run(int argc, char** argv);
+
+/* parseArgs
+Fills 'a' with the command line options. Returns false if an option is unknown
+or has no value, or if patch, output file or a positive number of bars are 
+missing. */
+
+bool parseArgs(int argc, char** argv, Args& a);
+
+/* compare
+Prints the maximum sample deviation between the file in 'path' and the 
+reference one. Returns the same exit codes of run(): 2 if formats or lengths 
+don't match, or if the deviation is above 'tolerance'. */
+
+int compare(const std::string& path, const std::string& reference, float tolerance);
+}}}; // giada::m::headless::
+
+
+#endif
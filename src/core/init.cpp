@@ -53,11 +53,14 @@
 #include "core/patch.h"
 #include "core/conf.h"
 #include "core/waveManager.h"
+#include "core/diskReader.h"
+#include "core/waveCache.h"
 #include "core/pluginManager.h"
 #include "core/pluginHost.h"
 #include "core/recorder.h"
 #include "core/recorderHandler.h"
 #include "core/recManager.h"
+#include "core/rtAudit.h"
 #include "core/midiMapConf.h"
 #include "core/kernelMidi.h"
 #include "core/kernelAudio.h"
@@ -87,6 +90,8 @@ void initConf_()
 
 	if (midimap::read(conf::midiMapPath) != MIDIMAP_READ_OK)
 		u::log::print("[init] MIDI map read failed!\n");
+
+	waveCache::init(conf::sampleCache ? u::fs::getHomePath() + G_SLASH + G_SAMPLE_CACHE_DIR : "");
 }
 
 
@@ -100,6 +105,7 @@ void initAudio_()
 	mh::init();
 	recorder::init();
 	recorderHandler::init();
+	diskReader::init();
 
 #ifdef WITH_VST
 
@@ -119,6 +125,27 @@ void initAudio_()
 /* -------------------------------------------------------------------------- */
 
 
+void initOfflineAudio_()
+{
+	kernelAudio::openOffline();
+	clock::init(conf::samplerate, conf::midiTCfps);
+	mh::init();
+	recorder::init();
+	recorderHandler::init();
+	diskReader::init();
+
+#ifdef WITH_VST
+
+	pluginManager::init(conf::samplerate, kernelAudio::getRealBufSize());
+	pluginHost::init(kernelAudio::getRealBufSize());
+
+#endif
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void initMIDI_()
 {
 	kernelMidi::setApi(conf::midiSystem);
@@ -164,10 +191,16 @@ void shutdownAudio_()
 	if (kernelAudio::isReady()) {
 		kernelAudio::closeDevice();
 		u::log::print("[init] KernelAudio closed\n");
+#ifdef WITH_RT_AUDIT
+		rtAudit::report();
+#endif
 		mh::close();
 		u::log::print("[init] Mixer closed\n");
 	}
 
+	kernelMidi::close();
+	diskReader::close();
+
 	/* TODO - why cleaning plug-ins and mixer memory? Just shutdown the audio
 	device and let the OS take care of the rest. */
 
@@ -268,4 +301,32 @@ void shutdown()
 	u::log::print("[init] Giada %s closed\n\n", G_VERSION_STR);
 	u::log::close();
 }
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void startupHeadless()
+{
+	initConf_();
+	initOfflineAudio_();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void shutdownHeadless()
+{
+	mh::close();
+	diskReader::close();
+
+#ifdef WITH_VST
+
+	pluginHost::close();
+
+#endif
+
+	u::log::close();
+}
 }}} // giada::m::init
@@ -37,6 +37,13 @@ void startup(int argc, char** argv);
 void reset(); 
 void closeMainWindow();
 void shutdown();
+
+/* startupHeadless, shutdownHeadless
+Brings up and tears down the engine without GUI, audio and MIDI devices, for
+offline rendering. */
+
+void startupHeadless();
+void shutdownHeadless();
 }}} // giada::m::init
 
 #endif
@@ -250,6 +250,18 @@ std::string getDeviceName(unsigned dev)
 /* -------------------------------------------------------------------------- */
 
 
+void openOffline()
+{
+	api          = G_SYS_API_NONE;
+	inputEnabled = false;
+	realBufsize  = conf::buffersize;
+	u::log::print("[KA] offline mode, buffer size = %d\n", realBufsize);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 int closeDevice()
 {
 	if (rtSystem->isStreamOpen()) {
@@ -57,6 +57,12 @@ int closeDevice();
 int startStream();
 int stopStream();
 
+/* openOffline
+Sets up the buffer size without opening any device, for offline rendering 
+with no audio hardware. isReady() stays false. */
+
+void openOffline();
+
 bool isReady();
 bool isProbed(unsigned dev);
 bool isDefaultIn(unsigned dev);
@@ -25,6 +25,11 @@
  * -------------------------------------------------------------------------- */
 
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 #include "const.h"
 #ifdef G_OS_MAC
 #include <RtMidi.h>
@@ -32,6 +37,8 @@
 #include <rtmidi/RtMidi.h>
 #endif
 #include "utils/log.h"
+#include "profiler.h"
+#include "mpscQueue.h"
 #include "midiDispatcher.h"
 #include "midiMapConf.h"
 #include "kernelMidi.h"
@@ -43,16 +50,53 @@ namespace kernelMidi
 {
 namespace
 {
+/* MAX_STAMP_DRIFT
+How far back in time, in nanoseconds, a timestamp rebuilt from RtMidi deltas 
+can go before it's considered wrong. */
+
+constexpr profiler::Time MAX_STAMP_DRIFT = 10000000; // 10 ms
+
+/* OUT_POLL_PERIOD
+How often, in nanoseconds, the output thread checks for new messages when 
+there's nothing due earlier. Messages from the audio thread are stamped at 
+least one buffer ahead, so they are never late as long as the buffer is 
+longer than this. */
+
+constexpr profiler::Time OUT_POLL_PERIOD = 1000000; // 1 ms
+
+/* OutMessage
+A MIDI message waiting to be sent at 'time'. 'size' bytes long (1 to 3). */
+
+struct OutMessage
+{
+	profiler::Time time;
+	unsigned char  data[3];
+	int            size;
+};
+
 bool status_ = false;
 int api_ = 0;
 RtMidiOut* midiOut_ = nullptr;
 RtMidiIn*  midiIn_  = nullptr;
 unsigned numOutPorts_ = 0;
 unsigned numInPorts_  = 0;
+profiler::Time lastStamp_ = 0;
+
+/* outQueue_
+Messages to send, filled by any thread and drained by the output thread. */
+
+MpscQueue<OutMessage> outQueue_(G_MIDI_OUT_QUEUE_SIZE);
+
+std::thread       outThread_;
+std::atomic<bool> outRunning_(false);
 
 
+/* -------------------------------------------------------------------------- */
+
 static void callback_(double t, std::vector<unsigned char>* msg, void* data)
 {
+	profiler::Time stamp = kernelMidi::stamp(t, profiler::now(), lastStamp_);
+
 	if (msg->size() < 3) {
 		//u::log::print("[KM] MIDI received - unknown signal - size=%d, value=0x", (int) msg->size());
 		//for (unsigned i=0; i<msg->size(); i++)
@@ -60,7 +104,90 @@ static void callback_(double t, std::vector<unsigned char>* msg, void* data)
 		//u::log::print("\n");
 		return;
 	}
-	midiDispatcher::dispatch(msg->at(0), msg->at(1), msg->at(2));
+	midiDispatcher::dispatch(msg->at(0), msg->at(1), msg->at(2), stamp);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void sendMessage_(const OutMessage& m, std::vector<unsigned char>& msg)
+{
+	msg.assign(m.data, m.data + m.size);
+	midiOut_->sendMessage(&msg);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* runOut_
+Body of the MIDI output thread. Queued messages are moved into a list sorted by
+time (same-time messages keep their order), then sent when due. The thread 
+sleeps until the next message is due or for OUT_POLL_PERIOD at most. Whatever 
+is left is sent right away on close. */
+
+void runOut_()
+{
+	using namespace std::chrono;
+
+	std::vector<OutMessage>    pending;
+	std::vector<unsigned char> msg;
+	pending.reserve(G_MIDI_OUT_QUEUE_SIZE);
+	msg.reserve(3);
+
+	auto fetch = [&pending]()
+	{
+		OutMessage m;
+		while (outQueue_.pop(m)) {
+			auto it = std::upper_bound(pending.begin(), pending.end(), m, 
+				[](const OutMessage& a, const OutMessage& b) { return a.time < b.time; });
+			pending.insert(it, m);
+		}
+	};
+
+	while (outRunning_.load()) {
+		fetch();
+
+		profiler::Time now = profiler::now();
+		auto due = pending.begin();
+		for (; due != pending.end() && due->time <= now; ++due)
+			sendMessage_(*due, msg);
+		pending.erase(pending.begin(), due);
+
+		profiler::Time wake = now + OUT_POLL_PERIOD;
+		if (!pending.empty())
+			wake = std::min(wake, pending.front().time);
+		std::this_thread::sleep_until(steady_clock::time_point(
+			duration_cast<steady_clock::duration>(nanoseconds(wake))));
+	}
+
+	fetch();
+	for (const OutMessage& m : pending)
+		sendMessage_(m, msg);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void startOut_()
+{
+	if (outThread_.joinable())
+		return;
+	outRunning_.store(true);
+	outThread_ = std::thread(runOut_);
+	u::log::print("[KM] MIDI output thread started\n");
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void push_(OutMessage m)
+{
+	if (!status_ || midiOut_ == nullptr)
+		return;
+	outQueue_.push(m);
 }
 
 
@@ -100,6 +227,7 @@ int openOutDevice(int port)
 	try {
 		midiOut_ = new RtMidiOut((RtMidi::Api) api_, "Giada MIDI Output");
 		status_  = true;
+		startOut_();
 	}
 	catch (RtMidiError &error) {
 		u::log::print("[KM] MIDI out device error: %s\n", error.getMessage().c_str());
@@ -198,6 +326,25 @@ bool hasAPI(int API)
 /* -------------------------------------------------------------------------- */
 
 
+profiler::Time stamp(double delta, profiler::Time now, profiler::Time& last)
+{
+	/* Deltas from the driver are more accurate than the time the input 
+	callback runs at, when messages arrive in bursts. Fall back to the current 
+	time for the first message or when the two drift apart. */
+
+	profiler::Time t = last + static_cast<profiler::Time>(delta * 1000000000.0);
+
+	if (last == 0 || t > now || now - t > MAX_STAMP_DRIFT)
+		t = now;
+
+	last = t;
+	return t;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 std::string getOutPortName(unsigned p)
 {
 	try { return midiOut_->getPortName(p); }
@@ -214,37 +361,36 @@ std::string getInPortName(unsigned p)
 /* -------------------------------------------------------------------------- */
 
 
-void send(uint32_t data)
+void send(uint32_t data, profiler::Time t)
 {
-	if (!status_)
-		return;
-
-	std::vector<unsigned char> msg(1, getB1(data));
-	msg.push_back(getB2(data));
-	msg.push_back(getB3(data));
-
-	midiOut_->sendMessage(&msg);
-	u::log::print("[KM] send msg=0x%X (%X %X %X)\n", data, msg[0], msg[1], msg[2]);
+	OutMessage m;
+	m.time    = t;
+	m.data[0] = getB1(data);
+	m.data[1] = getB2(data);
+	m.data[2] = getB3(data);
+	m.size    = 3;
+	push_(m);
 }
 
 
 /* -------------------------------------------------------------------------- */
 
 
-void send(int b1, int b2, int b3)
+void send(int b1, int b2, int b3, profiler::Time t)
 {
-	if (!status_)
-		return;
-
-	std::vector<unsigned char> msg(1, b1);
+	OutMessage m;
+	m.time    = t;
+	m.data[0] = b1;
+	m.data[1] = 0;
+	m.data[2] = 0;
+	m.size    = 1;
 
 	if (b2 != -1)
-		msg.push_back(b2);
+		m.data[m.size++] = b2;
 	if (b3 != -1)
-		msg.push_back(b3);
+		m.data[m.size++] = b3;
 
-	midiOut_->sendMessage(&msg);
-	//u::log::print("[KM] send msg=(%X %X %X)\n", b1, b2, b3);
+	push_(m);
 }
 
 
@@ -256,13 +402,7 @@ void sendMidiLightning(uint32_t learn, const midimap::Message& m)
 	// Skip lightning message if not defined in midi map
 
 	if (!midimap::isDefined(m))
-	{
-		u::log::print("[KM] message skipped (not defined in midimap)");
 		return;
-	}
-
-	u::log::print("[KM] learn=%#X, chan=%d, msg=%#X, offset=%d\n", learn, m.channel, 
-		m.value, m.offset);
 
 	/* Isolate 'channel' from learnt message and offset it as requested by 'nn' in 
 	the midimap configuration file. */
@@ -280,6 +420,19 @@ void sendMidiLightning(uint32_t learn, const midimap::Message& m)
 /* -------------------------------------------------------------------------- */
 
 
+void close()
+{
+	if (!outThread_.joinable())
+		return;
+	outRunning_.store(false);
+	outThread_.join();
+	u::log::print("[KM] MIDI output thread stopped\n");
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 unsigned countInPorts()  { return numInPorts_; }
 unsigned countOutPorts() { return numOutPorts_; }
 bool getStatus()         { return status_; }
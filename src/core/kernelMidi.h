@@ -31,6 +31,7 @@
 
 #include <cstdint>
 #include <string>
+#include "profiler.h"
 #include "midiMapConf.h"
 
 
@@ -51,13 +52,17 @@ channel. */
 uint32_t setChannel(uint32_t iValue, int channel);
 
 /* send
-Sends a MIDI message 's' as uint32_t or as separate bytes. */
+Sends a MIDI message 's' as uint32_t or as separate bytes. The message is 
+queued and sent by the MIDI output thread at time 't' (from profiler::now()), 
+or as soon as possible if t == 0. Never blocks nor allocates: safe to call 
+from the audio thread and the render workers. Messages are dropped if the 
+queue is full. */
 
-void send(uint32_t s);
-void send(int b1, int b2=-1, int b3=-1);
+void send(uint32_t s, profiler::Time t=0);
+void send(int b1, int b2=-1, int b3=-1, profiler::Time t=0);
 
 /* sendMidiLightning
-Sends a MIDI lightning message defined by 'msg'. */
+Sends a MIDI lightning message defined by 'msg', as soon as possible. */
 
 void sendMidiLightning(uint32_t learn, const midimap::Message& msg);
 
@@ -78,6 +83,11 @@ int openInDevice(int port);
 int closeInDevice();
 int closeOutDevice();
 
+/* close
+Stops the MIDI output thread, after having sent the messages still queued. */
+
+void close();
+
 /* getIn/OutPortName
 Returns the name of the port 'p'. */
 
@@ -89,6 +99,14 @@ unsigned countOutPorts();
 
 bool hasAPI(int API);
 
+/* stamp
+Returns the time a MIDI message has been received at, given the time 'delta' 
+(in seconds) elapsed since the previous one as measured by the driver, the 
+stamp 'last' of the previous message (0 = none) and the current time 'now'. 
+Updates 'last'. */
+
+profiler::Time stamp(double delta, profiler::Time now, profiler::Time& last);
+
 }}}; // giada::m::kernelMidi::
 
 
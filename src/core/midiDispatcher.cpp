@@ -26,6 +26,9 @@
 
 
 #include <cassert>
+#include <atomic>
+#include <algorithm>
+#include <unordered_map>
 #include <vector>
 #include "glue/plugin.h"
 #include "glue/io.h"
@@ -64,134 +67,305 @@ std::function<void(MidiEvent)> learnCb_  = nullptr;
 /* -------------------------------------------------------------------------- */
 
 
-#ifdef WITH_VST
+/* Target
+What a learned MIDI message does on a channel. Channel targets are listed in 
+order of precedence: a message triggers only the first one that matches. */
 
-void processPlugins_(const std::vector<ID>& ids, const MidiEvent& midiEvent)
+enum class Target
 {
-	uint32_t pure = midiEvent.getRawNoVelocity();
-	float    vf   = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, 1.0f);
+	KEY_PRESS, KEY_REL, MUTE, KILL, ARM, SOLO, VOLUME, PITCH, READ_ACTIONS,
+	PLUGIN_PARAM
+};
 
-	/* Plugins' parameters layout reflects the structure of the matrix
-	Channel::midiInPlugins. It is safe to assume then that Plugin 'p' and 
-	k indexes match both the structure of Channel::midiInPlugins and the vector
-	of plugins. */
+const Target CHANNEL_TARGETS_[] = { 
+	Target::KEY_PRESS, Target::KEY_REL, Target::MUTE, Target::KILL, Target::ARM,
+	Target::SOLO, Target::VOLUME, Target::PITCH, Target::READ_ACTIONS 
+};
 
-	m::model::PluginsLock l(m::model::plugins);
 
-	for (ID id : ids) {
-		m::Plugin& p = m::model::get(m::model::plugins, id);
-		for (unsigned k = 0; k < p.midiInParams.size(); k++) {
-			if (pure != p.midiInParams.at(k))
-				continue;
-			c::plugin::setParameter(id, k, vf, /*gui=*/false);
-			u::log::print("  >>> [plugin %d parameter %d] (pure=0x%X, value=%d, float=%f)\n",
-				p.id, k, pure, midiEvent.getVelocity(), vf);
-		}
+/* Binding
+A learned MIDI message bound to a channel. 'pluginId' and 'param' are used 
+only by Target::PLUGIN_PARAM. */
+
+struct Binding
+{
+	ID       channelId;
+	Target   target;
+	ID       pluginId;
+	unsigned param;
+};
+
+
+/* table_
+Learned MIDI messages ('pure' values, i.e. without velocity) and the bindings
+they trigger. Read and rebuilt only by the MIDI thread. */
+
+std::unordered_map<uint32_t, std::vector<Binding>> table_;
+
+
+/* midiChannels_
+IDs of MIDI channels, which receive the full MIDI message as well. */
+
+std::vector<ID> midiChannels_;
+
+
+/* matches_
+Bindings matched by the current message. Its capacity fits the largest entry
+in table_, so collecting matches never allocates. */
+
+std::vector<Binding> matches_;
+
+
+/* dirty_, channelsVersion_, pluginsVersion_
+Tell whether table_ must be rebuilt: learned values have changed (dirty_), or
+channels and plug-ins have been added or removed. Swapping a channel doesn't
+count: isBound_() checks the live state of each binding anyway. */
+
+std::atomic<bool> dirty_(true);
+std::uint64_t     channelsVersion_ = 0;
+#ifdef WITH_VST
+std::uint64_t     pluginsVersion_  = 0;
+#endif
+
+
+/* -------------------------------------------------------------------------- */
+
+
+uint32_t getLearnedValue_(const Channel& ch, Target t)
+{
+	switch (t) {
+		case Target::KEY_PRESS: return ch.midiInKeyPress.load();
+		case Target::KEY_REL:   return ch.midiInKeyRel.load();
+		case Target::MUTE:      return ch.midiInMute.load();
+		case Target::KILL:      return ch.midiInKill.load();
+		case Target::ARM:       return ch.midiInArm.load();
+		case Target::SOLO:      return ch.midiInSolo.load();
+		case Target::VOLUME:    return ch.midiInVolume.load();
+		default: break;
 	}
+	if (ch.type != ChannelType::SAMPLE)
+		return 0x0;
+	const SampleChannel& sch = static_cast<const SampleChannel&>(ch);
+	if (t == Target::PITCH)
+		return sch.midiInPitch.load();
+	if (t == Target::READ_ACTIONS)
+		return sch.midiInReadActions.load();
+	return 0x0;
 }
 
+
+/* -------------------------------------------------------------------------- */
+
+
+bool isTableStale_()
+{
+	if (dirty_.exchange(false))
+		return true;
+	if (model::channels.getVersion() != channelsVersion_)
+		return true;
+#ifdef WITH_VST
+	if (model::plugins.getVersion() != pluginsVersion_)
+		return true;
 #endif
+	return false;
+}
 
 
 /* -------------------------------------------------------------------------- */
 
 
-void processChannels_(const MidiEvent& midiEvent)
+void rebuildTable_()
 {
-	uint32_t pure = midiEvent.getRawNoVelocity();
+	/* Versions are read before the lists: a change happening in the meantime
+	will trigger another rebuild on the next message. */
 
-	/* TODO - this is definitely not the best approach but it's necessary as
-	you can't call actions on m::model::channels while locking on a upper
-	level. Let's wait for a better async mechanism... */
+	channelsVersion_ = model::channels.getVersion();
+#ifdef WITH_VST
+	pluginsVersion_  = model::plugins.getVersion();
+#endif
 
-	std::vector<std::function<void()>> actions;
+	table_.clear();
+	midiChannels_.clear();
 
-	model::channels.lock();
-	for (Channel* ch : model::channels) {
+	model::ChannelsLock cl(model::channels);
+#ifdef WITH_VST
+	model::PluginsLock  pl(model::plugins);
+#endif
 
-		/* Do nothing on this channel if MIDI in is disabled or filtered out for
-		the current MIDI channel. */
+	std::vector<uint32_t> learned;
 
-		if (!ch->midiIn || !ch->isMidiInAllowed(midiEvent.getChannel()))
-			continue;
+	for (const Channel* ch : model::channels) {
 
-		if      (pure == ch->midiInKeyPress.load()) {
-			actions.push_back([=] {
-				u::log::print("  >>> keyPress, ch=%d (pure=0x%X)\n", ch->id, pure);
-				c::io::keyPress(ch->id, false, false, midiEvent.getVelocity());
-			});
-		}
-		else if (pure == ch->midiInKeyRel.load()) {
-			actions.push_back([=] {
-				u::log::print("  >>> keyRel ch=%d (pure=0x%X)\n", ch->id, pure);
-				c::io::keyRelease(ch->id, false, false);
-			});
-		}
-		else if (pure == ch->midiInMute.load()) {
-			actions.push_back([=] {
-				u::log::print("  >>> mute ch=%d (pure=0x%X)\n", ch->id, pure);
-				c::channel::toggleMute(ch->id);
-			});
-		}		
-		else if (pure == ch->midiInKill.load()) {
-			actions.push_back([=] {
-				u::log::print("  >>> kill ch=%d (pure=0x%X)\n", ch->id, pure);
-				c::channel::kill(ch->id, /*record=*/false);
-			});
-		}		
-		else if (pure == ch->midiInArm.load()) {
-			actions.push_back([=] {
-				u::log::print("  >>> arm ch=%d (pure=0x%X)\n", ch->id, pure);
-				c::channel::toggleArm(ch->id);
-			});
-		}
-		else if (pure == ch->midiInSolo.load()) {
-			actions.push_back([=] {
-				u::log::print("  >>> solo ch=%d (pure=0x%X)\n", ch->id, pure);
-				c::channel::toggleSolo(ch->id);
-			});
-		}
-		else if (pure == ch->midiInVolume.load()) {
-			actions.push_back([=] {
-				float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME); 
-				u::log::print("  >>> volume ch=%d (pure=0x%X, value=%d, float=%f)\n",
-					ch->id, pure, midiEvent.getVelocity(), vf);
-				c::channel::setVolume(ch->id, vf, /*gui=*/false);
-			});
+		if (ch->type == ChannelType::MIDI)
+			midiChannels_.push_back(ch->id);
+
+		learned.clear();
+		for (Target t : CHANNEL_TARGETS_) {
+			uint32_t value = getLearnedValue_(*ch, t);
+			if (value == 0x0 || std::find(learned.begin(), learned.end(), value) != learned.end())
+				continue;
+			learned.push_back(value);
+			table_[value].push_back({ ch->id, t, 0, 0 });
 		}
-		else {
-			const SampleChannel* sch = static_cast<const SampleChannel*>(ch);
-			if (pure == sch->midiInPitch.load()) {
-				actions.push_back([=] {
-					float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_PITCH); 
-					u::log::print("  >>> pitch ch=%d (pure=0x%X, value=%d, float=%f)\n",
-						sch->id, pure, midiEvent.getVelocity(), vf);
-					c::channel::setPitch(sch->id, vf);
-				});
-			}
-			else 
-			if (pure == sch->midiInReadActions.load()) {
-				actions.push_back([=] {
-					u::log::print("  >>> toggle read actions ch=%d (pure=0x%X)\n", sch->id, pure);
-					c::channel::toggleReadingActions(sch->id);
-				});
+
+#ifdef WITH_VST
+
+		/* Plugins' parameters layout reflects the structure of the matrix
+		Channel::midiInPlugins. It is safe to assume then that Plugin 'p' and 
+		k indexes match both the structure of Channel::midiInPlugins and the 
+		vector of plugins. */
+
+		for (ID id : ch->pluginIds) {
+			const Plugin& p = model::get(model::plugins, id);
+			for (unsigned k = 0; k < p.midiInParams.size(); k++) {
+				uint32_t value = p.midiInParams.at(k).load();
+				if (value != 0x0)
+					table_[value].push_back({ ch->id, Target::PLUGIN_PARAM, id, k });
 			}
 		}
+
+#endif
+	}
+
+	size_t maxMatches = 0;
+	for (const auto& kv : table_)
+		maxMatches = std::max(maxMatches, kv.second.size());
+	matches_.reserve(maxMatches);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* isBound_
+Checks binding 'b' against the current state of its channel, which might have
+changed since the last rebuild (e.g. MIDI input disabled or filtered out). Call
+it with model::channels locked. */
+
+bool isBound_(const Binding& b, uint32_t pure, int midiChannel)
+{
+	auto it = model::channels.find(b.channelId);
+	if (it == model::channels.end())
+		return false;
+
+	const Channel* ch = *it;
+	if (!ch->midiIn || !ch->isMidiInAllowed(midiChannel))
+		return false;
+
+	if (b.target != Target::PLUGIN_PARAM)
+		return getLearnedValue_(*ch, b.target) == pure;
+
 #ifdef WITH_VST
+	model::PluginsLock l(model::plugins);
+	auto p = model::plugins.find(b.pluginId);
+	return p != model::plugins.end() && b.param < (*p)->midiInParams.size() && 
+	       (*p)->midiInParams.at(b.param).load() == pure;
+#else
+	return false;
+#endif
+}
+
+
+/* -------------------------------------------------------------------------- */
 
-		/* Process learned plugins parameters. */
-		processPlugins_(ch->pluginIds, midiEvent); 
 
+void apply_(const Binding& b, const MidiEvent& midiEvent)
+{
+	uint32_t pure     = midiEvent.getRawNoVelocity();
+	int      velocity = midiEvent.getVelocity();
+	float    vf;
+
+	switch (b.target) {
+		case Target::KEY_PRESS:
+			u::log::print("  >>> keyPress, ch=%d (pure=0x%X, frame=%d)\n", b.channelId, 
+				pure, midiEvent.getDelta());
+			c::io::keyPress(b.channelId, false, false, velocity, midiEvent.getDelta());
+			break;
+		case Target::KEY_REL:
+			u::log::print("  >>> keyRel ch=%d (pure=0x%X)\n", b.channelId, pure);
+			c::io::keyRelease(b.channelId, false, false);
+			break;
+		case Target::MUTE:
+			u::log::print("  >>> mute ch=%d (pure=0x%X)\n", b.channelId, pure);
+			c::channel::toggleMute(b.channelId);
+			break;
+		case Target::KILL:
+			u::log::print("  >>> kill ch=%d (pure=0x%X)\n", b.channelId, pure);
+			c::channel::kill(b.channelId, /*record=*/false, midiEvent.getDelta());
+			break;
+		case Target::ARM:
+			u::log::print("  >>> arm ch=%d (pure=0x%X)\n", b.channelId, pure);
+			c::channel::toggleArm(b.channelId);
+			break;
+		case Target::SOLO:
+			u::log::print("  >>> solo ch=%d (pure=0x%X)\n", b.channelId, pure);
+			c::channel::toggleSolo(b.channelId);
+			break;
+		case Target::VOLUME:
+			vf = u::math::map(velocity, G_MAX_VELOCITY, G_MAX_VOLUME); 
+			u::log::print("  >>> volume ch=%d (pure=0x%X, value=%d, float=%f)\n",
+				b.channelId, pure, velocity, vf);
+			c::channel::setVolume(b.channelId, vf, /*gui=*/false);
+			break;
+		case Target::PITCH:
+			vf = u::math::map(velocity, G_MAX_VELOCITY, G_MAX_PITCH); 
+			u::log::print("  >>> pitch ch=%d (pure=0x%X, value=%d, float=%f)\n",
+				b.channelId, pure, velocity, vf);
+			c::channel::setPitch(b.channelId, vf);
+			break;
+		case Target::READ_ACTIONS:
+			u::log::print("  >>> toggle read actions ch=%d (pure=0x%X)\n", b.channelId, pure);
+			c::channel::toggleReadingActions(b.channelId);
+			break;
+		case Target::PLUGIN_PARAM:
+#ifdef WITH_VST
+			vf = u::math::map(velocity, G_MAX_VELOCITY, 1.0f);
+			c::plugin::setParameter(b.pluginId, b.param, vf, /*gui=*/false);
+			u::log::print("  >>> [plugin %d parameter %d] (pure=0x%X, value=%d, float=%f)\n",
+				b.pluginId, b.param, pure, velocity, vf);
 #endif
+			break;
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
 
-		/* Redirect full midi message (pure + velocity) to plugins. */
-		ch->receiveMidi(midiEvent.getRaw());
+void processChannels_(const MidiEvent& midiEvent)
+{
+	uint32_t pure = midiEvent.getRawNoVelocity();
+
+	refreshTable();
+
+	/* Actions can't be called on m::model::channels while locking on it: 
+	collect the matching bindings first, apply them once the lock has been 
+	released. */
+
+	matches_.clear();
+
+	model::channels.lock();
+
+	auto it = table_.find(pure);
+	if (it != table_.end())
+		for (const Binding& b : it->second)
+			if (isBound_(b, pure, midiEvent.getChannel()))
+				matches_.push_back(b);
+
+	/* Redirect full midi message (pure + velocity) to MIDI channels, keeping 
+	its frame offset. */
+
+	for (ID id : midiChannels_) {
+		auto ch = model::channels.find(id);
+		if (ch != model::channels.end() && (*ch)->midiIn && 
+		    (*ch)->isMidiInAllowed(midiEvent.getChannel()))
+			(*ch)->receiveMidi(midiEvent);
 	}
+
 	model::channels.unlock();
 
-	/* Apply all the collected actions. */
-	for (auto& action : actions)
-		action();
+	for (const Binding& b : matches_)
+		apply_(b, midiEvent);
 }
 
 
@@ -283,7 +457,28 @@ void stopMidiLearn()
 /* -------------------------------------------------------------------------- */
 
 
-void dispatch(int byte1, int byte2, int byte3)
+void invalidate()
+{
+	dirty_.store(true);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool refreshTable()
+{
+	if (!isTableStale_())
+		return false;
+	rebuildTable_();
+	return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void dispatch(int byte1, int byte2, int byte3, profiler::Time t)
 {
 	/* Here we want to catch two things: a) note on/note off from a keyboard and 
 	b) knob/wheel/slider movements from a controller. 
@@ -292,6 +487,7 @@ void dispatch(int byte1, int byte2, int byte3)
 
 	MidiEvent midiEvent(byte1, byte2, byte3);
 	midiEvent.fixVelocityZero();
+	midiEvent.setDelta(mixer::getInputFrame(t));
 
 	u::log::print("[midiDispatcher] MIDI received - 0x%X (chan %d)\n", midiEvent.getRaw(), 
 		midiEvent.getChannel());
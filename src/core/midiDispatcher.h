@@ -32,6 +32,7 @@
 #include <functional>
 #include <cstdint>
 #include "core/midiEvent.h"
+#include "core/profiler.h"
 
 
 namespace giada {
@@ -44,7 +45,26 @@ void startMidiLearn(cb_midiLearn* cb, void* data);*/
 void startMidiLearn(std::function<void(MidiEvent)> f);
 void stopMidiLearn();
 
-void dispatch(int byte1, int byte2, int byte3);
+/* invalidate
+Learned MIDI bindings have changed (learnt or cleared), or a channel has 
+gained new ones without being added to the model: the dispatch table will be 
+rebuilt on the next incoming message. */
+
+void invalidate();
+
+/* refreshTable
+Rebuilds the dispatch table if learned values have been invalidated or if 
+channels and plug-ins have been added or removed since the last rebuild. 
+Returns whether a rebuild took place. Called by dispatch() on each message. */
+
+bool refreshTable();
+
+/* dispatch
+Processes an incoming MIDI message, received at time 't' (from 
+profiler::now()). Events sent to channels are scheduled at the matching frame
+of the next buffer. */
+
+void dispatch(int byte1, int byte2, int byte3, profiler::Time t);
 
 void setSignalCallback(std::function<void()> f);
 }}}; // giada::m::midiDispatcher::
@@ -25,6 +25,7 @@
  * -------------------------------------------------------------------------- */
 
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include "deps/rtaudio-mod/RtAudio.h"
@@ -45,6 +46,11 @@
 #include "core/const.h"
 #include "core/audioBuffer.h"
 #include "core/action.h"
+#include "core/dsp.h"
+#include "core/workerPool.h"
+#include "core/channelTable.h"
+#include "core/rtAudit.h"
+#include "core/profiler.h"
 #include "core/mixer.h"
 
 
@@ -83,15 +89,22 @@ struct Metronome
 	bool  playBar  = false;
 	bool  playBeat = false;
 
-	void render(AudioBuffer& outBuf, bool& process, float* data, Frame f)
+	/* render
+	Renders the click currently playing, if any, in the frame range 
+	[start, start + frames). */
+
+	void render(AudioBuffer& outBuf, Frame start, Frame frames)
 	{
-		process = true;
-		for (int i=0; i<outBuf.countChannels(); i++)
-			outBuf[f][i] += data[tracker];
-		if (++tracker > Metronome::CLICK_SIZE) {
-			process = false;
-			tracker = 0;
-		}	
+		const float* data = playBar ? bar : beat;
+		for (Frame f=start; f<start + frames && (playBar || playBeat); f++) {
+			for (int i=0; i<outBuf.countChannels(); i++)
+				outBuf[f][i] += data[tracker];
+			if (++tracker >= Metronome::CLICK_SIZE) {
+				playBar  = false;
+				playBeat = false;
+				tracker  = 0;
+			}
+		}
 	}
 } metronome_;
 
@@ -118,16 +131,40 @@ std::function<void()> signalCb_ = nullptr;
 std::atomic<bool> processing_(false);
 std::atomic<bool> active_(false);
 
+/* bufferStart_, bufferSize_
+When the last audio callback has started and how many frames it had to 
+render. Used to timestamp live events. */
+
+std::atomic<profiler::Time> bufferStart_(0);
+std::atomic<Frame>          bufferSize_(0);
+
+/* workerPool_
+Threads that help the audio thread rendering channels, if enabled in the 
+configuration. */
+
+WorkerPool workerPool_;
+
+/* RenderData
+Read-only arguments shared by all render jobs in a buffer. */
+
+struct RenderData
+{
+	const ChannelTable* table;
+	const AudioBuffer*  in;
+	AudioBuffer*        inToOut;
+	bool                running;
+	bool                hasSolos;
+};
+
 
 /* -------------------------------------------------------------------------- */
 
 
 void computePeak_(const AudioBuffer& buf, std::atomic<float>& peak)
 {
-	for (int i=0; i<buf.countFrames(); i++)
-		for (int j=0; j<buf.countChannels(); j++)
-			if (buf[i][j] > peak)
-				peak = buf[i][j];
+	float p = dsp::peakAbs(buf[0], buf.countSamples());
+	if (p > peak)
+		peak = p;
 }
 
 
@@ -173,9 +210,8 @@ void processLineIn_(const AudioBuffer& inBuf)
 	model::MixerLock lock(model::mixer);
 	
 	if (model::mixer.get()->inToOut)
-		for (int i=0; i<vChanInToOut_.countFrames(); i++)
-			for (int j=0; j<vChanInToOut_.countChannels(); j++)
-				vChanInToOut_[i][j] = inBuf[i][j] * mh::getInVol();
+		dsp::copyGain(vChanInToOut_[0], inBuf[0], vChanInToOut_.countSamples(), 
+			mh::getInVol());
 }
 
 
@@ -202,24 +238,36 @@ void doQuantize_(unsigned frame)
 /* -------------------------------------------------------------------------- */
 
 
-void renderMetronome_(AudioBuffer& outBuf, Frame f)
+/* renderMetronome_
+Renders the metronome in the sub-block [start, start + frames). A new click can 
+only begin on the first frame of the sub-block, which is always the one holding
+the clock event. */
+
+void renderMetronome_(AudioBuffer& outBuf, Frame start, Frame frames)
 {
 	if (!metronome_.running)
 		return;
 
-	if (clock::isOnBar() || metronome_.playBar)
-		metronome_.render(outBuf, metronome_.playBar, metronome_.bar, f);
+	if (clock::isOnBar())
+		metronome_.playBar = true;
 	else
-	if (clock::isOnBeat() || metronome_.playBeat)
-		metronome_.render(outBuf, metronome_.playBeat, metronome_.beat, f);
+	if (clock::isOnBeat())
+		metronome_.playBeat = true;
+
+	metronome_.render(outBuf, start, frames);
 }
 
 
 /* -------------------------------------------------------------------------- */
 
 
-void parseEvents_(Frame f)
+void parseEvents_(const ChannelTable& table, Frame f)
 {
+	/* Actions are read straight from the timeline: keep it alive until all 
+	channels are done. */
+
+	model::ActionsLock actionsLock(model::actions);
+
 	mixer::FrameEvents fe = {
 		.frameLocal   = f,
 		.frameGlobal  = clock::getCurrentFrame(),
@@ -230,34 +278,92 @@ void parseEvents_(Frame f)
 		.actions      = recorder::getActionsOnFrame(clock::getCurrentFrame()),
 	};
 
-	model::ChannelsLock lock(model::channels);
-
 	/* TODO - channel->parseEvents alters things in Channel (i.e. it's mutable).
 	Refactoring needed ASAP. */
 
-	for (Channel* ch : model::channels)
-		ch->parseEvents(fe); 
+	for (size_t i=0; i<table.size(); i++)
+		if (!table.idle[i])
+			table.channel[i]->parseEvents(fe);
 }
 
 
 /* -------------------------------------------------------------------------- */
 
+/* isSilent_
+Tells whether a rendered channel left its output buffer silent, so that there
+is no need to mix it. Preview is mixed straight into the output buffer, 
+regardless of the channel state. Muted Sample channels skip mixing, while MIDI 
+ones are silenced by their plug-ins. */
 
-void render_(AudioBuffer& out, const AudioBuffer& in, AudioBuffer& inToOut)
+bool isSilent_(const Channel& ch, bool hasSolos)
 {
-	bool running = clock::isRunning();
+	if (ch.isPreview())
+		return false;
+	if ((hasSolos && !ch.solo) || ch.volume == 0.0f)
+		return true;
+	return ch.type == ChannelType::SAMPLE && ch.mute;
+}
 
-	model::ChannelsLock lock(model::channels);
 
+/* -------------------------------------------------------------------------- */
+
+/* renderChannel_
+Renders the channel in table slot 'i' into its own output buffer. Channels 
+don't share any state while rendering, so this can run on any thread. */
+
+void renderChannel_(size_t i, const RenderData& d)
+{
 	/* TODO - channel->render alters things in Channel (i.e. it's mutable).
 	Refactoring needed ASAP. */
 
-	for (const Channel* ch : model::channels) {
-		if (ch == nullptr ||
-			ch->id == mixer::MASTER_OUT_CHANNEL_ID ||
-			ch->id == mixer::MASTER_IN_CHANNEL_ID)
-			continue;
-		const_cast<Channel*>(ch)->render(out, in, inToOut, isChannelAudible(ch), running);
+	profiler::Time t  = profiler::now();
+	Channel*       ch = d.table->channel[i];
+
+	ch->bufferOut.clear();
+	ch->render(ch->bufferOut, *d.in, *d.inToOut, !d.hasSolos || ch->solo, d.running);
+
+	profiler::addChannel(d.table->id[i], t);
+}
+
+
+void renderJob_(size_t i, void* data)
+{
+	const RenderData& d = *static_cast<RenderData*>(data);
+#ifdef WITH_RT_AUDIT
+	rtAudit::enter();
+#endif
+	renderChannel_(d.table->render[i], d);
+#ifdef WITH_RT_AUDIT
+	rtAudit::leave();
+#endif
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* render_
+Channels are rendered into their own buffers, possibly in parallel, then summed
+into the output buffer in the channel list order. The summing order never 
+changes, so the result is the same with or without worker threads. Silent 
+buffers are not summed at all. */
+
+void render_(const ChannelTable& table, AudioBuffer& out, const AudioBuffer& in, 
+	AudioBuffer& inToOut)
+{
+	bool hasSolos;
+	{
+		model::MixerLock l(model::mixer);
+		hasSolos = model::mixer.get()->hasSolos;
+	}
+
+	RenderData data = { &table, &in, &inToOut, clock::isRunning(), hasSolos };
+
+	workerPool_.run(table.render.size(), renderJob_, &data);
+
+	for (size_t i : table.render) {
+		const Channel* ch = table.channel[i];
+		if (!isSilent_(*ch, hasSolos))
+			dsp::addGain(out[0], ch->bufferOut[0], out.countSamples(), 1.0f);
 	}
 
 	assert(model::channels.size() >= 3); // Preview channel included
@@ -265,24 +371,60 @@ void render_(AudioBuffer& out, const AudioBuffer& in, AudioBuffer& inToOut)
 	/* Master channels are processed at the end, when the buffers have already 
 	been filled. */
 	
+	profiler::Time t = profiler::now();
 	model::get(model::channels, mixer::MASTER_OUT_CHANNEL_ID).render(out, in, inToOut, true, true);
+	profiler::addChannel(mixer::MASTER_OUT_CHANNEL_ID, t);
+
+	t = profiler::now();
 	model::get(model::channels, mixer::MASTER_IN_CHANNEL_ID).render(out, in, inToOut, true, true);
+	profiler::addChannel(mixer::MASTER_IN_CHANNEL_ID, t);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* getFramesToNextEvent_
+Returns the length of the sub-block starting from the current frame, i.e. how 
+many frames are left before the next clock event or recorded action, up to 
+'max'. */
+
+Frame getFramesToNextEvent_(Frame max)
+{
+	Frame next = clock::getFramesToNextEvent(max);
+
+	if (clock::isRunning()) {
+		Frame curr   = clock::getCurrentFrame();
+		Frame action = recorder::getNextActionFrame(curr);
+		if (action != -1)
+			next = std::min(next, action - curr);
+	}
+	return next;
 }
 
 
 /* -------------------------------------------------------------------------- */
 
+/* processSequencer_
+Sequencer events (bars, beats, quantizer steps, recorded actions, MIDI sync) 
+are sparse, so the buffer is split into sub-blocks, each one starting on an 
+event. Events are parsed once per sub-block, then the clock jumps straight to 
+the next one. */
 
-void processSequencer_(AudioBuffer& out, const AudioBuffer& in)
+void processSequencer_(const ChannelTable& table, AudioBuffer& out, 
+	const AudioBuffer& in)
 {
-	for (int j=0; j<out.countFrames(); j++) {
+	Frame f = 0;
+	while (f < out.countFrames()) {
 		if (clock::isRunning()) {
-			parseEvents_(j);
-			doQuantize_(j);
+			parseEvents_(table, f);
+			doQuantize_(f);
 		}
-		clock::sendMIDIsync();
-		clock::incrCurrentFrame();
-		renderMetronome_(out, j);
+		clock::sendMIDIsync(getOutputTime(f));
+		Frame frames = getFramesToNextEvent_(out.countFrames() - f);
+		renderMetronome_(out, f, frames);
+		clock::advance(frames);
+		f += frames;
 	}
 	lineInRec_(in);
 }
@@ -309,10 +451,7 @@ void limitOutput_(AudioBuffer& outBuf)
 {
 	if (!conf::limitOutput)
 		return;
-	for (int i=0; i<outBuf.countFrames(); i++)
-		for (int j=0; j<outBuf.countChannels(); j++)
-			if      (outBuf[i][j] > 1.0f)  outBuf[i][j] = 1.0f;
-			else if (outBuf[i][j] < -1.0f) outBuf[i][j] = -1.0f;	
+	dsp::clamp(outBuf[0], outBuf.countSamples(), -1.0f, 1.0f);
 }
 
 
@@ -325,15 +464,55 @@ output volume. */
 void finalizeOutput_(AudioBuffer& outBuf)
 {
 	model::MixerLock lock(model::mixer);
-	
-	//printf("%f\n", mh::getOutVol());
 
-	for (int i=0; i<outBuf.countFrames(); i++)
-		for (int j=0; j<outBuf.countChannels(); j++) {
-			if (model::mixer.get()->inToOut) // Merge vChanInToOut_, if enabled
-				outBuf[i][j] += vChanInToOut_[i][j];
-			outBuf[i][j] *= mh::getOutVol(); 
-		}
+	if (model::mixer.get()->inToOut) // Merge vChanInToOut_, if enabled
+		dsp::addGain(outBuf[0], vChanInToOut_[0], outBuf.countSamples(), 1.0f);
+	dsp::copyGain(outBuf[0], outBuf[0], outBuf.countSamples(), mh::getOutVol());
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* process_
+The whole processing chain, shared by the audio callback and the offline
+renderer. */
+
+void process_(AudioBuffer& out, const AudioBuffer& in, bool xrun)
+{
+	profiler::Time start = profiler::beginBuffer(out.countFrames(), conf::samplerate, xrun);
+	profiler::Time t     = start;
+
+	/* Reset peak computation. */
+
+	peakOut = 0.0;
+	peakIn  = 0.0;
+
+	prepareBuffers_(out);
+	processLineIn_(in);
+	profiler::mark(profiler::Stage::LINE_IN, t);
+
+	/* Process model. The channel list stays locked until the end of the 
+	buffer, as the channel table belongs to its current snapshot. */
+
+	model::ChannelsLock lock(model::channels);
+	const ChannelTable& table = model::channels.getTable();
+
+	if (clock::isActive()) 
+		processSequencer_(table, out, in);
+	profiler::mark(profiler::Stage::SEQUENCER, t);
+
+	render_(table, out, in, vChanInToOut_);
+	profiler::mark(profiler::Stage::RENDER, t);
+
+	/* Post processing. */
+
+	finalizeOutput_(out);
+	profiler::mark(profiler::Stage::FINALIZE, t);
+
+	limitOutput_(out);
+	computePeak_(out, peakOut);
+	profiler::mark(profiler::Stage::LIMIT, t);
+
+	profiler::endBuffer(start);
 }
 }; // {anonymous}
 
@@ -362,6 +541,10 @@ void init(Frame framesInSeq, Frame framesInBuffer)
 	u::log::print("[mixer::init] buffers ready - framesInSeq=%d, framesInBuffer=%d\n", 
 		framesInSeq, framesInBuffer);	
 
+	workerPool_.start(conf::renderThreads);
+
+	u::log::print("[mixer::init] render threads: %d\n", workerPool_.countWorkers());
+
 	clock::rewind();
 }
 
@@ -385,6 +568,12 @@ void disable()
 }
 
 
+bool isActive()
+{
+	return active_.load();
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 
@@ -417,6 +606,13 @@ int masterPlay(void* outBuf, void* inBuf, unsigned bufferSize,
 
 	processing_.store(true);
 
+	bufferStart_.store(profiler::now());
+	bufferSize_.store(bufferSize);
+
+#ifdef WITH_RT_AUDIT
+	rtAudit::beginBuffer();
+#endif
+
 #if defined(__linux__) || defined(__FreeBSD__)
 
 	if (kernelAudio::getAPI() == G_SYS_API_JACK)
@@ -429,33 +625,17 @@ int masterPlay(void* outBuf, void* inBuf, unsigned bufferSize,
 	if (kernelAudio::isInputEnabled())
 		in.setData((float*) inBuf, bufferSize, G_MAX_IO_CHANS);
 
-	/* Reset peak computation. */
-
-	peakOut = 0.0;
-	peakIn  = 0.0;
-
-	prepareBuffers_(out);
-	processLineIn_(in);
-
-	/* Process model. */
-
-//out[0][0] = 3.0f;
-
-	if (clock::isActive()) 
-		processSequencer_(out, in);
-	render_(out, in, vChanInToOut_);
-
-	/* Post processing. */
-
-	finalizeOutput_(out);
-	limitOutput_(out);
-	computePeak_(out, peakOut);
+	process_(out, in, status & (RTAUDIO_OUTPUT_UNDERFLOW | RTAUDIO_INPUT_OVERFLOW));
 
 	/* Unset data in buffers. If you don't do this, buffers go out of scope and
 	destroy memory allocated by RtAudio ---> havoc. */
 	out.setData(nullptr, 0, 0);
 	in.setData (nullptr, 0, 0);
 
+#ifdef WITH_RT_AUDIT
+	rtAudit::endBuffer();
+#endif
+
 	processing_.store(false);
 
 	return 0;
@@ -465,9 +645,22 @@ int masterPlay(void* outBuf, void* inBuf, unsigned bufferSize,
 /* -------------------------------------------------------------------------- */
 
 
+void renderOffline(AudioBuffer& out)
+{
+	assert(active_.load() == false);
+
+	AudioBuffer in;
+	process_(out, in, /*xrun=*/false);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void close()
 {
 	clock::setStatus(ClockStatus::STOPPED);
+	workerPool_.stop();
 }
 
 
@@ -482,6 +675,43 @@ bool isChannelAudible(const Channel* ch)
 	return !hasSolos || (hasSolos && ch->solo);
 }
 
+
+/* -------------------------------------------------------------------------- */
+
+
+Frame getInputFrame(profiler::Time t)
+{
+	return getInputFrame(t, bufferStart_.load(), bufferSize_.load());
+}
+
+
+Frame getInputFrame(profiler::Time t, profiler::Time start, Frame size)
+{
+	if (start == 0 || t <= start)
+		return 0;
+
+	Frame f = static_cast<Frame>(((t - start) * conf::samplerate) / 1000000000ull);
+	return std::min(f, size - 1);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+profiler::Time getOutputTime(Frame localFrame)
+{
+	profiler::Time start = bufferStart_.load();
+	Frame          size  = bufferSize_.load();
+
+	if (start == 0)
+		return 0;
+	return start + ((size + localFrame) * 1000000000ull) / conf::samplerate;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 bool isMetronomeOn() { return metronome_.running; }
 
 
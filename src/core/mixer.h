@@ -34,6 +34,7 @@
 #include <vector>
 #include "deps/rtaudio-mod/RtAudio.h"
 #include "core/recorder.h"
+#include "core/profiler.h"
 #include "core/types.h"
 
 
@@ -54,7 +55,7 @@ struct FrameEvents
 	bool  onBar;
 	bool  onFirstBeat;
 	bool  quantoPassed;
-	const std::vector<Action>* actions;
+	ActionRange actions;
 };
 
 constexpr int MASTER_OUT_CHANNEL_ID = 1;
@@ -75,6 +76,11 @@ called. */
 void enable();
 void disable();
 
+/* isActive
+Tells whether master callback processing is enabled. */
+
+bool isActive();
+
 /* allocVirtualInput
 Allocates new memory for the virtual input channel. Call this whenever you 
 shrink or resize the sequencer. */
@@ -100,8 +106,38 @@ Core method (callback) */
 int masterPlay(void* outBuf, void* inBuf, unsigned bufferSize, double streamTime,
 	RtAudioStreamStatus status, void* userData);
 
+/* renderOffline
+Runs one cycle of the same processing chain of masterPlay() on buffer 'out',
+outside the audio callback. The buffer must be as large as the kernelAudio
+buffer. Call disable() first, so that the two never run at the same time. */
+
+void renderOffline(AudioBuffer& out);
+
 bool isChannelAudible(const Channel* ch);
 
+/* getInputFrame
+Converts the time 't' (from profiler::now()) a live event, e.g. a MIDI message,
+has been received at into a frame offset in the next buffer. Live events are 
+delayed by one buffer and keep the same distance from the buffer start they
+had when received: a constant latency instead of up to one buffer of jitter. 
+Thread-safe. */
+
+Frame getInputFrame(profiler::Time t);
+
+/* getInputFrame (2)
+Same as above, against a buffer that has started at time 'start' and is 'size'
+frames long. A zero 'start' means no buffer has been rendered yet. */
+
+Frame getInputFrame(profiler::Time t, profiler::Time start, Frame size);
+
+/* getOutputTime
+Returns when frame 'localFrame' of the buffer being rendered will be played,
+i.e. one buffer after the audio callback has started, as a profiler::now() 
+time. Used to schedule outgoing MIDI. Returns 0 (as soon as possible) if the
+audio callback never ran. */
+
+profiler::Time getOutputTime(Frame localFrame);
+
 /* startInputRec, stopInputRec
 Starts/stops input recording on frame clock::getCurrentFrame(). */
 
@@ -57,6 +57,8 @@
 #include "core/midiMapConf.h"
 #include "core/wave.h"
 #include "core/waveManager.h"
+#include "core/waveStream.h"
+#include "core/profiler.h"
 #include "core/mixerHandler.h"
 
 
@@ -85,17 +87,9 @@ std::unique_ptr<Channel> createChannel_(ChannelType type, ID columnId, ID channe
 
 waveManager::Result createWave_(const std::string& fname)
 {
-	waveManager::Result res = waveManager::createFromFile(fname); 
-	if (res.status != G_RES_OK)
-		return res;
-	if (res.wave->getRate() != conf::samplerate) {
-		u::log::print("[mh::createWave_] input rate (%d) != system rate (%d), conversion needed\n",
-			res.wave->getRate(), conf::samplerate);
-		res.status = waveManager::resample(*res.wave.get(), conf::rsmpQuality, conf::samplerate); 
-		if (res.status != G_RES_OK)
-			return res;
-	}
-	return res;
+	/* Sample rate conversion, if needed, takes place in there. */
+
+	return waveManager::createFromFile(fname); 
 }
 
 
@@ -165,6 +159,7 @@ void close()
 	mixer::disable();
 	model::channels.clear();
 	model::waves.clear();
+	profiler::reset();
 	mixer::close();
 }
 
@@ -265,7 +260,15 @@ void cloneChannel(ID channelId)
 	if (newChannel->hasData()) {
 		SampleChannel* sch  = static_cast<SampleChannel*>(newChannel.get());
 		Wave&          wave = model::get(model::waves, sch->waveId);
-		pushWave_(*sch, waveManager::createFromWave(wave, 0, wave.getSize()), /*clone=*/true);
+		if (wave.isStreamed()) {
+			waveManager::Result res = createWave_(wave.getStream()->getPath());
+			if (res.status == G_RES_OK)
+				pushWave_(*sch, std::move(res.wave), /*clone=*/true);
+			else
+				sch->empty();
+		}
+		else
+			pushWave_(*sch, waveManager::createFromWave(wave, 0, wave.getSize()), /*clone=*/true);
 	}
 
 	/* Then push the new channel in the channels list. */
@@ -313,6 +316,37 @@ void freeAllChannels()
 /* -------------------------------------------------------------------------- */
 
 
+void makeWaveResident(ID waveId)
+{
+	bool        streamed;
+	std::string path;
+	std::string streamPath;
+	model::onGet(model::waves, waveId, [&](Wave& w)
+	{
+		streamed = w.isStreamed();
+		if (!streamed)
+			return;
+		path       = w.getPath();
+		streamPath = w.getStream()->getPath();
+	});
+
+	if (!streamed)
+		return;
+
+	waveManager::Result res = waveManager::createFromFile(streamPath, waveId, /*stream=*/false);
+	if (res.status != G_RES_OK) {
+		u::log::print("[mh::makeWaveResident] unable to load %s\n", streamPath.c_str());
+		return;
+	}
+	res.wave->setPath(path);
+
+	model::waves.swapById(std::move(res.wave), waveId);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void deleteChannel(ID channelId)
 {
 	bool            hasWave = false;
@@ -334,6 +368,7 @@ void deleteChannel(ID channelId)
 	});
 	
 	model::channels.pop(model::getIndex(model::channels, channelId));
+	profiler::removeChannel(channelId);
 
 	if (hasWave)
 		model::waves.pop(model::getIndex(model::waves, waveId)); 
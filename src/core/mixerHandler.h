@@ -88,6 +88,13 @@ void cloneChannel(ID channelId);
 void renameChannel(ID channelId, const std::string& name);
 void freeAllChannels();
 
+/* makeWaveResident
+Replaces a streamed Wave with a copy fully loaded in memory, keeping its ID. 
+Editing tools need the whole data at hand. Does nothing if the Wave is not 
+streamed. */
+
+void makeWaveResident(ID waveId);
+
 void startSequencer();
 void stopSequencer();
 void toggleSequencer();
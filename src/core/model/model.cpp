@@ -25,6 +25,7 @@
  * -------------------------------------------------------------------------- */
 
 
+#include <atomic>
 #include <cassert>
 #include "core/model/model.h"
 #ifndef NDEBUG
@@ -43,19 +44,29 @@ RCUList<Mixer>    mixer(std::make_unique<Mixer>());
 RCUList<Kernel>   kernel(std::make_unique<Kernel>());
 RCUList<Recorder> recorder(std::make_unique<Recorder>());
 RCUList<Actions>  actions(std::make_unique<Actions>());
-RCUList<Channel>  channels;
+ChannelList       channels;
 RCUList<Wave>     waves;
 #ifdef WITH_VST
 RCUList<Plugin>   plugins;
 #endif
 
 
-Actions::Actions(const Actions& o) : map(o.map)
+namespace
 {
-	/* Needs to update all pointers of prev and next actions with addresses 
-	coming from the new 'actions' map.  */
+std::atomic<uint64_t> actionsVersion_(0);
+} // {anonymous}
 
-	recorder::updateMapPointers(map);
+
+/* -------------------------------------------------------------------------- */
+
+
+Actions::Actions() : version(++actionsVersion_)
+{
+}
+
+
+Actions::Actions(const Actions& o) : timeline(o.timeline), version(++actionsVersion_)
+{
 }
 
 
@@ -117,12 +128,10 @@ void debug()
 
 	puts("model::actions");
 
-	for (auto& kv : actions.get()->map) {
-		printf("    frame: %d\n", kv.first);
-		for (const Action& a : kv.second)
-			printf("        (%p) - ID=%d, frame=%d, channel=%d, value=0x%X, prevId=%d, prev=%p, nextId=%d, next=%p\n", 
-				(void*) &a, a.id, a.frame, a.channelId, a.event.getRaw(), a.prevId, (void*) a.prev, a.nextId, (void*) a.next);	
-	}
+	printf("    version: %llu\n", (unsigned long long) actions.get()->version);
+	for (const Action& a : actions.get()->timeline)
+		printf("        (%p) - ID=%d, frame=%d, channel=%d, value=0x%X, prevId=%d, nextId=%d\n", 
+			(void*) &a, a.id, a.frame, a.channelId, a.event.getRaw(), a.prevId, a.nextId);
 	
 	puts("===============================");
 }
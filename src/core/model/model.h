@@ -30,8 +30,10 @@
 
 
 #include <algorithm>
+#include <cstdint>
 #include <type_traits>
 #include "core/channels/channel.h"
+#include "core/channelTable.h"
 #include "core/const.h"
 #include "core/wave.h"
 #include "core/plugin.h"
@@ -79,19 +81,30 @@ struct Recorder
 
 struct Actions
 {
-	Actions() = default;
+	Actions();
 	Actions(const Actions& o);
 
-	recorder::ActionMap map;
+	Timeline timeline;
+
+	/* version
+	Unique for each copy of the actions: tells the audio thread that the 
+	timeline has changed. */
+
+	uint64_t version;
 };
 
 
+/* ChannelList
+The list of channels builds a ChannelTable for each of its snapshots. */
+
+using ChannelList = RCUList<Channel, ChannelTable>;
+
 using ClockLock    = RCUList<Clock>::Lock;
 using MixerLock    = RCUList<Mixer>::Lock;
 using KernelLock   = RCUList<Kernel>::Lock;
 using RecorderLock = RCUList<Recorder>::Lock;
 using ActionsLock  = RCUList<Actions>::Lock;
-using ChannelsLock = RCUList<Channel>::Lock;
+using ChannelsLock = ChannelList::Lock;
 using WavesLock    = RCUList<Wave>::Lock;
 #ifdef WITH_VST
 using PluginsLock  = RCUList<Plugin>::Lock;
@@ -102,7 +115,7 @@ extern RCUList<Mixer>    mixer;
 extern RCUList<Kernel>   kernel;
 extern RCUList<Recorder> recorder;
 extern RCUList<Actions>  actions;
-extern RCUList<Channel>  channels;
+extern ChannelList      channels;
 extern RCUList<Wave>     waves;
 #ifdef WITH_VST
 extern RCUList<Plugin>   plugins;
@@ -130,10 +143,7 @@ template<typename L>
 auto getIter(L& list, ID id)
 {
 	static_assert(has_id<typename L::value_type>(), "This type has no ID");
-	auto it = std::find_if(list.begin(), list.end(), [&](auto* t)
-	{
-		return t->id == id;
-	});
+	auto it = list.find(id);
 	assert(it != list.end());
 	return it;
 }
@@ -147,7 +157,7 @@ size_t getIndex(L& list, ID id)
 {
 	static_assert(has_id<typename L::value_type>(), "This type has no ID");
 	typename L::Lock l(list);
-	return std::distance(list.begin(), getIter(list, id));
+	return list.getIndex(id);
 }
 
 
@@ -204,12 +214,16 @@ void onGet(L& list, std::function<void(typename L::value_type&)> f)
 /* ---------------------------------------------------------------------------*/ 
 
 
+/* onSwapByIndex_, onSwapById_
+Clone, alter and swap happen inside RCUList::update*, under the list writer 
+lock: concurrent writers (e.g. the GUI and the MIDI threads) are serialized 
+and the element is resolved only once the lock is held. */
+
 template<typename L>
 void onSwapByIndex_(L& list, size_t i, std::function<void(typename L::value_type&)> f)
 {
-	std::unique_ptr<typename L::value_type> o = list.clone(i);
-	f(*o.get());
-	list.swap(std::move(o), i);
+	using T = typename L::value_type;
+	list.update(i, [](const T& t) { return std::make_unique<T>(t); }, f);
 }
 
 /* onSwapById_ (1)
@@ -219,8 +233,11 @@ template<typename L>
 void onSwapById_(L& list, ID id, std::function<void(typename L::value_type&)> f, 
 	const std::true_type& /*is_copyable=true*/)
 {
-	static_assert(has_id<typename L::value_type>(), "This type has no ID");
-	onSwapByIndex_(list, getIndex(list, id), f); 
+	using T = typename L::value_type;
+	static_assert(has_id<T>(), "This type has no ID");
+	bool found = list.updateById(id, [](const T& t) { return std::make_unique<T>(t); }, f);
+	assert(found && "ID not found");
+	(void) found;
 }
 
 
@@ -232,17 +249,11 @@ template<typename L>
 void onSwapById_(L& list, ID id, std::function<void(typename L::value_type&)> f,
 	const std::false_type& /*is_copyable=false*/)
 {	
-	static_assert(has_id<typename L::value_type>(), "This type has no ID");
-	
-	size_t i = getIndex(list, id);
-	
-	list.lock();
-	std::unique_ptr<typename L::value_type> o(list.get(i)->clone());
-	list.unlock();
-
-	f(*o.get());
-
-	channels.swap(std::move(o), i);
+	using T = typename L::value_type;
+	static_assert(has_id<T>(), "This type has no ID");
+	bool found = list.updateById(id, [](const T& t) { return std::unique_ptr<T>(t.clone()); }, f);
+	assert(found && "ID not found");
+	(void) found;
 }
 
 
@@ -0,0 +1,199 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+
+#ifndef G_MPSC_QUEUE_H
+#define G_MPSC_QUEUE_H
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+
+namespace giada {
+namespace m
+{
+/* MpscQueue
+Bounded FIFO queue with many producers and a single consumer. Lock-free: it 
+never allocates nor takes a lock after construction, so any thread can push 
+into it, including the audio thread and the render workers. Each cell carries a
+sequence number that tells whether it's free or holds an item ready to be read.
+Items that don't fit are dropped and counted. */
+
+template<typename T>
+class MpscQueue
+{
+public:
+
+	/* MpscQueue
+	Capacity is rounded up to the next power of two. */
+
+	MpscQueue(size_t capacity)
+	: m_size   (roundUp_(capacity)),
+	  m_cells  (std::make_unique<Cell[]>(m_size)),
+	  m_head   (0), 
+	  m_tail   (0),
+	  m_dropped(0)
+	{
+		for (size_t i=0; i<m_size; i++)
+			m_cells[i].seq.store(i, std::memory_order_relaxed);
+	}
+
+	MpscQueue(const MpscQueue&) = delete;
+
+
+	/* push
+	Returns false if the queue is full. Any thread. */
+
+	bool push(const T& item)
+	{
+		return push(&item, 1) == 1;
+	}
+
+
+	/* push (bulk)
+	Pushes up to 'count' items with a single reservation, as long as they all
+	fit. Otherwise pushes them one by one until the queue is full. Returns how 
+	many items have been pushed. Any thread. */
+
+	size_t push(const T* items, size_t count)
+	{
+		if (count == 0 || insert_(items, count))
+			return count;
+
+		size_t pushed = 0;
+		if (count > 1)
+			while (pushed < count && insert_(&items[pushed], 1))
+				pushed++;
+		m_dropped.fetch_add(static_cast<uint32_t>(count - pushed), std::memory_order_relaxed);
+		return pushed;
+	}
+
+
+	/* pop
+	Returns false if the queue is empty. Consumer thread only. */
+
+	bool pop(T& item)
+	{
+		return pop(&item, 1) == 1;
+	}
+
+
+	/* pop (bulk)
+	Pops up to 'max' items into 'items'. Returns how many items have been 
+	popped. Consumer thread only. */
+
+	size_t pop(T* items, size_t max)
+	{
+		size_t pos    = m_head.load(std::memory_order_relaxed);
+		size_t popped = 0;
+		for (; popped < max; popped++, pos++) {
+			Cell& cell = cell_(pos);
+			if (cell.seq.load(std::memory_order_acquire) != pos + 1) // Empty, or still being written
+				break;
+			items[popped] = cell.item;
+			cell.seq.store(pos + m_size, std::memory_order_release);
+		}
+		m_head.store(pos, std::memory_order_relaxed);
+		return popped;
+	}
+
+
+	size_t getCapacity() const { return m_size; }
+
+	/* getDropped
+	Returns how many items didn't fit in the queue so far. Any thread. */
+
+	uint32_t getDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+
+	struct Cell
+	{
+		std::atomic<size_t> seq;
+		T                   item;
+	};
+
+	static size_t roundUp_(size_t n)
+	{
+		size_t out = 1;
+		while (out < n)
+			out <<= 1;
+		return out;
+	}
+
+	Cell& cell_(size_t pos) { return m_cells[pos & (m_size - 1)]; }
+
+
+	/* insert_
+	Reserves 'count' consecutive cells and fills them with 'items'. Returns 
+	false if there's not enough room. */
+
+	bool insert_(const T* items, size_t count)
+	{
+		if (count > m_size)
+			return false;
+
+		size_t pos = m_tail.load(std::memory_order_relaxed);
+		while (true) {
+
+			/* Cells are freed in order by the consumer: if the last one of the
+			range is free, all of them are. */
+
+			size_t   last = pos + count - 1;
+			intptr_t diff = static_cast<intptr_t>(cell_(last).seq.load(std::memory_order_acquire)) - 
+			                static_cast<intptr_t>(last);
+			if (diff == 0) {
+				if (m_tail.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+					for (size_t i=0; i<count; i++) {
+						cell_(pos + i).item = items[i];
+						cell_(pos + i).seq.store(pos + i + 1, std::memory_order_release);
+					}
+					return true;
+				}
+			}
+			else
+			if (diff < 0) // Not enough room
+				return false;
+			else
+				pos = m_tail.load(std::memory_order_relaxed);
+		}
+	}
+
+	size_t                  m_size;
+	std::unique_ptr<Cell[]> m_cells;
+	std::atomic<size_t>     m_head;
+	std::atomic<size_t>     m_tail;
+	std::atomic<uint32_t>   m_dropped;
+};
+}} // giada::m::
+
+
+#endif
@@ -43,6 +43,7 @@
 #include "core/channels/sampleChannel.h"
 #include "core/pluginManager.h"
 #include "core/waveManager.h"
+#include "core/waveLoader.h"
 #include "core/const.h"
 #include "core/kernelAudio.h"
 #include "core/clock.h"
@@ -77,6 +78,8 @@ void sanitize_(Channel& c)
 	c.volume      = um::bound(c.volume, 0.0f, G_DEFAULT_VOL);
 	c.pan         = um::bound(c.pan, 0.0f, 1.0f);
 	c.pitch       = um::bound(c.pitch, 0.1f, G_MAX_PITCH);
+	c.resampler   = static_cast<ResamplerQuality>(um::bound(static_cast<int>(c.resampler), 
+		static_cast<int>(ResamplerQuality::LINEAR), static_cast<int>(ResamplerQuality::SINC)));
 	c.midiOutChan = um::bound(c.midiOutChan, 0, G_MAX_MIDI_CHANS - 1);
 }
 
@@ -106,8 +109,10 @@ void readColumns_(json_t* j)
 {
 	namespace uj = u::json;
 
+	/* Columns only exist in the UI: nothing to do when running headless. */
+
 	json_t* jcs = json_object_get(j, PATCH_KEY_COLUMNS);
-	if (jcs == nullptr)
+	if (jcs == nullptr || G_MainWin == nullptr)
 		return;
 	
 	G_MainWin->keyboard->deleteAllColumns();
@@ -187,13 +192,15 @@ void readPlugins_(json_t* j)
 /* -------------------------------------------------------------------------- */
 
 
-void readWaves_(json_t* j, const std::string& basePath)
+std::vector<Wave> readWaves_(json_t* j, const std::string& basePath)
 {
 	namespace uj = u::json;
 
+	std::vector<Wave> waves;
+
 	json_t* jws = json_object_get(j, PATCH_KEY_WAVES);
 	if (jws == nullptr)
-		return;
+		return waves;
 
 	size_t  i;
 	json_t* jw;
@@ -206,9 +213,9 @@ void readWaves_(json_t* j, const std::string& basePath)
 		w.id   = uj::readInt(jw, PATCH_KEY_WAVE_ID);
 		w.path = basePath + uj::readString(jw, PATCH_KEY_WAVE_PATH);
 
-		model::waves.push(std::move(waveManager::createFromPatch(w)));
+		waves.push_back(w);
 	}
-	return;
+	return waves;
 }
 
 
@@ -244,7 +251,7 @@ void readActions_(json_t* j)
 
 	model::onSwap(model::actions, [&](model::Actions& a)
 	{
-		a.map = std::move(recorderHandler::makeActionsFromPatch(actions));
+		a.timeline = recorderHandler::makeActionsFromPatch(actions);
 	});
 }
 
@@ -265,6 +272,19 @@ void readChannelPlugins_(json_t* j, std::vector<ID>& pluginIds)
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+/* isWaveLoaded_
+Tells whether Wave 'id' has made it to the model. Waves that failed to load 
+are not there. */
+
+bool isWaveLoaded_(ID id)
+{
+	model::WavesLock l(model::waves);
+	return model::waves.find(id) != model::waves.end();
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 
@@ -324,6 +344,7 @@ void readChannels_(json_t* j)
 			c.end               = uj::readInt  (jc, PATCH_KEY_CHANNEL_END);
 			c.readActions       = uj::readBool (jc, PATCH_KEY_CHANNEL_READ_ACTIONS);
 			c.pitch             = uj::readFloat(jc, PATCH_KEY_CHANNEL_PITCH);
+			c.resampler         = static_cast<ResamplerQuality>(uj::readInt(jc, PATCH_KEY_CHANNEL_RESAMPLER));
 			c.inputMonitor      = uj::readBool (jc, PATCH_KEY_CHANNEL_INPUT_MONITOR);
 			c.midiInVeloAsVol   = uj::readBool (jc, PATCH_KEY_CHANNEL_MIDI_IN_VELO_AS_VOL);
 			c.midiInReadActions = uj::readInt  (jc, PATCH_KEY_CHANNEL_MIDI_IN_READ_ACTIONS);
@@ -344,8 +365,19 @@ void readChannels_(json_t* j)
 			if (c.id == mixer::MASTER_IN_CHANNEL_ID)
 				model::onSwap(model::channels, mixer::MASTER_IN_CHANNEL_ID, [&](m::Channel& ch) { ch.load(c); });
 		}
-		else
-			model::channels.push(channelManager::create(c, kernelAudio::getRealBufSize()));
+		else {
+			std::unique_ptr<m::Channel> ch = channelManager::create(c, kernelAudio::getRealBufSize());
+
+			/* A channel pointing to a Wave that failed to load must not keep
+			its reference: empty it. */
+
+			if (c.type == ChannelType::SAMPLE && c.waveId != 0 && !isWaveLoaded_(c.waveId)) {
+				u::log::print("[patch::readChannels_] Wave %d not loaded, channel %d emptied\n", 
+					c.waveId, c.id);
+				ch->empty();
+			}
+			model::channels.push(std::move(ch));
+		}
 	}
 }
 
@@ -396,6 +428,9 @@ void writePlugins_(json_t* j)
 
 void writeColumns_(json_t* j)
 {
+	if (G_MainWin == nullptr) // Headless: columns only exist in the UI
+		return;
+
 	json_t* jcs = json_array();
 
 	G_MainWin->keyboard->forEachColumn([&](const v::geColumn& c)
@@ -427,17 +462,15 @@ void writeActions_(json_t* j)
 
 	json_t* jas = json_array();
 
-	for (auto& kv : model::actions.get()->map) {
-		for (m::Action& a : kv.second) {
-			json_t* ja = json_object();
-			json_object_set_new(ja, G_PATCH_KEY_ACTION_ID,      json_integer(a.id));
-			json_object_set_new(ja, G_PATCH_KEY_ACTION_CHANNEL, json_integer(a.channelId));
-			json_object_set_new(ja, G_PATCH_KEY_ACTION_FRAME,   json_integer(a.frame));
-			json_object_set_new(ja, G_PATCH_KEY_ACTION_EVENT,   json_integer(a.event.getRaw()));
-			json_object_set_new(ja, G_PATCH_KEY_ACTION_PREV,    json_integer(a.prevId));
-			json_object_set_new(ja, G_PATCH_KEY_ACTION_NEXT,    json_integer(a.nextId));
-			json_array_append_new(jas, ja);
-		}
+	for (const m::Action& a : model::actions.get()->timeline) {
+		json_t* ja = json_object();
+		json_object_set_new(ja, G_PATCH_KEY_ACTION_ID,      json_integer(a.id));
+		json_object_set_new(ja, G_PATCH_KEY_ACTION_CHANNEL, json_integer(a.channelId));
+		json_object_set_new(ja, G_PATCH_KEY_ACTION_FRAME,   json_integer(a.frame));
+		json_object_set_new(ja, G_PATCH_KEY_ACTION_EVENT,   json_integer(a.event.getRaw()));
+		json_object_set_new(ja, G_PATCH_KEY_ACTION_PREV,    json_integer(a.prevId));
+		json_object_set_new(ja, G_PATCH_KEY_ACTION_NEXT,    json_integer(a.nextId));
+		json_array_append_new(jas, ja);
 	}
 	json_object_set_new(j, PATCH_KEY_ACTIONS, jas);
 }
@@ -505,7 +538,7 @@ void writeChannels_(json_t* j)
 		json_object_set_new(jc, PATCH_KEY_CHANNEL_VOLUME, json_real(c->volume));
 
 		if (c->type != ChannelType::MASTER) {
-			json_object_set_new(jc, PATCH_KEY_CHANNEL_SIZE,               json_integer(G_MainWin->keyboard->getChannel(c->id)->getSize()));
+			json_object_set_new(jc, PATCH_KEY_CHANNEL_SIZE,               json_integer(G_MainWin != nullptr ? G_MainWin->keyboard->getChannel(c->id)->getSize() : G_GUI_CHANNEL_H_1));
 			json_object_set_new(jc, PATCH_KEY_CHANNEL_NAME,               json_string(c->name.c_str()));
 			json_object_set_new(jc, PATCH_KEY_CHANNEL_COLUMN,             json_integer(c->columnId));
 			json_object_set_new(jc, PATCH_KEY_CHANNEL_MUTE,               json_integer(c->mute));
@@ -545,6 +578,7 @@ void writeChannels_(json_t* j)
 			json_object_set_new(jc, PATCH_KEY_CHANNEL_END,                  json_integer(sc->end));
 			json_object_set_new(jc, PATCH_KEY_CHANNEL_READ_ACTIONS,         json_boolean(sc->readActions));
 			json_object_set_new(jc, PATCH_KEY_CHANNEL_PITCH,                json_real(sc->pitch));
+			json_object_set_new(jc, PATCH_KEY_CHANNEL_RESAMPLER,            json_integer(static_cast<int>(sc->resampler.getQuality())));
 			json_object_set_new(jc, PATCH_KEY_CHANNEL_INPUT_MONITOR,        json_boolean(sc->inputMonitor));
 			json_object_set_new(jc, PATCH_KEY_CHANNEL_MIDI_IN_VELO_AS_VOL,  json_boolean(sc->midiInVeloAsVol));
 			json_object_set_new(jc, PATCH_KEY_CHANNEL_MIDI_IN_READ_ACTIONS, json_integer(sc->midiInReadActions.load()));
@@ -656,7 +690,8 @@ bool write(const std::string& name, const std::string& file, bool isProject)
 /* -------------------------------------------------------------------------- */
 
 
-int read(const std::string& file, const std::string& basePath)
+int read(const std::string& file, const std::string& basePath, 
+	std::function<void(float)> progress)
 {
 	namespace uj = u::json;
 
@@ -667,10 +702,15 @@ int read(const std::string& file, const std::string& basePath)
 	init();
 	readCommons_(j);
 	readColumns_(j);
+
+	/* Waves are decoded in background while plug-ins are being instantiated 
+	here. All Waves then go live in one go. */
+
+	WaveLoader loader(readWaves_(j, basePath), conf::loadThreads);
 #ifdef WITH_VST
 	readPlugins_(j);
 #endif
-	readWaves_(j, basePath);
+	model::waves.push(loader.wait(progress));
 	readActions_(j);
 	readChannels_(j);
 
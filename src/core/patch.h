@@ -29,6 +29,7 @@
 #define G_PATCH_H
 
 
+#include <functional>
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -116,6 +117,7 @@ struct Channel
 	// TODO - shift
 	bool        readActions;
 	float       pitch = G_DEFAULT_PITCH;
+	ResamplerQuality resampler = ResamplerQuality::LINEAR;
 	bool        inputMonitor;
 	bool        midiInVeloAsVol;
 	uint32_t    midiInReadActions;
@@ -145,9 +147,11 @@ int verify(const std::string& file);
 
 /* read
 Reads patch from file. Always call verify() first in order to see if the patch
-format is valid. It takes 'basePath' as parameter for Wave reading.*/
+format is valid. It takes 'basePath' as parameter for Wave reading. Waves are
+loaded in parallel: 'progress' reports how many of them are ready so far. */
 
-int read(const std::string& file, const std::string& basePath);
+int read(const std::string& file, const std::string& basePath, 
+	std::function<void(float)> progress=nullptr);
 
 /* write
 Writes patch to file. */
@@ -225,8 +225,16 @@ void Plugin::process(juce::AudioBuffer<float>& out, juce::MidiBuffer m)
 
 	const bool isInstrument = m_plugin->acceptsMidi();
 
+	/* 'out' might be a sub-block of the buffer when parameters are automated:
+	resize without reallocating, m_buffer is already big enough. */
+
+	m_buffer.setSize(out.getNumChannels(), out.getNumSamples(), 
+		/*keepExistingContent=*/false, /*clearExtraSpace=*/false, 
+		/*avoidReallocating=*/true);
+
 	if (!isInstrument)
-		m_buffer = out;
+		for (int i=0; i<out.getNumChannels(); i++)
+			m_buffer.copyFrom(i, 0, out, i, 0, out.getNumSamples());
 	else
 		m_buffer.clear();
 
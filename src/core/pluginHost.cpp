@@ -28,14 +28,17 @@
 #ifdef WITH_VST
 
 #include <cassert>
+#include <algorithm>
 #include "utils/log.h"
 #include "utils/vector.h"
 #include "core/model/model.h"
 #include "core/channels/channel.h"
 #include "core/const.h"
+#include "core/midiDispatcher.h"
 #include "core/plugin.h"
 #include "core/pluginManager.h"
 #include "core/pluginHost.h"
+#include "core/profiler.h"
 
 
 namespace giada {
@@ -45,18 +48,17 @@ namespace pluginHost
 namespace
 {
 juce::MessageManager* messageManager_;
-juce::AudioBuffer<float> audioBuffer_;
 ID pluginId_;
 
 
 /* -------------------------------------------------------------------------- */
 
 
-void giadaToJuceTempBuf_(const AudioBuffer& outBuf)
+void giadaToJuceTempBuf_(const AudioBuffer& outBuf, juce::AudioBuffer<float>& workBuf)
 {
 	for (int i=0; i<outBuf.countFrames(); i++)
 		for (int j=0; j<outBuf.countChannels(); j++)
-			audioBuffer_.setSample(j, i, outBuf[i][j]);
+			workBuf.setSample(j, i, outBuf[i][j]);
 }
 
 
@@ -64,18 +66,19 @@ void giadaToJuceTempBuf_(const AudioBuffer& outBuf)
 Converts buffer from Juce to Giada. A note for the future: if we overwrite (=) 
 (as we do now) it's SEND, if we add (+) it's INSERT. */
 
-void juceToGiadaOutBuf_(AudioBuffer& outBuf)
+void juceToGiadaOutBuf_(AudioBuffer& outBuf, const juce::AudioBuffer<float>& workBuf)
 {
 	for (int i=0; i<outBuf.countFrames(); i++)
 		for (int j=0; j<outBuf.countChannels(); j++)	
-			outBuf[i][j] = audioBuffer_.getSample(j, i);
+			outBuf[i][j] = workBuf.getSample(j, i);
 }
 
 
 /* -------------------------------------------------------------------------- */
 
 
-void processPlugins_(const std::vector<ID>& pluginIds, juce::MidiBuffer& events)
+void processPlugins_(const std::vector<ID>& pluginIds, 
+	juce::AudioBuffer<float>& workBuf, juce::MidiBuffer& events)
 {
 	model::PluginsLock l(model::plugins);
 
@@ -83,12 +86,49 @@ void processPlugins_(const std::vector<ID>& pluginIds, juce::MidiBuffer& events)
 		Plugin& p = model::get(model::plugins, id);
 		if (!p.valid || p.isSuspended() || p.isBypassed())
 			continue;
-		p.process(audioBuffer_, events);
+		profiler::Time t = profiler::now();
+		p.process(workBuf, events);
+		profiler::addPlugin(id, t);
 		events.clear();
 	}
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+/* processPluginsAutomated_
+Processes the buffer in sub-blocks, one for each distinct frame in 'changes', 
+so that plug-ins receive new parameter values right where they are due. 
+Sub-blocks are views over 'workBuf': no audio data is copied. */
+
+void processPluginsAutomated_(const std::vector<ID>& pluginIds, 
+	juce::AudioBuffer<float>& workBuf, juce::MidiBuffer& events,
+	const std::vector<ParamChange>& changes)
+{
+	const Frame frames = workBuf.getNumSamples();
+
+	Frame  start = 0;
+	size_t next  = 0;
+	while (start < frames) {
+		for (; next < changes.size() && changes[next].frame <= start; next++) {
+			model::PluginsLock l(model::plugins);
+			const ParamChange& c  = changes[next];
+			auto               it = model::plugins.find(c.pluginId);
+			if (it != model::plugins.end() && c.index >= 0 && c.index < (*it)->getNumParameters())
+				(*it)->setParameter(c.index, c.value);
+		}
+		Frame end = next < changes.size() ? std::min(changes[next].frame, frames) : frames;
+		juce::AudioBuffer<float> block(workBuf.getArrayOfWritePointers(), 
+			workBuf.getNumChannels(), start, end - start);
+		processPlugins_(pluginIds, block, events);
+		start = end;
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 ID clonePlugin_(ID pluginId)
 {
 	model::PluginsLock l(model::plugins);
@@ -122,7 +162,6 @@ void close()
 void init(int buffersize)
 {
 	messageManager_ = juce::MessageManager::getInstance();
-	audioBuffer_.setSize(G_MAX_IO_CHANS, buffersize);
 	pluginId_ = 0;
 }
 
@@ -131,9 +170,10 @@ void init(int buffersize)
 
 
 void processStack(AudioBuffer& outBuf, const std::vector<ID>& pluginIds, 
-	juce::MidiBuffer* events)
+	juce::AudioBuffer<float>& workBuf, juce::MidiBuffer* events,
+	const std::vector<ParamChange>* changes)
 {
-	assert(outBuf.countFrames() == audioBuffer_.getNumSamples());
+	assert(outBuf.countFrames() == workBuf.getNumSamples());
 
 	/* If events are null: Audio stack processing (master in, master out or
 	sample channels. No need for MIDI events. 
@@ -141,16 +181,19 @@ void processStack(AudioBuffer& outBuf, const std::vector<ID>& pluginIds,
 	process the current buffer: give them an empty and clean one. */
 	
 	if (events == nullptr) {
-		giadaToJuceTempBuf_(outBuf);
+		giadaToJuceTempBuf_(outBuf, workBuf);
 		juce::MidiBuffer events; // empty
-		processPlugins_(pluginIds, events);
+		if (changes != nullptr && !changes->empty())
+			processPluginsAutomated_(pluginIds, workBuf, events, *changes);
+		else
+			processPlugins_(pluginIds, workBuf, events);
 	}
 	else {
-		audioBuffer_.clear();
-		processPlugins_(pluginIds, *events);
+		workBuf.clear();
+		processPlugins_(pluginIds, workBuf, *events);
 
 	}
-	juceToGiadaOutBuf_(outBuf);
+	juceToGiadaOutBuf_(outBuf, workBuf);
 }
 
 
@@ -167,6 +210,11 @@ void addPlugin(std::unique_ptr<Plugin> p, ID channelId)
 	{
 		c.pluginIds.push_back(pluginId);
 	});
+
+	/* The Plugin has been pushed before being attached to the channel: a 
+	dispatch table rebuilt in between would have missed it. */
+
+	midiDispatcher::invalidate();
 }
 
 
@@ -196,13 +244,16 @@ void freePlugin(ID pluginId, ID channelId)
 	});
 
 	model::plugins.pop(model::getIndex(model::plugins, pluginId));
+	profiler::removePlugin(pluginId);
 }
 
 
 void freePlugins(const std::vector<ID>& pluginIds)
 {
-	for (ID id : pluginIds)
+	for (ID id : pluginIds) {
 		model::plugins.pop(model::getIndex(model::plugins, id));
+		profiler::removePlugin(id);
+	}
 }
 
 
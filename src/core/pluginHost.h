@@ -48,6 +48,18 @@ namespace pluginHost
 {
 using Stack = std::vector<std::shared_ptr<Plugin>>;
 
+/* ParamChange
+A new value for parameter 'index' of plug-in 'pluginId', due at frame 'frame'
+of the current buffer. */
+
+struct ParamChange
+{
+	Frame frame;
+	ID    pluginId;
+	int   index;
+	float value;
+};
+
 void init(int buffersize);
 void close();
 
@@ -57,10 +69,14 @@ Adds a new plugin to channel 'channelId'. */
 void addPlugin(std::unique_ptr<Plugin> p, ID channelId);
 
 /* processStack
-Applies the fx list to the buffer. */
+Applies the fx list to the buffer. 'workBuf' is the scratch buffer owned by the 
+calling channel: no shared state here, so that channels can be processed in 
+parallel. Parameter 'changes', sorted by frame, are applied at their exact 
+frame by splitting the buffer. */
 
 void processStack(AudioBuffer& outBuf, const std::vector<ID>& pluginIds, 
-	juce::MidiBuffer* events=nullptr);
+	juce::AudioBuffer<float>& workBuf, juce::MidiBuffer* events=nullptr,
+	const std::vector<ParamChange>* changes=nullptr);
 
 /* swapPlugin 
 Swaps plug-in with ID 1 with plug-in with ID 2 in Channel 'channelId'. */
@@ -0,0 +1,312 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include "profiler.h"
+
+
+namespace giada {
+namespace m {
+namespace profiler
+{
+namespace
+{
+constexpr int RING_SIZE   = WINDOW * 2;
+constexpr int MAX_ENTRIES = 1024; // Must be a power of two
+
+/* MAX_PROBES
+How many slots add_() checks before giving up, so that a crowded table never
+costs more than that on the audio thread. */
+
+constexpr int MAX_PROBES = 16;
+
+/* FREE, DELETED
+Special slot IDs: never claimed and released, respectively. A released slot 
+can be claimed again, but doesn't stop lookups as a free one does. */
+
+constexpr ID FREE    = 0;
+constexpr ID DELETED = -1;
+
+/* Record
+Timings of a single buffer, in nanoseconds. Atomics are there just to make 
+concurrent reads well-defined: a torn record is not a problem for statistics. */
+
+struct Record
+{
+	std::atomic<uint32_t> stages[STAGES];
+	std::atomic<uint32_t> total;
+};
+
+/* Slot
+Cell of a lock-free hash table of channels or plug-ins. A slot is claimed by
+storing its ID, and released when the channel or the plug-in is deleted. */
+
+struct Slot
+{
+	std::atomic<ID>       id;
+	std::atomic<uint64_t> time;
+	std::atomic<uint64_t> count;
+};
+
+/* ring_
+Records of the last RING_SIZE buffers. The GUI reads only the last WINDOW 
+ones, so that it never races with the record being written. */
+
+Record                ring_[RING_SIZE];
+std::atomic<uint64_t> written_(0);
+std::atomic<uint32_t> deadline_(0);
+std::atomic<uint64_t> xruns_(0);
+std::atomic<uint64_t> late_(0);
+
+Slot channels_[MAX_ENTRIES];
+Slot plugins_[MAX_ENTRIES];
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Record& getCurrent_()
+{
+	return ring_[written_.load() % RING_SIZE];
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* find_
+Returns the slot of 'id', or the first one it could claim if 'id' is not in 
+the table yet. Returns nullptr if all the MAX_PROBES slots are taken. */
+
+Slot* find_(Slot* table, ID id)
+{
+	size_t i    = static_cast<size_t>(id) & (MAX_ENTRIES - 1);
+	Slot*  free = nullptr;
+
+	for (int n = 0; n < MAX_PROBES; n++, i = (i + 1) & (MAX_ENTRIES - 1)) {
+		ID curr = table[i].id.load();
+		if (curr == id)
+			return &table[i];
+		if (curr == DELETED && free == nullptr)
+			free = &table[i];
+		if (curr == FREE)
+			return free != nullptr ? free : &table[i];
+	}
+	return free;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* add_
+Adds time to the slot of 'id', claiming a new one if needed. Silently drops
+the measurement if there is no room for 'id'. */
+
+void add_(Slot* table, ID id, Time t)
+{
+	Slot* s = find_(table, id);
+	if (s == nullptr)
+		return;
+
+	ID curr = s->id.load();
+	if (curr != id && !s->id.compare_exchange_strong(curr, id) && curr != id)
+		return;  // Claimed by another ID in the meantime
+	s->time.fetch_add(t);
+	s->count.fetch_add(1);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* remove_
+Releases the slot of 'id'. Timings are cleared first, so that the next ID 
+claiming the slot starts from zero. */
+
+void remove_(Slot* table, ID id)
+{
+	Slot* s = find_(table, id);
+	if (s == nullptr || s->id.load() != id)
+		return;
+	s->time.store(0);
+	s->count.store(0);
+	s->id.store(DELETED);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void reset_(Slot* table)
+{
+	for (int i = 0; i < MAX_ENTRIES; i++) {
+		table[i].id.store(FREE);
+		table[i].time.store(0);
+		table[i].count.store(0);
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::vector<Entry> get_(const Slot* table)
+{
+	std::vector<Entry> out;
+	for (int i = 0; i < MAX_ENTRIES; i++) {
+		ID id = table[i].id.load();
+		if (id != FREE && id != DELETED)
+			out.push_back({ id, table[i].time.load(), table[i].count.load() });
+	}
+	return out;
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+Time now()
+{
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Time beginBuffer(Frame bufferSize, int samplerate, bool xrun)
+{
+	if (xrun)
+		xruns_.fetch_add(1);
+	deadline_.store(static_cast<uint32_t>((bufferSize * 1000000000ull) / samplerate));
+
+	Record& r = getCurrent_();
+	for (std::atomic<uint32_t>& s : r.stages)
+		s.store(0);
+	r.total.store(0);
+
+	return now();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void mark(Stage s, Time& t)
+{
+	Time curr = now();
+	getCurrent_().stages[static_cast<int>(s)].fetch_add(static_cast<uint32_t>(curr - t));
+	t = curr;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void endBuffer(Time start)
+{
+	uint32_t total = static_cast<uint32_t>(now() - start);
+
+	getCurrent_().total.store(total);
+	if (total > deadline_.load())
+		late_.fetch_add(1);
+	written_.fetch_add(1);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void addChannel(ID id, Time start) { add_(channels_, id, now() - start); }
+void addPlugin(ID id, Time start)  { add_(plugins_, id, now() - start); }
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void removeChannel(ID id) { remove_(channels_, id); }
+void removePlugin(ID id)  { remove_(plugins_, id); }
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void reset()
+{
+	reset_(channels_);
+	reset_(plugins_);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Stats getStats()
+{
+	Stats    out;
+	uint64_t written = written_.load();
+	
+	out.buffers  = static_cast<int>(std::min<uint64_t>(written, WINDOW));
+	out.deadline = deadline_.load();
+	out.xruns    = xruns_.load();
+	out.late     = late_.load();
+
+	if (out.buffers == 0 || out.deadline == 0)
+		return out;
+
+	Time total = 0;
+	Time worst = 0;
+	for (uint64_t i = written - out.buffers; i < written; i++) {
+		const Record& r = ring_[i % RING_SIZE];
+		Time t = r.total.load();
+		total += t;
+		worst  = std::max(worst, t);
+		for (int s = 0; s < STAGES; s++)
+			out.stages[s] += r.stages[s].load();
+	}
+	for (Time& s : out.stages)
+		s /= out.buffers;
+
+	out.load      = (total / static_cast<float>(out.buffers)) / out.deadline;
+	out.worstLoad = worst / static_cast<float>(out.deadline);
+
+	return out;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::vector<Entry> getChannels() { return get_(channels_); }
+std::vector<Entry> getPlugins()  { return get_(plugins_); }
+}}} // giada::m::profiler::
@@ -0,0 +1,131 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#ifndef G_PROFILER_H
+#define G_PROFILER_H
+
+
+#include <cstdint>
+#include <vector>
+#include "core/types.h"
+
+
+namespace giada {
+namespace m {
+namespace profiler
+{
+/* Stage
+Steps of the audio callback. LIMIT includes the peak meter computation. */
+
+enum class Stage { LINE_IN = 0, SEQUENCER, RENDER, FINALIZE, LIMIT, COUNT };
+
+constexpr int STAGES = static_cast<int>(Stage::COUNT);
+
+/* WINDOW
+How many recent buffers are taken into account by getStats(). */
+
+constexpr int WINDOW = 256;
+
+/* Time
+Nanoseconds, from a steady clock. */
+
+using Time = uint64_t;
+
+/* Entry
+Total time spent so far by a channel or a plug-in, over 'count' buffers. */
+
+struct Entry
+{
+	ID       id;
+	Time     time;
+	uint64_t count;
+};
+
+/* Stats
+Summary of the last WINDOW buffers. Loads are the fraction of the time 
+available for a buffer actually used by the callback, i.e. > 1.0 means late. */
+
+struct Stats
+{
+	int      buffers   = 0;
+	Time     deadline  = 0;
+	float    load      = 0.0f;
+	float    worstLoad = 0.0f;
+	Time     stages[STAGES] = {};  // Average time per buffer
+	uint64_t xruns     = 0;        // Under/overflows reported by the driver
+	uint64_t late      = 0;        // Buffers that took longer than the deadline
+};
+
+Time now();
+
+/* beginBuffer
+Starts profiling a new buffer: returns the start time. Audio thread only. */
+
+Time beginBuffer(Frame bufferSize, int samplerate, bool xrun);
+
+/* mark
+Adds the time elapsed since 't' to stage 's', then moves 't' to now. Audio 
+thread only. */
+
+void mark(Stage s, Time& t);
+
+/* endBuffer
+Closes the current buffer, started at time 'start'. Audio thread only. */
+
+void endBuffer(Time start);
+
+/* addChannel, addPlugin
+Add the time elapsed since 'start' to a channel or a plug-in. Thread-safe: 
+any render thread can call them. */
+
+void addChannel(ID id, Time start);
+void addPlugin(ID id, Time start);
+
+/* removeChannel, removePlugin
+Release the slot of a deleted channel or plug-in, so that new ones can take 
+its place. */
+
+void removeChannel(ID id);
+void removePlugin(ID id);
+
+/* reset
+Forgets all channels and plug-ins. Call it while the mixer is disabled, e.g. 
+when the model is cleared on patch load or reset. */
+
+void reset();
+
+/* getStats, getChannels, getPlugins
+Lock-free readers, for the GUI thread. */
+
+Stats              getStats();
+std::vector<Entry> getChannels();
+std::vector<Entry> getPlugins();
+}}} // giada::m::profiler::
+
+
+#endif
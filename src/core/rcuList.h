@@ -29,19 +29,147 @@
 #define G_RCU_LIST_H
 
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <thread>
 #include <atomic>
 #include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "core/types.h"
 
 
 namespace giada {
 namespace m
 {
-template<typename T>
-class RCUList
+/* RCUCollectable
+Anything that holds memory the RCUReclaimer below has to free from time to 
+time. */
+
+class RCUCollectable
+{
+public:
+
+	virtual ~RCUCollectable() {};
+
+	virtual void collect() = 0;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+/* RCUReclaimer
+Background thread that periodically frees the memory retired by all RCU lists,
+so that writers never have to wait for readers. */
+
+class RCUReclaimer
+{
+public:
+
+	static RCUReclaimer& get()
+	{
+		static RCUReclaimer r;
+		return r;
+	}
+
+	void add(RCUCollectable* c)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_items.push_back(c);
+	}
+
+	void remove(RCUCollectable* c)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_items.erase(std::remove(m_items.begin(), m_items.end(), c), m_items.end());
+	}
+
+private:
+
+	RCUReclaimer() 
+	: m_running(true),
+	  m_thread ([this]() { run(); })
+	{
+	}
+
+	~RCUReclaimer()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_running = false;
+		}
+		m_cond.notify_one();
+		m_thread.join();
+	}
+
+	void run()
+	{
+		const std::chrono::milliseconds period(20);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (m_running) {
+			m_cond.wait_for(lock, period);
+			for (RCUCollectable* c : m_items)
+				c->collect();
+		}
+	}
+
+	std::vector<RCUCollectable*> m_items;
+	bool                         m_running;
+	std::mutex                   m_mutex;
+	std::condition_variable      m_cond;
+	std::thread                  m_thread;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* RCUNoTable
+Default per-snapshot table of RCUList: holds nothing. */
+
+struct RCUNoTable
+{
+	template<typename T>
+	void load(const std::vector<T*>&) {}
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+
+template<typename T, typename Table=RCUNoTable>
+class RCUList : public RCUCollectable
 {
+	/* Snapshot
+	Immutable version of the whole list. Elements are stored contiguously, so 
+	that readers scan them linearly. Writers publish a brand new snapshot on
+	each change. */
+
+	struct Snapshot
+	{
+		std::vector<T*> items;
+
+		/* index
+		Maps IDs to positions in 'items', for types that have an ID. */
+
+		std::unordered_map<ID, size_t> index;
+
+		/* table
+		Data derived from 'items', built by the writer when the snapshot is 
+		published. */
+
+		Table table;
+	};
+
 public:
 
 	/* Lock
@@ -49,7 +177,7 @@ public:
 
 	struct Lock
 	{
-		Lock(RCUList<T>& r) : rcu(r) 
+		Lock(RCUList& r) : rcu(r) 
 		{ 
 			rcu.lock(); 
 		}
@@ -59,80 +187,79 @@ public:
 			rcu.unlock();
 		}
 
-		RCUList<T>& rcu;
-	};
-
-	/* Node
-	Element of the linked list. */
-	
-	struct Node
-	{
-		std::unique_ptr<T> data;
-		std::atomic<Node*> next;
-
-		Node(std::unique_ptr<T> data, Node* next=nullptr)
-		: data(std::move(data)), 
-		  next(next) 
-		{}
+		RCUList& rcu;
 	};
 
 	/* Iterator (const)
-	This is based on simple, non-atomic pointers: you must always lock the RCU
-	list before looping over it! */
+	Walks the snapshot that was current when begin() was called, so a loop is 
+	never affected by changes made meanwhile. The end() iterator is a sentinel. 
+	Always lock the RCU list before looping over it! */
 
-	class Iterator : public std::iterator<std::forward_iterator_tag, Node*>
+	class Iterator : public std::iterator<std::forward_iterator_tag, T*>
 	{
 	public:
 
-		Iterator(Node* n) : m_curr(n) {}
+		Iterator(const Snapshot* s=nullptr, size_t i=0) : m_snapshot(s), m_i(i) {}
 
 		bool operator!= (const Iterator& o) const
 		{
-			return m_curr != o.m_curr;
+			return !(*this == o);
 		}
 
 		bool operator== (const Iterator& o) const
 		{
-			return m_curr == o.m_curr;
+			if (m_snapshot == nullptr || o.m_snapshot == nullptr)
+				return isEnd() == o.isEnd();
+			return m_i == o.m_i;
 		}
 
 		const T* operator* () const
 		{
-			return m_curr->data.get();
+			return m_snapshot->items[m_i];
 		}
 
 		// TODO - this non-const will go away with the non-virtual Channel
 		// refactoring. 
 		T* operator* ()
 		{
-			return m_curr->data.get();
+			return m_snapshot->items[m_i];
 		}
 
 		const Iterator& operator++ ()  // Prefix operator (++x)
 		{
-			if (m_curr != nullptr)
-				m_curr = m_curr->next;
+			m_i++;
 			return *this;
 		}
 	
 	private:
+
+		bool isEnd() const
+		{
+			return m_snapshot == nullptr || m_i >= m_snapshot->items.size();
+		}
 	
-		const Node* m_curr;
+		const Snapshot* m_snapshot;
+		size_t          m_i;
 	};
 
 	/* RCUList
-	Singly linked list protected by a Read-Copy-Update (RCU) mechanism. */
+	List protected by a Read-Copy-Update (RCU) mechanism, with epoch-based 
+	reclamation. Readers register themselves in the current epoch. Writers 
+	publish a new snapshot of the list right away and retire the old one (plus
+	any data removed), tagged with the current epoch: retired memory is freed 
+	later on by collect(), once all readers from that epoch are gone. Writers 
+	never wait for readers. */
 
 	RCUList()
-		: changed  (false),
-		  m_grace  (0), 
-		  m_size   (0), 
-		  m_writing(false),
-		  m_head   (nullptr),
-		  m_tail   (nullptr)
+		: changed   (false),
+		  m_epoch   (0), 
+		  m_version (0), 
+		  m_size    (0), 
+		  m_snapshot(new Snapshot())
 	{
 		m_readers[0].store(0);
 		m_readers[1].store(0);
+		RCUReclaimer::get().add(this);
 	}
 
 	RCUList(std::unique_ptr<T> data) : RCUList()
@@ -143,31 +270,55 @@ public:
 	RCUList(const RCUList&) = delete;
 	RCUList(RCUList&&)      = delete;
 
+	/* ~RCUList
+	No readers are allowed at this point: everything is deleted straight 
+	away. */
+
 	~RCUList()
 	{
-		clear();
+		RCUReclaimer::get().remove(this);
+
+		Snapshot* s = m_snapshot.load();
+		for (T* t : s->items)
+			delete t;
+		delete s;
+		for (Retired& r : m_retired)
+			r.free();
 	}
 
 	Iterator begin()
 	{ 
-		assert(m_readers[t_grace].load() > 0 && "Forgot lock before reading");
-		return Iterator(m_head.load());
+		assert(isLocked() && "Forgot lock before reading");
+		return Iterator(m_snapshot.load());
 	}
 
 	Iterator end()
 	{ 
-		assert(m_readers[t_grace].load() > 0 && "Forgot lock before reading");
-		return Iterator(nullptr);
+		assert(isLocked() && "Forgot lock before reading");
+		return Iterator();
 	}
 
-	/* unlock
-	Increases current readers count. Always call lock()/unlock() when reading
-	data from the list. Or use the scoped version Lock above. */
+	/* lock
+	Registers the calling thread as a reader of the current epoch. Always call 
+	lock()/unlock() when reading data from the list. Or use the scoped version 
+	Lock above. Nested locks from the same thread only increase a thread-local
+	counter. Never blocks: it retries only if the epoch changes while 
+	registering. */
 
 	void lock()
 	{
-		t_grace = m_grace.load();
-		m_readers[t_grace]++;
+		Reader& r = getReader();
+		if (r.depth++ > 0)
+			return;
+		while (true) {
+			std::uint64_t epoch = m_epoch.load();
+			m_readers[epoch & 1]++;
+			if (m_epoch.load() == epoch) {
+				r.grace = epoch & 1;
+				return;
+			}
+			m_readers[epoch & 1]--;
+		}
 	}
 
 	/* unlock
@@ -175,19 +326,70 @@ public:
 
 	void unlock()
 	{
-		m_readers[t_grace]--;
+		Reader& r = getReader();
+		assert(r.depth > 0);
+		if (--r.depth > 0)
+			return;
+		m_readers[r.grace]--;
+	}
+
+	/* isLocked
+	Tells whether the calling thread holds a lock on this list. */
+
+	bool isLocked() const
+	{
+		for (const Reader& r : t_readers)
+			if (r.depth > 0 && r.list == this)
+				return true;
+		return false;
 	}
 
 	/* get
-	Returns a reference to the data held by node 'i'. */
+	Returns a reference to the data held by element 'i'. */
 	// TODO - this will return a const ref with the non-virtual Channel
 	// refactoring. 
 
 	T* get(size_t i=0) const
 	{
-		assert(i < size() && "Index overflow");
-		assert(m_readers[t_grace].load() > 0 && "Forgot lock before reading");
-		return getNode(i)->data.get();
+		assert(isLocked() && "Forgot lock before reading");
+		const Snapshot* s = m_snapshot.load();
+		assert(i < s->items.size() && "Index overflow");
+		return s->items[i];
+	}
+
+	/* find
+	Returns an iterator to the element with ID 'id', or end() if not found. 
+	Constant time, through the snapshot index. Works only with types that have 
+	an 'id' member. */
+
+	Iterator find(ID id)
+	{
+		assert(isLocked() && "Forgot lock before reading");
+		const Snapshot* s  = m_snapshot.load();
+		auto            it = s->index.find(id);
+		return it == s->index.end() ? end() : Iterator(s, it->second);
+	}
+
+	/* getTable
+	Returns the table of the current snapshot. The reference stays valid as long
+	as the list is locked. Never allocates, so it is safe on the audio thread. */
+
+	const Table& getTable() const
+	{
+		assert(isLocked() && "Forgot lock before reading");
+		return m_snapshot.load()->table;
+	}
+
+	/* getIndex
+	Returns the position of the element with ID 'id'. Constant time, same
+	requirements as find() above. */
+
+	size_t getIndex(ID id) const
+	{
+		assert(isLocked() && "Forgot lock before reading");
+		const Snapshot* s = m_snapshot.load();
+		assert(s->index.count(id) > 0 && "ID not found");
+		return s->index.at(id);
 	}
 
 	/* Subscript operator []
@@ -201,18 +403,18 @@ public:
     }
 
 	/* back
-	Return data held by the last node. */
+	Return data held by the last element. */
 	// TODO - this will return a const ref with the non-virtual Channel
 	// refactoring. 
 
 	T* back() const
 	{
-		assert(m_readers[t_grace].load() > 0 && "Forgot lock before reading");
-		return m_tail.load()->data.get();
+		assert(isLocked() && "Forgot lock before reading");
+		return m_snapshot.load()->items.back();
 	}
 
 	/* clone
-	Returns a new copy of the data held by node 'i'. The template machinery
+	Returns a new copy of the data held by element 'i'. The template machinery
 	is required for when you declare a RCUList<Base> and later on want to clone
 	a derived object. Usage:
 	
@@ -222,70 +424,72 @@ public:
 	*/
 
 	template<typename C=T>
-	std::unique_ptr<C> clone(size_t i=0) const
+	std::unique_ptr<C> clone(size_t i=0)
     {
-		return std::make_unique<C>(*static_cast<C*>(getNode(i)->data.get()));
+		Lock l(*this);
+		return std::make_unique<C>(*static_cast<C*>(get(i)));
     }
 
 	/* swap
-	Exchanges data contained in node 'i' with new data 'data'. New data must
-	always come from a call to clone(). There is a natural protection against 
-	multiple calls to swap() made by the same thread: the caller is blocked by 
-	the spinlock below: no progress is made until m_readers[oldgrace] > 0. */
+	Exchanges data contained in element 'i' with new data 'data'. New data must
+	always come from a call to clone(). */
 
 	void swap(std::unique_ptr<T> data, size_t i=0)
 	{
-		/* Never start two overlapping writing sessions. */
-
-		if (m_writing.load() == true)
-			return;
-		
-		/* Begin of writing session. */
-
-		m_writing.store(true);
-
-		/* Flip the current grace bit. Now we have entered a new grace period
-		with a different number from the previous one. */
-
-		std::int8_t oldgrace = m_grace.fetch_xor(1);
-
-		/* Prepare useful node pointers: current, next and previous. Fetching
-		from the current list with getNode() is safe here: we are just reading. */
-
-		Node* curr = getNode(i);
-		Node* prev = curr == m_head.load() ? nullptr : getNode(i - 1);
-		Node* next = curr == m_tail.load() ? nullptr : getNode(i + 1);
-		
-		/* Prepare a new node holding the new data in input. */
-
-		Node* n = new Node(std::move(data), next);
-	
-		/* Make the previous node point to the new one just created. New
-		readers will read the new one from now on. The only write operation 
-		performed here is the atomic store. */
-
-		if (prev != nullptr)
-			prev->next.store(n);
-		else
-			m_head.store(n);
-
-		if (next == nullptr)
-			m_tail.store(n);
+		std::lock_guard<std::mutex> lock(m_mutex);
+		replace(i, std::move(data));
+	}
 
-		/* Wait until no readers from the previous grace period are reading the 
-		list. Avoid brutal spinlock with a tiny sleep. */
+	/* swapById
+	Same as swap() above, but the element with ID 'id' is looked up once the 
+	writer lock has been taken: a concurrent pop() can't make it replace the 
+	wrong element. Returns false if the ID is gone. Works only with types that
+	have an 'id' member. */
 
-		while (m_readers[oldgrace] > 0)
-			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	bool swapById(std::unique_ptr<T> data, ID id)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		const Snapshot* s  = m_snapshot.load();
+		auto            it = s->index.find(id);
+		if (it == s->index.end())
+			return false;
+		replace(it->second, std::move(data));
+		return true;
+	}
 
-		/* Delete old node. Node destructor makes sure data is deleted. */
+	/* update, updateById
+	Replace element 'i' (or the one with ID 'id') with a modified copy of it: 
+	'copy' makes the copy out of the current element, 'f' alters it. Lookup, 
+	copy, change and swap all happen while holding the writer lock, so that 
+	concurrent writers never lose each other's changes. Readers are never 
+	blocked. 'f' must not write to this same list. updateById returns false if
+	the ID is gone. */
 
-		delete curr;
+	void update(size_t i, const std::function<std::unique_ptr<T>(const T&)>& copy,
+		const std::function<void(T&)>& f)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
 
-		/* End of writing session. */
+		assert(i < m_snapshot.load()->items.size() && "Index overflow");
+		std::unique_ptr<T> data = copy(*m_snapshot.load()->items[i]);
+		f(*data);
+		replace(i, std::move(data));
+	}
 
-		m_writing.store(false);
-		changed.store(true);
+	bool updateById(ID id, const std::function<std::unique_ptr<T>(const T&)>& copy,
+		const std::function<void(T&)>& f)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		const Snapshot* s  = m_snapshot.load();
+		auto            it = s->index.find(id);
+		if (it == s->index.end())
+			return false;
+		std::unique_ptr<T> data = copy(*s->items[it->second]);
+		f(*data);
+		replace(it->second, std::move(data));
+		return true;
 	}
 
 	/* push
@@ -293,219 +497,255 @@ public:
 
 	void push(std::unique_ptr<T> data)
 	{
-		/* Never start two overlapping writing sessions. */
-
-		if (m_writing.load() == true)
-			return;
-
-		/* Begin of writing session. */
-
-		m_writing.store(true);	
-		
-		/* Create new node. */
-
-		Node* n = new Node(std::move(data));
-		
-		/* Update the current tail->next pointer to this node, if a tail exists.
-		I.e., grab the current last node and append it the new one. */
-
-		if (m_tail.load() != nullptr)
-			m_tail.load()->next.store(n);
-		
-		/* Update tail pointer to point to the new node. */
+		std::lock_guard<std::mutex> lock(m_mutex);
 
-		m_tail.store(n);
-
-		/* Head is null when the list is empty. If so, set head to this new
-		node too. A list with only one node has both head and tail pointing
-		to the same node. */
-
-		if (m_head.load() == nullptr)
-			m_head.store(n);
-
-		/* Upgrade static size. Last thing to do, so that other threads won't
-		read a false size. */
+		Snapshot* s = copySnapshot();
+		s->items.push_back(data.release());
+		publish(s);
+		m_version.fetch_add(1);
+	}
 
-		m_size++;
+	/* push (batch)
+	Adds many elements at once, with a single snapshot copy. */
 
-		/* End of writing session. Data has changed, set the flag. */
+	void push(std::vector<std::unique_ptr<T>> data)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
 
-		m_writing.store(false);
-		changed.store(true);
+		Snapshot* s = copySnapshot();
+		for (std::unique_ptr<T>& d : data)
+			s->items.push_back(d.release());
+		publish(s);
+		m_version.fetch_add(1);
 	}
 
 	/* pop
-	Removes the i-th element. There is a natural protection against multiple
-	calls to pop() made by the same thread: the caller is blocked by the
-	spinlock below: no progress is made while m_readers[oldgrace] > 0. */
+	Removes the i-th element. */
 
 	void pop(size_t i)
 	{
-		/* Never start two overlapping writing sessions. */
-
-		if (m_writing.load() == true)
-			return;
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		Snapshot* s = copySnapshot();
+		assert(i < s->items.size() && "Index overflow");
+		T* old = s->items[i];
+		s->items.erase(s->items.begin() + i);
+		publish(s);
+		m_version.fetch_add(1);
+		retire(nullptr, old);
+	}
 
-		/* Begin of writing session. */
+	/* clear
+	Removes all elements. */
 
-		m_writing.store(true);
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
 
-		/* Flip the current grace bit. Now we have entered a new grace period
-		with a different number from the previous one. */
+		const Snapshot* old = m_snapshot.load();
+		publish(new Snapshot());
+		m_version.fetch_add(1);
+		for (T* t : old->items)
+			retire(nullptr, t);
+	}
 
-		std::int8_t oldgrace = m_grace.fetch_xor(1);
-		
-		/* Prepare useful node pointers: current, next and previous. Fetching
-		from the current list with getNode() is safe here: we are just reading. */
+	/* collect
+	Frees retired memory no reader can reference anymore, then opens a new 
+	epoch. Never waits: if readers from the previous epoch are still around it
+	just gives up until the next call. Called periodically by the RCUReclaimer. */
 
-		Node* curr = getNode(i);
-		Node* prev = curr == m_head.load() ? nullptr : getNode(i - 1);
-		Node* next = curr == m_tail.load() ? nullptr : getNode(i + 1);
-		
-		/* Disconnect the previous node from the current one to be deleted:
-		prev->curr->next becomes prev->next, with (curr) pending in the void 
-		for the remaining readers. Special care is needed if we are removing an 
-		edge node. */
+	void collect() override
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
 
-		if (prev != nullptr)
-			prev->next.store(next);
-		else 
-			m_head.store(next);
+		/* Readers of the previous epoch are gone: whatever has been retired 
+		before the current epoch is unreachable. Readers still registering in 
+		the previous epoch will notice the epoch change below and retry. */
 
-		if (next == nullptr)
-			m_tail.store(prev);
+		std::uint64_t epoch = m_epoch.load();
+		if (m_readers[(epoch + 1) & 1].load() > 0)
+			return;
 
-		/* Size can be updated at this point. */
+		auto it = std::partition(m_retired.begin(), m_retired.end(), 
+			[epoch](const Retired& r) { return r.epoch == epoch; });
+		for (auto i = it; i != m_retired.end(); ++i)
+			i->free();
+		m_retired.erase(it, m_retired.end());
 
-		m_size--;
-		
-		/* Wait until no readers from the previous grace period are reading the 
-		list. Avoid brutal spinlock with a tiny sleep. */
+		m_epoch.store(epoch + 1);
+	}
 
-		while (m_readers[oldgrace] > 0)
-			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	/* size
+	Returns the number of elements in the list. */
 
-		/* Delete old node. Node destructor makes sure data is deleted. */
+	size_t size() const
+	{
+		return m_size.load();
+	}
 
-		delete curr;
-		
-		/* End of writing session. Data has changed, set the flag. */
+	/* getVersion
+	Returns a number that grows each time elements are added or removed with a
+	push, a pop or a clear. Swapping an existing element leaves it untouched. 
+	Unlike 'changed' it is never reset, so any number of readers can tell 
+	whether the list structure has changed since they last looked at it. */
 
-		m_writing.store(false);
-		changed.store(true);
+	std::uint64_t getVersion() const
+	{
+		return m_version.load();
 	}
 
-	/* clear
-	Removes all nodes. */
+	/* changed
+	Tells whether the list has been altered with a swap, a push or a pop. */
 
-	void clear()
-	{
-		/* Never start two overlapping writing sessions. */
+	std::atomic<bool> changed;
+	
+	/* value_type
+	A variable that holds the type of data contained in the list. Used for
+	metaprogramming stuff. */
 
-		if (m_writing.load() == true)
-			return;
+	using value_type = T;
 
-		/* Begin of writing session. */
+private:
 
-		m_writing.store(true);
+	/* Reader
+	Registration of a thread as a reader of a specific list: how many nested 
+	locks it holds and the epoch slot it sits in. */
 
-		/* Flip the current grace bit. Now we have entered a new grace period
-		with a different number from the previous one. */
+	struct Reader
+	{
+		const RCUList* list;
+		int            depth;
+		int            grace;
+	};
 
-		std::int8_t oldgrace = m_grace.fetch_xor(1);
-	
-		/* Store the first node locally. We will need it later on. */
+	/* MAX_LOCKED
+	How many lists of the same type a thread can lock at the same time. */
 
-		Node* current = m_head.load();
+	static constexpr int MAX_LOCKED = 8;
 
-		/* Block any other reader by setting the size to 0 in advance and
-		cleaning up head/tail pointers. */
+	/* Retired
+	An old snapshot or a piece of data removed from the list, still waiting for
+	the readers of its epoch to leave. */
 
-		m_size.store(0);
-		m_head.store(nullptr);
-		m_tail.store(nullptr);
+	struct Retired
+	{
+		const Snapshot* snapshot;
+		T*              data;
+		std::uint64_t   epoch;
 
-		while (current != nullptr) {
+		void free()
+		{
+			delete snapshot;
+			delete data;
+		}
+	};
 
-			/* Wait until no readers from the previous grace period are reading the 
-			list. Avoid brutal spinlock with a tiny sleep. */
+	/* copySnapshot
+	Returns a new, writable copy of the current snapshot. Call it with m_mutex 
+	locked. */
 
-			while (m_readers[oldgrace] > 0)
-				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	Snapshot* copySnapshot() const
+	{
+		return new Snapshot(*m_snapshot.load());
+	}
 
-			/* Delete old node. Node destructor makes sure data is deleted. */
+	/* getReader
+	Returns the calling thread's registration for this list, or a free one if
+	the thread holds no lock on it. Never allocates, so it is safe on the audio
+	thread. */
 
-    		Node* next = current->next;
-    		delete current;
-    		current = next;
+	Reader& getReader() const
+	{
+		Reader* free = nullptr;
+		for (Reader& r : t_readers) {
+			if (r.depth > 0 && r.list == this)
+				return r;
+			if (r.depth == 0 && free == nullptr)
+				free = &r;
 		}
+		assert(free != nullptr && "Too many lists of the same type locked at once");
+		free->list = this;
+		return *free;
+	}
 
-		/* End of writing session. Data has changed, set the flag. */
+	/* replace
+	Publishes a new snapshot where element 'i' holds 'data', and retires the 
+	old element. Call it with m_mutex locked. */
 
-		m_writing.store(false);
-		changed.store(true);
+	void replace(size_t i, std::unique_ptr<T> data)
+	{
+		Snapshot* s = copySnapshot();
+		assert(i < s->items.size() && "Index overflow");
+		T* old = s->items[i];
+		s->items[i] = data.release();
+		publish(s);
+		retire(nullptr, old);
 	}
 
-	/* size
-	Returns the number of nodes in the list. */
+	/* publish
+	Makes snapshot 's' visible to readers, once its index and table are built, 
+	and retires the current one. Call it with m_mutex locked. */
 
-	size_t size() const
+	void publish(Snapshot* s)
 	{
-		return m_size.load();
+		makeIndex(*s, 0);
+		s->table.load(s->items);
+		const Snapshot* old = m_snapshot.exchange(s);
+		m_size.store(s->items.size());
+		retire(old, nullptr);
+		changed.store(true);
 	}
 
-	/* changed
-	Tells whether the list has been altered with a swap, a push or a pop. */
+	/* makeIndex
+	Rebuilds the ID index of snapshot 's'. The second overload is picked for 
+	types without ID, where there is nothing to do. */
 
-	std::atomic<bool> changed;
-	
-	/* value_type
-	A variable that holds the type of data contained in the list. Used for
-	metaprogramming stuff. */
+	template<typename U=T>
+	auto makeIndex(Snapshot& s, int) -> decltype(std::declval<U>().id, void())
+	{
+		s.index.clear();
+		for (size_t i=0; i<s.items.size(); i++)
+			s.index[s.items[i]->id] = i;
+	}
 
-	using value_type = T;
+	void makeIndex(Snapshot& s, long) {}
 
-private:
+	/* retire
+	Schedules a snapshot or some data for deletion. Call it with m_mutex locked, 
+	after having removed the object from the list. */
 
-	Node* getNode(size_t i) const
+	void retire(const Snapshot* snapshot, T* data)
 	{
-		size_t p    = 0;
-		Node*  curr = m_head.load();
-		
-		while (curr != nullptr && p < i) {
-			p++;
-			curr = curr->next.load();
-		}
-		assert(curr != nullptr);
-		return curr;
+		m_retired.push_back({ snapshot, data, m_epoch.load() });
 	}
 
 	std::array<std::atomic<int>, 2> m_readers;
-	std::atomic<std::int8_t>        m_grace;
+	std::atomic<std::uint64_t>      m_epoch;
+	std::atomic<std::uint64_t>      m_version;
 	std::atomic<size_t>             m_size;
-	std::atomic<bool>               m_writing;
 
-	/* m_head
-	Pointer to the first node. Used when reading and writing: always update
-	this one first, as it is read by reader threads. */
+	/* m_mutex
+	Serializes writers and the collector. Never taken by readers. */
 
-	std::atomic<Node*> m_head;
+	std::mutex           m_mutex;
+	std::vector<Retired> m_retired;
 
-	/* m_tail
-	Pointer to the last node. Used only when reading: unlike m_head, updating it
-	the right time is not that critical. */
+	/* m_snapshot
+	Current version of the list, read by readers. */
 
-	std::atomic<Node*> m_tail;
+	std::atomic<Snapshot*> m_snapshot;
 
-	/* t_grace
-	Current grace flag. Each thread has its own copy of it (thread_local). */
+	/* t_readers
+	Registrations of the current thread, one for each list of type T it is 
+	currently locking. Each thread has its own copy (thread_local). */
 
-	thread_local static int t_grace;
+	thread_local static std::array<Reader, MAX_LOCKED> t_readers;
 };
 
 
-template<typename T>
-thread_local int RCUList<T>::t_grace = 0;
+template<typename T, typename Table>
+thread_local std::array<typename RCUList<T, Table>::Reader, RCUList<T, Table>::MAX_LOCKED> 
+	RCUList<T, Table>::t_readers = {};
 }} // giada::m::
 
 
@@ -27,6 +27,7 @@
 
 #include <memory>
 #include <algorithm>
+#include <cstdint>
 #include <cassert>
 #include "utils/log.h"
 #include "core/model/model.h"
@@ -44,47 +45,49 @@ namespace
 {
 IdManager actionId_;
 
+/* cursor_
+Position of the audio thread in the current timeline. 'version' tells which 
+model::Actions the position refers to: any change to the timeline invalidates 
+it. */
 
-/* -------------------------------------------------------------------------- */
-
-
-Action* findAction_(ActionMap& src, ID id)
+struct Cursor
 {
-	for (auto& kv : src)
-		for (Action& a : kv.second)
-			if (a.id == id)
-				return &a;
-	assert(false);
-	return nullptr;	
-}
+	uint64_t           version = 0;
+	Frame              frame   = -1;
+	Timeline::Position pos;
+} cursor_;
 
 
 /* -------------------------------------------------------------------------- */
 
-/* optimize
-Removes frames without actions. */
 
-void optimize_(ActionMap& map)
+void removeIf_(std::function<bool(const Action&)> f)
 {
-	for (auto it = map.cbegin(); it != map.cend();)
-		it->second.size() == 0 ? it = map.erase(it) : ++it;
+	model::onSwap(model::actions, [&](model::Actions& a)
+	{
+		a.timeline.removeIf(f);
+	});
 }
 
 
 /* -------------------------------------------------------------------------- */
 
+/* seek_
+Moves the cursor to the first action on or after frame 'f' and returns its 
+position. A binary search is needed only when the timeline has changed or the
+playhead went backwards (e.g. on rewind); otherwise the cursor just walks 
+forward. */
 
-void removeIf_(std::function<bool(const Action&)> f)
+Timeline::Position seek_(const model::Actions& as, Frame f)
 {
-	model::onSwap(model::actions, [&](model::Actions& a)
-	{
-		for (auto& kv : a.map) {
-			std::vector<Action>& as = kv.second;
-			as.erase(std::remove_if(as.begin(), as.end(), f), as.end());
-		}
-		optimize_(a.map);
-		updateMapPointers(a.map);
-	});
+	if (as.version != cursor_.version || f < cursor_.frame)
+		cursor_.pos = as.timeline.lowerBound(f);
+	else
+		cursor_.pos = as.timeline.advance(cursor_.pos, f);
+
+	cursor_.version = as.version;
+	cursor_.frame   = f;
+	return cursor_.pos;
 }
 } // {anonymous}
 
@@ -97,6 +100,7 @@ void removeIf_(std::function<bool(const Action&)> f)
 void init()
 {
 	actionId_ = IdManager();
+	cursor_   = Cursor();
 	clearAll();
 }
 
@@ -108,7 +112,7 @@ void clearAll()
 {
 	model::onSwap(model::actions, [&](model::Actions& a)
 	{
-		a.map.clear();
+		a.timeline.clear();
 	});
 }
 
@@ -154,32 +158,23 @@ void deleteAction(ID currId, ID nextId)
 
 void updateKeyFrames(std::function<Frame(Frame old)> f)
 {
-	std::unique_ptr<model::Actions> ma = model::actions.clone();
-	
-	/* Remove all existing actions: let's start from scratch. */
-
-	ma->map.clear();
-
-	/* Copy all existing actions in local data by cloning them, with just a
-	difference: they have a new frame value. */
-
+	model::onSwap(model::actions, [&](model::Actions& a)
 	{
-		model::ActionsLock lock(model::actions);
-
-		for (const auto& kv : model::actions.get()->map) {
-			Frame frame = f(kv.first);
-			for (const Action& a : kv.second) {
-				Action copy = a;
-				copy.frame = frame;
-				ma->map[frame].push_back(copy);
-			}
-			u::log::print("[recorder::updateKeyFrames] %d -> %d\n", kv.first, frame);
+		/* Give all actions a new frame value. Every action moves, so just build 
+		a new timeline: Timeline::assign() takes care of sorting, since the 
+		mapping function might not preserve the order (e.g. when frames wrap 
+		around a shorter loop). */
+
+		std::vector<Action> actions;
+		actions.reserve(a.timeline.size());
+		for (const Action& action : a.timeline) {
+			Frame frame = f(action.frame);
+			u::log::print("[recorder::updateKeyFrames] %d -> %d\n", action.frame, frame);
+			actions.push_back(action);
+			actions.back().frame = frame;
 		}
-	}
-
-	updateMapPointers(ma->map);
-
-	model::actions.swap(std::move(ma));
+		a.timeline.assign(std::move(actions));
+	});
 }
 
 
@@ -190,7 +185,8 @@ void updateEvent(ID id, MidiEvent e)
 {
 	model::onSwap(model::actions, [&](model::Actions& a)
 	{
-		findAction_(a.map, id)->event = e;
+		assert(a.timeline.find(id) != nullptr);
+		a.timeline.update(id, [&](Action& action) { action.event = e; });
 	});
 }
 
@@ -202,23 +198,15 @@ void updateSiblings(ID id, ID prevId, ID nextId)
 {
 	model::onSwap(model::actions, [&](model::Actions& a)
 	{
-		Action* pcurr = findAction_(a.map, id);
-		Action* pprev = findAction_(a.map, prevId);
-		Action* pnext = findAction_(a.map, nextId);
-
-		pcurr->prev   = pprev;
-		pcurr->prevId = pprev->id;
-		pcurr->next   = pnext;
-		pcurr->nextId = pnext->id;
-
-		if (pprev != nullptr) {
-			pprev->next   = pcurr;
-			pprev->nextId = pcurr->id;
-		}
-		if (pnext != nullptr) {
-			pnext->prev   = pcurr;
-			pnext->prevId = pcurr->id;
-		}
+		assert(a.timeline.find(id) != nullptr);
+
+		a.timeline.update(id, [&](Action& curr)
+		{
+			curr.prevId = prevId;
+			curr.nextId = nextId;
+		});
+		a.timeline.update(prevId, [&](Action& prev) { prev.nextId = id; });
+		a.timeline.update(nextId, [&](Action& next) { next.prevId = id; });
 	});
 }
 
@@ -230,10 +218,9 @@ bool hasActions(ID channelId, int type)
 {
 	model::ActionsLock lock(model::actions);
 	
-	for (const auto& kv : model::actions.get()->map)
-		for (const Action& a : kv.second)
-			if (a.channelId == channelId && (type == 0 || type == a.event.getStatus()))
-				return true;
+	for (const Action& a : model::actions.get()->timeline)
+		if (a.channelId == channelId && (type == 0 || type == a.event.getStatus()))
+			return true;
 	return false;
 }
 
@@ -262,15 +249,13 @@ Action makeAction(const patch::Action& a)
 
 Action rec(ID channelId, Frame frame, MidiEvent event)
 {
+	/* No plug-in data for now. */
+
 	Action a = makeAction(0, channelId, frame, event);
 	
-	/* If key frame doesn't exist yet, the [] operator in std::map is smart 
-	enough to insert a new item first. No plug-in data for now. */
-
 	model::onSwap(model::actions, [&](model::Actions& mas)
 	{
-		mas.map[frame].push_back(a);
-		updateMapPointers(mas.map);
+		mas.timeline.insert(a);
 	});
 
 	return a;
@@ -299,8 +284,7 @@ void rec(std::vector<Action>& as)
 	model::onSwap(model::actions, [&](model::Actions& mas)
 	{
 		for (const Action& a : as)
-			mas.map[a.frame].push_back(a);
-		updateMapPointers(mas.map);
+			mas.timeline.insert(a);
 	});
 }
 
@@ -310,31 +294,60 @@ void rec(std::vector<Action>& as)
 
 void rec(ID channelId, Frame f1, Frame f2, MidiEvent e1, MidiEvent e2)
 {
+	Action a1 = makeAction(0, channelId, f1, e1);
+	Action a2 = makeAction(0, channelId, f2, e2);
+	a1.nextId = a2.id;
+	a2.prevId = a1.id;
+
 	model::onSwap(model::actions, [&](model::Actions& mas)
 	{
-		mas.map[f1].push_back(makeAction(0, channelId, f1, e1));
-		mas.map[f2].push_back(makeAction(0, channelId, f2, e2));
+		mas.timeline.insert(a1);
+		mas.timeline.insert(a2);
+	});
+}
 
-		Action* a1 = findAction_(mas.map, mas.map[f1].back().id);
-		Action* a2 = findAction_(mas.map, mas.map[f2].back().id);
-		a1->nextId = a2->id;
-		a2->prevId = a1->id;
 
-		updateMapPointers(mas.map);
-	});
+/* -------------------------------------------------------------------------- */
+
+
+Action getAction(ID id)
+{
+	if (id == 0)
+		return {};
+
+	model::ActionsLock lock(model::actions);
+
+	const Action* a = model::actions.get()->timeline.find(id);
+	return a != nullptr ? *a : Action{};
 }
 
 
 /* -------------------------------------------------------------------------- */
 
 
-const std::vector<Action>* getActionsOnFrame(Frame frame)
+ActionRange getActionsOnFrame(Frame frame)
 {
 	model::ActionsLock lock(model::actions);
-	
-	if (model::actions.get()->map.count(frame) == 0)
-		return nullptr;
-	return &model::actions.get()->map.at(frame);
+
+	const model::Actions& as = *model::actions.get();
+
+	return as.timeline.getActionsOn(seek_(as, frame), frame);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Frame getNextActionFrame(Frame frame)
+{
+	model::ActionsLock lock(model::actions);
+
+	const model::Actions& as = *model::actions.get();
+
+	/* The cursor stays on the current frame: its actions have yet to be 
+	parsed. */
+
+	return as.timeline.getFrameAfter(seek_(as, frame), frame);
 }
 
 
@@ -373,28 +386,11 @@ std::vector<Action> getActionsOnChannel(ID channelId)
 /* -------------------------------------------------------------------------- */
 
 
-void updateMapPointers(ActionMap& src)
-{
-	for (auto& kv : src) {
-		for (Action& action : kv.second) {
-			if (action.nextId != 0)
-				action.next = findAction_(src, action.nextId);
-			if (action.prevId != 0)
-				action.prev = findAction_(src, action.prevId);
-		}
-	}
-}
-
-
-/* -------------------------------------------------------------------------- */
-
-
 void forEachAction(std::function<void(const Action&)> f)
 {
 	model::ActionsLock lock(model::actions);
 	
-	for (auto& kv : model::actions.get()->map)
-		for (const Action& action : kv.second)
-			f(action);
+	for (const Action& action : model::actions.get()->timeline)
+		f(action);
 }
 }}}; // giada::m::recorder::
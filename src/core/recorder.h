@@ -29,11 +29,11 @@
 #define G_RECORDER_H
 
 
-#include <map>
 #include <vector>
 #include <functional>
 #include <memory>
 #include "core/types.h"
+#include "core/timeline.h"
 #include "core/action.h"
 #include "core/patch.h"
 #include "core/midiEvent.h"
@@ -44,8 +44,6 @@ namespace m
 {
 namespace recorder
 {
-using ActionMap = std::map<Frame, std::vector<Action>>;
-
 /* init
 Initializes the recorder: everything starts from here. */
 
@@ -77,8 +75,8 @@ Deletes a specific pair of actions. Useful for composite stuff (i.e. MIDI). */
 void deleteAction(ID currId, ID nextId);
 
 /* updateKeyFrames
-Update all the key frames in the internal map of actions, according to a lambda 
-function 'f'. */
+Update all the key frames in the timeline, according to a lambda function 
+'f'. */
 
 void updateKeyFrames(std::function<Frame(Frame old)> f);
 
@@ -110,7 +108,7 @@ Records an action and returns it. Used by the Action Editor. */
 Action rec(ID channelId, Frame frame, MidiEvent e);
 
 /* rec (2)
-Transfer a vector of actions into the current ActionMap. This is called by 
+Transfer a vector of actions into the current Timeline. This is called by 
 recordHandler when a live session is over and consolidation is required. */
 
 void rec(std::vector<Action>& actions);
@@ -123,15 +121,29 @@ void rec(ID channelId, Frame f1, Frame f2, MidiEvent e1, MidiEvent e2);
 
 /* forEachAction
 Applies a read-only callback on each action recorded. NEVER do anything inside 
-the callback that might alter the ActionMap. */
+the callback that might alter the Timeline. */
 
 void forEachAction(std::function<void(const Action&)> f);
 
+/* getAction
+Returns a copy of the action with ID 'id', or an invalid action if not found. 
+Use this to follow the prevId/nextId links of an action. */
+
+Action getAction(ID id);
+
 /* getActionsOnFrame
-Returns a pointer to a vector of actions recorded on frame 'f', or nullptr if
-the frame has no actions. */
+Returns the actions recorded on frame 'f', if any. The range points into the 
+current Timeline: keep model::actions locked while using it. The audio thread 
+walks the timeline with an internal cursor, so consecutive calls with growing 
+frames cost nothing but the actions in between. Audio thread only. */
+
+ActionRange getActionsOnFrame(Frame f);
 
-const std::vector<Action>* getActionsOnFrame(Frame f);
+/* getNextActionFrame
+Returns the first frame after 'f' that holds some actions, or -1 if there are
+no more actions ahead. Same cursor as getActionsOnFrame() above. */
+
+Frame getNextActionFrame(Frame f);
 
 /* getActionsOnChannel
 Returns a vector of actions belonging to channel 'ch'. */
@@ -142,14 +154,6 @@ std::vector<Action> getActionsOnChannel(ID channelId);
 Given a frame 'f' returns the closest action. */
 
 Action getClosestAction(ID channelId, Frame f, int type);
-
-/* updateMapPointers
-Updates all prev/next actions pointers into the action map. This is required
-after an action has been recorded, since pushing back new actions in a Action 
-vector makes it reallocating the existing ones. Also needed in model::Data copy
-constructor. */
-
-void updateMapPointers(ActionMap& src); 
 }}}; // giada::m::recorder::
 
 
@@ -53,19 +53,6 @@ std::vector<Action> recs_;
 /* -------------------------------------------------------------------------- */
 
 
-const Action* getActionPtrById_(int id, const recorder::ActionMap& source)
-{
-	for (auto& kv : source)
-		for (const Action& action : kv.second)
-			if (action.id == id)
-				return &action;
-	return nullptr;
-}
-
-
-/* -------------------------------------------------------------------------- */
-
-
 /* areComposite_
 Composite: NOTE_ON + NOTE_OFF on the same note. */
 
@@ -132,9 +119,12 @@ void init()
 
 bool isBoundaryEnvelopeAction(const Action& a)
 {
-	assert(a.prev != nullptr);
-	assert(a.next != nullptr);
-	return a.prev->frame > a.frame || a.next->frame < a.frame;
+	const Action prev = recorder::getAction(a.prevId);
+	const Action next = recorder::getAction(a.nextId);
+
+	assert(prev.isValid());
+	assert(next.isValid());
+	return prev.frame > a.frame || next.frame < a.frame;
 }
 
 
@@ -207,8 +197,16 @@ void liveRec(ID channelId, MidiEvent e)
 
 	if (recs_.size() >= recs_.capacity())
 		recs_.reserve(recs_.size() + MAX_LIVE_RECS_CHUNK);
+
+	/* Live events carry their offset in the next buffer: record them where 
+	they will actually be heard. */
+
+	Frame frame = clock::getCurrentFrame() + e.getDelta();
+	if (clock::getFramesInLoop() > 0)
+		frame %= clock::getFramesInLoop();
+	e.setDelta(0);
 	
-	recs_.push_back(recorder::makeAction(-1, channelId, clock::getCurrentFrame(), e));
+	recs_.push_back(recorder::makeAction(-1, channelId, frame, e));
 }
 
 
@@ -243,34 +241,18 @@ void clearAllActions()
 /* -------------------------------------------------------------------------- */
 
 
-recorder::ActionMap makeActionsFromPatch(const std::vector<patch::Action>& pactions)
+Timeline makeActionsFromPatch(const std::vector<patch::Action>& pactions)
 {
-	recorder::ActionMap out;
-
-	/* First pass: add actions with no relationship, that is with no prev/next
-	pointers filled in. */
+	/* Previous and next actions are linked by ID, already stored in the patch:
+	nothing to resolve here. */
 
+	std::vector<Action> actions;
+	actions.reserve(pactions.size());
 	for (const patch::Action& paction : pactions)
-		out[paction.frame].push_back(recorder::makeAction(paction));
-
-	/* Second pass: fill in previous and next actions, if any. Is this the
-	fastest/smartest way to do it? Maybe not. Optimizations are welcome. */
-
-	for (const patch::Action& paction : pactions) {
-		if (paction.nextId == 0 && paction.prevId == 0) 
-			continue;
-		Action* curr = const_cast<Action*>(getActionPtrById_(paction.id, out));
-		assert(curr != nullptr);
-		if (paction.nextId != 0) {
-			curr->next = getActionPtrById_(paction.nextId, out);
-			assert(curr->next != nullptr);
-		}
-		if (paction.prevId != 0) {
-			curr->prev = getActionPtrById_(paction.prevId, out);
-			assert(curr->prev != nullptr);
-		}
-	}
+		actions.push_back(recorder::makeAction(paction));
 
+	Timeline out;
+	out.assign(std::move(actions));
 	return out;
 }
 }}}; // giada::m::recorderHandler::
@@ -66,7 +66,8 @@ whether any action has been cloned. */
 bool cloneActions(ID channelId, ID newChannelId);
 
 /* liveRec
-Records a user-generated action. NOTE_ON or NOTE_OFF only for now. */
+Records a user-generated action. NOTE_ON or NOTE_OFF only for now. The event
+delta, if any, is its frame offset from the current frame. */
 
 void liveRec(ID channelId, MidiEvent e);
 
@@ -81,7 +82,7 @@ Deletes all recorded actions. */
 
 void clearAllActions();
 
-recorder::ActionMap makeActionsFromPatch(const std::vector<patch::Action>& pactions);
+Timeline makeActionsFromPatch(const std::vector<patch::Action>& pactions);
 
 }}}; // giada::m::recorderHandler::
 
@@ -0,0 +1,228 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <cassert>
+#include <vector>
+#include <algorithm>
+#include <sndfile.h>
+#include "utils/log.h"
+#include "utils/string.h"
+#include "core/model/model.h"
+#include "core/channels/channel.h"
+#include "core/audioBuffer.h"
+#include "core/mixerHandler.h"
+#include "core/mixer.h"
+#include "core/kernelAudio.h"
+#include "core/clock.h"
+#include "core/conf.h"
+#include "core/diskReader.h"
+#include "core/const.h"
+#include "renderer.h"
+
+
+namespace giada {
+namespace m {
+namespace renderer
+{
+namespace
+{
+struct Stem
+{
+	ID       channelId;
+	SNDFILE* file;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+
+SNDFILE* open_(const std::string& path)
+{
+	SF_INFO header;
+	header.samplerate = conf::samplerate;
+	header.channels   = G_MAX_IO_CHANS;
+	header.format     = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+
+	SNDFILE* file = sf_open(path.c_str(), SFM_WRITE, &header);
+	if (file == nullptr)
+		u::log::print("[renderer::open_] unable to open %s: %s\n", path.c_str(), 
+			sf_strerror(file));
+	return file;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* openStems_
+Opens one file for each Sample and MIDI channel, named after the channel. Stems 
+are taken from the channels' output buffers, i.e. before the master bus. */
+
+bool openStems_(const std::string& dir, std::vector<Stem>& stems)
+{
+	model::ChannelsLock lock(model::channels);
+
+	for (const Channel* ch : model::channels) {
+		if (ch->type != ChannelType::SAMPLE && ch->type != ChannelType::MIDI)
+			continue;
+		std::string name = u::string::replace(ch->name, std::string(1, G_SLASH), "_");
+		std::string path = dir + G_SLASH + u::string::iToString(ch->id) + 
+			(name.empty() ? "" : "-" + name) + ".wav";
+		SNDFILE* file = open_(path);
+		if (file == nullptr)
+			return false;
+		stems.push_back({ ch->id, file });
+	}
+	return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void writeStems_(const std::vector<Stem>& stems, Frame frames)
+{
+	model::ChannelsLock lock(model::channels);
+
+	for (const Stem& s : stems)
+		sf_writef_float(s.file, model::get(model::channels, s.channelId).bufferOut[0], frames);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void close_(SNDFILE* master, const std::vector<Stem>& stems)
+{
+	if (master != nullptr)
+		sf_close(master);
+	for (const Stem& s : stems)
+		sf_close(s.file);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* stop_
+Same as mh::stopSequencer(), minus JACK transport and recordings that can't be 
+active during a render. */
+
+void stop_()
+{
+	clock::setStatus(ClockStatus::STOPPED);
+	clock::rewind();
+
+	model::channels.lock();
+	for (Channel* c : model::channels)
+		c->stopBySeq(conf::chansStopOnSeqHalt);
+	model::channels.unlock();
+
+	mh::rewindChannels();
+}
+}; // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+int render(const Options& o, std::function<void(float)> progress)
+{
+	assert(o.frames > 0);
+
+	Frame bufferSize = kernelAudio::getRealBufSize();
+	assert(bufferSize > 0);
+
+	SNDFILE* master = open_(o.path);
+	std::vector<Stem> stems;
+	
+	if (master == nullptr || (!o.stemsPath.empty() && !openStems_(o.stemsPath, stems))) {
+		close_(master, stems);
+		return G_RES_ERR_IO;
+	}
+
+	u::log::print("[renderer::render] rendering %d frames to %s\n", o.frames, 
+		o.path.c_str());
+
+	/* The mixer is put back in its previous state when done: it might have 
+	been disabled already, e.g. during loading or with no device open. */
+
+	bool wasActive = mixer::isActive();
+	mixer::disable();
+
+	/* No deadlines here: streamed Waves must wait for their data. */
+
+	diskReader::setBlocking(true);
+
+	clock::setStatus(ClockStatus::STOPPED);
+	clock::rewind();
+	mh::rewindChannels();
+	clock::setStatus(ClockStatus::RUNNING);
+
+	AudioBuffer out;
+	out.alloc(bufferSize, G_MAX_IO_CHANS);
+
+	int res = G_RES_OK;
+
+	/* Always process whole buffers, as channels are allocated with the 
+	kernelAudio buffer size. The tail of the last one is simply not written. */
+
+	for (Frame f = 0; f < o.frames; f += bufferSize) {
+		Frame frames = std::min(bufferSize, o.frames - f);
+		
+		mixer::renderOffline(out);
+
+		if (sf_writef_float(master, out[0], frames) != frames) {
+			u::log::print("[renderer::render] write error: %s\n", sf_strerror(master));
+			res = G_RES_ERR_IO;
+			break;
+		}
+		writeStems_(stems, frames);
+
+		if (progress != nullptr)
+			progress(static_cast<float>(f + frames) / o.frames);
+	}
+
+	stop_();
+	close_(master, stems);
+
+	diskReader::setBlocking(false);
+	if (wasActive)
+		mixer::enable();
+
+	return res;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Frame getFramesInBars(int bars)
+{
+	return clock::getFramesInBar() * bars;
+}
+}}}; // giada::m::renderer::
@@ -0,0 +1,65 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_RENDERER_H
+#define G_RENDERER_H
+
+
+#include <functional>
+#include <string>
+#include "core/types.h"
+
+
+namespace giada {
+namespace m {
+namespace renderer
+{
+struct Options
+{
+	std::string path;          // Master output file
+	std::string stemsPath;     // Directory for per-channel stems, empty = none
+	Frame       frames = 0;    // Length of the render
+};
+
+/* render
+Bounces 'o.frames' frames of the current session, from the beginning of the
+sequencer, to a 32-bit float wav file. Runs the mixer processing chain in a 
+loop on the calling thread as fast as possible, with the audio callback 
+disabled. Channels are then stopped and the sequencer rewound. The optional
+callback 'progress' receives values in [0.0, 1.0]. Returns G_RES_OK or 
+G_RES_ERR_IO. */
+
+int render(const Options& o, std::function<void(float)> progress=nullptr);
+
+/* getFramesInBars
+Length in frames of 'bars' bars with the current tempo and time signature. */
+
+Frame getFramesInBars(int bars);
+}}}; // giada::m::renderer::
+
+
+#endif
@@ -0,0 +1,305 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <cassert>
+#include <cmath>
+#include "core/const.h"
+#include "core/dsp.h"
+#include "resampler.h"
+
+
+namespace giada {
+namespace m 
+{
+namespace
+{
+constexpr int    HALF     = 8;              // Sinc zero crossings per side
+constexpr int    TAPS     = HALF * 2;
+constexpr int    PHASES   = 512;            // Sub-frame positions in the tables
+constexpr int    MAX_TAPS = TAPS * static_cast<int>(G_MAX_PITCH);
+constexpr double CUTOFF   = 0.95;           // Relative to Nyquist
+constexpr double PI       = 3.14159265358979323846;
+
+static_assert(G_MAX_IO_CHANS == 2, "Resampler works on stereo data only");
+
+/* kernel_
+Half of the windowed-sinc impulse response, 'PHASES' points per frame. */
+
+float kernel_[HALF * PHASES + 1];
+
+/* polyphase_
+The impulse response split in PHASES + 1 normalized filters, one for each 
+sub-frame position. Each one is TAPS frames long, so that the vector loop in
+dsp::dotStereo() reads it straight from here. */
+
+float polyphase_[PHASES + 1][TAPS];
+
+
+/* -------------------------------------------------------------------------- */
+
+
+double sinc_(double x)
+{
+	return x == 0.0 ? 1.0 : std::sin(PI * x) / (PI * x);
+}
+
+
+/* blackman_
+Blackman window, 'x' in [-1.0, 1.0]. */
+
+double blackman_(double x)
+{
+	return 0.42 + 0.5 * std::cos(PI * x) + 0.08 * std::cos(2.0 * PI * x);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* makeTables_
+Tables are built at startup, so that nothing is computed or allocated on the
+audio thread. */
+
+bool makeTables_()
+{
+	for (int i = 0; i <= HALF * PHASES; i++) {
+		double y = static_cast<double>(i) / PHASES;
+		kernel_[i] = CUTOFF * sinc_(CUTOFF * y) * blackman_(y / HALF);
+	}
+	kernel_[HALF * PHASES] = 0.0f;
+
+	for (int p = 0; p <= PHASES; p++) {
+		double sum = 0.0;
+		for (int k = 0; k < TAPS; k++) {
+			double x = std::fabs(k - (HALF - 1) - static_cast<double>(p) / PHASES);
+			double c = x >= HALF ? 0.0 : CUTOFF * sinc_(CUTOFF * x) * blackman_(x / HALF);
+			polyphase_[p][k] = c;
+			sum += c;
+		}
+		for (int k = 0; k < TAPS; k++)
+			polyphase_[p][k] /= sum;
+	}
+	return true;
+}
+
+const bool tables_ = makeTables_();
+
+
+/* -------------------------------------------------------------------------- */
+
+/* getFrames_
+Returns a pointer to 'n' frames starting from 'f0'. 'in' holds 'size' frames 
+starting from 'first'. If the range goes past its boundaries, frames are copied 
+to 'tmp' and padded with silence. */
+
+const float* getFrames_(const float* in, Frame first, Frame size, Frame f0, 
+	int n, float* tmp)
+{
+	if (f0 >= first && f0 + n <= first + size)
+		return in + (f0 - first) * G_MAX_IO_CHANS;
+
+	for (int k = 0; k < n; k++) {
+		Frame f      = f0 + k - first;
+		bool  inside = f >= 0 && f < size;
+		tmp[k * 2]     = inside ? in[f * 2]     : 0.0f;
+		tmp[k * 2 + 1] = inside ? in[f * 2 + 1] : 0.0f;
+	}
+	return tmp;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* run_
+Main loop, shared by all the quality tiers. Each output frame is the dot 
+product of some input frames around the current position and a set of 
+coefficients, provided by 'coeffs' given the fractional position. Returns the
+position where it stopped, relative to 'start'. */
+
+template<typename F>
+double run_(const float* in, Frame first, Frame size, Frame start, Frame avail, 
+	float* out, Frame outFrames, float pitch, double pos, F coeffs)
+{
+	float tmp[MAX_TAPS * G_MAX_IO_CHANS];
+	float buf[MAX_TAPS];
+
+	for (Frame o = 0; o < outFrames; o++) {
+		Frame i = static_cast<Frame>(pos);
+		if (i >= avail)
+			break;
+		int          before;
+		int          n;
+		const float* c   = coeffs(static_cast<float>(pos - i), buf, before, n);
+		const float* src = getFrames_(in, first, size, start + i - before, n, tmp);
+		dsp::dotStereo(src, c, n, out + o * G_MAX_IO_CHANS);
+		pos += pitch;
+	}
+	return pos;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+const float* linear_(float t, float* buf, int& before, int& n)
+{
+	before = 0;
+	n      = 2;
+	buf[0] = 1.0f - t;
+	buf[1] = t;
+	return buf;
+}
+
+
+/* cubic_
+Catmull-Rom spline: frames i-1, i, i+1, i+2. */
+
+const float* cubic_(float t, float* buf, int& before, int& n)
+{
+	float t2 = t * t;
+	float t3 = t2 * t;
+	before = 1;
+	n      = 4;
+	buf[0] = -0.5f * t3 + t2 - 0.5f * t;
+	buf[1] =  1.5f * t3 - 2.5f * t2 + 1.0f;
+	buf[2] = -1.5f * t3 + 2.0f * t2 + 0.5f * t;
+	buf[3] =  0.5f * t3 - 0.5f * t2;
+	return buf;
+}
+
+
+const float* sincFixed_(float t, float* buf, int& before, int& n)
+{
+	before = HALF - 1;
+	n      = TAPS;
+	return polyphase_[static_cast<int>(t * PHASES + 0.5f)];
+}
+
+
+/* sincStretched_
+When reading faster than the original speed the filter must cut at the new 
+Nyquist frequency, i.e. the impulse response gets 'pitch' times longer. 
+Coefficients are interpolated from kernel_ on the fly. */
+
+const float* sincStretched_(float t, float pitch, float* buf, int& before, int& n)
+{
+	int half = static_cast<int>(std::ceil(HALF * pitch));
+	before = half - 1;
+	n      = half * 2;
+
+	float sum = 0.0f;
+	for (int k = 0; k < n; k++) {
+		float y = std::fabs(k - before - t) / pitch * PHASES;
+		int   j = static_cast<int>(y);
+		buf[k] = j >= HALF * PHASES ? 0.0f : kernel_[j] + (kernel_[j + 1] - kernel_[j]) * (y - j);
+		sum += buf[k];
+	}
+	for (int k = 0; k < n; k++)
+		buf[k] /= sum;
+	return buf;
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+constexpr Frame Resampler::MARGIN;
+
+static_assert(Resampler::MARGIN >= HALF * G_MAX_PITCH + 1, "Resampler::MARGIN too small");
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Resampler::Resampler(ResamplerQuality q)
+: m_quality(q),
+  m_frac   (0.0),
+  m_next   (-1)
+{
+	assert(tables_);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Frame Resampler::process(const float* in, Frame size, Frame start, Frame end, 
+	float* out, Frame outFrames, float pitch, Frame first)
+{
+	assert(pitch > 0.0f && pitch <= G_MAX_PITCH);
+
+	Frame  avail = end - start;
+	double pos   = start == m_next ? m_frac : 0.0;
+
+	switch (m_quality) {
+		case ResamplerQuality::LINEAR:
+			pos = run_(in, first, size, start, avail, out, outFrames, pitch, pos, linear_);
+			break;
+		case ResamplerQuality::CUBIC:
+			pos = run_(in, first, size, start, avail, out, outFrames, pitch, pos, cubic_);
+			break;
+		case ResamplerQuality::SINC:
+			if (pitch <= 1.0f)
+				pos = run_(in, first, size, start, avail, out, outFrames, pitch, pos, sincFixed_);
+			else
+				pos = run_(in, first, size, start, avail, out, outFrames, pitch, pos, 
+					[pitch](float t, float* buf, int& before, int& n)
+					{
+						return sincStretched_(t, pitch, buf, before, n);
+					});
+			break;
+	}
+
+	Frame used = static_cast<Frame>(pos);
+	if (used >= avail) {
+		used   = avail;
+		m_next = -1;
+	}
+	else {
+		m_frac = pos - used;
+		m_next = start + used;
+	}
+	return used;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+ResamplerQuality Resampler::getQuality() const
+{
+	return m_quality;
+}
+
+
+void Resampler::setQuality(ResamplerQuality q)
+{
+	m_quality = q;
+}
+}} // giada::m::
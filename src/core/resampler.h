@@ -0,0 +1,83 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_RESAMPLER_H
+#define G_RESAMPLER_H
+
+
+#include "core/types.h"
+
+
+namespace giada {
+namespace m 
+{
+/* Resampler
+Real-time pitch shifter for Sample Channels, reading straight from the Wave 
+data. Three quality tiers: LINEAR (2 points), CUBIC (4 points Hermite) and 
+SINC (windowed-sinc polyphase filter from precomputed tables, band-limited when
+pitch > 1.0). Works on interleaved stereo data and never allocates memory. */
+
+class Resampler
+{
+public:
+
+	/* MARGIN
+	How far from the current position input frames are read, at most. */
+
+	static constexpr Frame MARGIN = 33;
+
+	Resampler(ResamplerQuality q=ResamplerQuality::LINEAR);
+
+	/* process
+	Reads Wave data 'in' ('size' frames long) from frame 'start' up to 'end' at 
+	speed 'pitch', writing at most 'outFrames' frames into 'out'. Returns how 
+	many frames of 'in' have been consumed. The fractional part of the position 
+	carries over to the next call, as long as it starts where this one ended. 
+	Frames outside 'in' are read as silence. 'in' may hold just a window of the
+	Wave, starting from frame 'first': positions are absolute anyway. */
+
+	Frame process(const float* in, Frame size, Frame start, Frame end, 
+		float* out, Frame outFrames, float pitch, Frame first=0);
+
+	ResamplerQuality getQuality() const;
+	void setQuality(ResamplerQuality q);
+
+private:
+
+	ResamplerQuality m_quality;
+
+	/* m_frac, m_next
+	Fractional position left by the last call and the frame the next call is 
+	expected to start from. */
+
+	double m_frac;
+	Frame  m_next;
+};
+}} // giada::m::
+
+
+#endif
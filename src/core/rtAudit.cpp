@@ -0,0 +1,316 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#ifdef WITH_RT_AUDIT
+
+#include <atomic>
+#include <cstdlib>
+#ifndef __GLIBC__
+	#error "Real-time audit mode requires glibc"
+#endif
+#include <algorithm>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include "utils/log.h"
+#include "rtAudit.h"
+
+
+namespace giada {
+namespace m {
+namespace rtAudit
+{
+namespace
+{
+constexpr int MAX_VIOLATIONS = 1024;
+constexpr int MAX_STACK      = 24;
+
+enum class Call { MALLOC = 0, CALLOC, REALLOC, FREE, MUTEX_LOCK, COND_WAIT, 
+	WRITE, SLEEP, COUNT };
+
+const char* callNames_[] = { "malloc", "calloc", "realloc", "free", 
+	"pthread_mutex_lock", "pthread_cond_wait", "write", "nanosleep" };
+
+struct Violation
+{
+	Call     call;
+	uint64_t buffer;
+	int      depth;
+	void*    stack[MAX_STACK];
+};
+
+/* violations_
+Preallocated storage: recording a violation must not allocate, of course. 
+Violations past MAX_VIOLATIONS are counted but not stored. */
+
+Violation             violations_[MAX_VIOLATIONS];
+std::atomic<int>      countViolations_(0);
+std::atomic<int>      countCalls_[static_cast<int>(Call::COUNT)];
+std::atomic<int>      bufferViolations_(0);
+std::atomic<uint64_t> buffer_(0);
+
+/* Per-buffer stats, touched by the audio thread only. */
+
+uint64_t dirtyBuffers_ = 0;
+int      worstBuffer_  = 0;
+
+/* t_depth
+Greater than zero if the current thread is being audited. */
+
+thread_local int t_depth = 0;
+
+/* t_busy
+True while recording a violation: backtrace() itself might allocate or lock 
+on its first call. Don't audit the auditor. */
+
+thread_local bool t_busy = false;
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void record_(Call c)
+{
+	if (t_depth == 0 || t_busy)
+		return;
+	
+	t_busy = true;
+
+	countCalls_[static_cast<int>(c)].fetch_add(1);
+	bufferViolations_.fetch_add(1);
+
+	int i = countViolations_.fetch_add(1);
+	if (i < MAX_VIOLATIONS) {
+		Violation& v = violations_[i];
+		v.call   = c;
+		v.buffer = buffer_.load();
+		v.depth  = backtrace(v.stack, MAX_STACK);
+	}
+
+	t_busy = false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* getReal_
+Returns the next definition of symbol 'name', i.e. the one being interposed. 
+No static local here: its guard might take a lock. */
+
+template <typename F>
+F getReal_(std::atomic<F>& f, const char* name)
+{
+	F out = f.load();
+	if (out == nullptr) {
+		out = reinterpret_cast<F>(dlsym(RTLD_NEXT, name));
+		f.store(out);
+	}
+	return out;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool isSameViolation_(const Violation& a, const Violation& b)
+{
+	return a.call == b.call && a.depth == b.depth && 
+	       std::equal(a.stack, a.stack + a.depth, b.stack);
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+void beginBuffer()
+{
+	/* The first backtrace() call loads libgcc: do it out of the audited 
+	section. */
+
+	if (buffer_.load() == 0) {
+		void* dummy[1];
+		backtrace(dummy, 1);
+	}
+	buffer_.fetch_add(1);
+	enter();
+}
+
+
+void endBuffer()
+{
+	leave();
+
+	int count = bufferViolations_.exchange(0);
+	if (count == 0)
+		return;
+	dirtyBuffers_++;
+	worstBuffer_ = std::max(worstBuffer_, count);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void enter() { t_depth++; }
+void leave() { t_depth--; }
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void report()
+{
+	int total  = countViolations_.load();
+	int stored = std::min(total, MAX_VIOLATIONS);
+
+	u::log::print("[rtAudit] %llu buffers, %llu with violations, worst buffer had %d violations\n",
+		(unsigned long long) buffer_.load(), (unsigned long long) dirtyBuffers_, worstBuffer_);
+
+	for (int i = 0; i < static_cast<int>(Call::COUNT); i++)
+		if (countCalls_[i].load() > 0)
+			u::log::print("[rtAudit]   %s: %d\n", callNames_[i], countCalls_[i].load());
+
+	if (total > stored)
+		u::log::print("[rtAudit] only the first %d violations were traced\n", stored);
+
+	/* Print each unique call stack once, along with how many times it showed 
+	up. */
+
+	for (int i = 0; i < stored; i++) {
+		const Violation& v = violations_[i];
+
+		bool seen = false;
+		for (int j = 0; j < i && !seen; j++)
+			seen = isSameViolation_(v, violations_[j]);
+		if (seen)
+			continue;
+
+		int count = 1;
+		for (int j = i + 1; j < stored; j++)
+			if (isSameViolation_(v, violations_[j]))
+				count++;
+
+		u::log::print("[rtAudit] %s, %d time(s), first in buffer %llu:\n", 
+			callNames_[static_cast<int>(v.call)], count, (unsigned long long) v.buffer);
+
+		char** symbols = backtrace_symbols(v.stack, v.depth);
+		for (int k = 0; k < v.depth; k++)
+			u::log::print("[rtAudit]     %s\n", symbols != nullptr ? symbols[k] : "?");
+		free(symbols);
+	}
+}
+}}} // giada::m::rtAudit::
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+/* Interposed functions. Allocators forward to the glibc internals, so they 
+don't need dlsym(), which allocates in turn. */
+
+namespace ra = giada::m::rtAudit;
+
+extern "C"
+{
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void  __libc_free(void* ptr);
+
+
+void* malloc(size_t size)
+{
+	ra::record_(ra::Call::MALLOC);
+	return __libc_malloc(size);
+}
+
+
+void* calloc(size_t count, size_t size)
+{
+	ra::record_(ra::Call::CALLOC);
+	return __libc_calloc(count, size);
+}
+
+
+void* realloc(void* ptr, size_t size)
+{
+	ra::record_(ra::Call::REALLOC);
+	return __libc_realloc(ptr, size);
+}
+
+
+void free(void* ptr)
+{
+	if (ptr != nullptr)
+		ra::record_(ra::Call::FREE);
+	__libc_free(ptr);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+int pthread_mutex_lock(pthread_mutex_t* m)
+{
+	static std::atomic<int(*)(pthread_mutex_t*)> real(nullptr);
+	ra::record_(ra::Call::MUTEX_LOCK);
+	return ra::getReal_(real, "pthread_mutex_lock")(m);
+}
+
+
+int pthread_cond_wait(pthread_cond_t* c, pthread_mutex_t* m)
+{
+	static std::atomic<int(*)(pthread_cond_t*, pthread_mutex_t*)> real(nullptr);
+	ra::record_(ra::Call::COND_WAIT);
+	return ra::getReal_(real, "pthread_cond_wait")(c, m);
+}
+
+
+ssize_t write(int fd, const void* buf, size_t count)
+{
+	static std::atomic<ssize_t(*)(int, const void*, size_t)> real(nullptr);
+	ra::record_(ra::Call::WRITE);
+	return ra::getReal_(real, "write")(fd, buf, count);
+}
+
+
+int nanosleep(const struct timespec* req, struct timespec* rem)
+{
+	static std::atomic<int(*)(const struct timespec*, struct timespec*)> real(nullptr);
+	ra::record_(ra::Call::SLEEP);
+	return ra::getReal_(real, "nanosleep")(req, rem);
+}
+} // extern "C"
+
+#endif // #ifdef WITH_RT_AUDIT
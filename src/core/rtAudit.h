@@ -0,0 +1,64 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#ifndef G_RT_AUDIT_H
+#define G_RT_AUDIT_H
+
+
+#ifdef WITH_RT_AUDIT
+
+
+namespace giada {
+namespace m {
+namespace rtAudit
+{
+/* beginBuffer, endBuffer
+Delimit the processing of one audio buffer. Everything in between, on the 
+calling thread, is audited. Audio thread only. */
+
+void beginBuffer();
+void endBuffer();
+
+/* enter, leave
+Audit any other thread working on behalf of the audio thread, e.g. the render
+workers. Calls can be nested. */
+
+void enter();
+void leave();
+
+/* report
+Prints a summary of the violations found so far, with the call stack of each
+unique violation. Call it when the audio thread is no longer running. */
+
+void report();
+}}} // giada::m::rtAudit::
+
+
+#endif
+
+#endif
@@ -0,0 +1,392 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#include <algorithm>
+#include <cassert>
+#include "timeline.h"
+
+
+namespace giada {
+namespace m 
+{
+namespace
+{
+bool compareFrame_(const Action& a, const Action& b)
+{
+	return a.frame < b.frame;
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+Timeline::Iterator::Iterator(const Timeline& t, Position p)
+: m_timeline(t), 
+  m_position(p)
+{
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+const Action& Timeline::Iterator::operator *() const
+{
+	return (*m_timeline.m_chunks[m_position.chunk])[m_position.pos];
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Timeline::Iterator& Timeline::Iterator::operator ++()
+{
+	if (++m_position.pos == m_timeline.m_chunks[m_position.chunk]->size()) {
+		m_position.chunk++;
+		m_position.pos = 0;
+	}
+	return *this;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool Timeline::Iterator::operator !=(const Iterator& o) const
+{
+	return m_position.chunk != o.m_position.chunk || m_position.pos != o.m_position.pos;
+}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+Timeline::Iterator Timeline::begin() const { return Iterator(*this, {0, 0}); }
+Timeline::Iterator Timeline::end() const   { return Iterator(*this, {m_chunks.size(), 0}); }
+size_t Timeline::size() const              { return m_size; }
+bool Timeline::empty() const               { return m_size == 0; }
+
+
+/* -------------------------------------------------------------------------- */
+
+
+const Action* Timeline::find(ID id) const
+{
+	Position p = findPosition_(id);
+	if (p.chunk == m_chunks.size())
+		return nullptr;
+	return &(*m_chunks[p.chunk])[p.pos];
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Timeline::Position Timeline::lowerBound(Frame f) const
+{
+	if (m_chunks.empty())
+		return {0, 0};
+
+	size_t       c     = findChunk_(f);
+	const Chunk& chunk = *m_chunks[c];
+
+	Action key;
+	key.frame = f;
+	size_t pos = std::lower_bound(chunk.begin(), chunk.end(), key, compareFrame_) - chunk.begin();
+
+	if (pos == chunk.size())
+		return {c + 1, 0};
+	return {c, pos};
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Timeline::Position Timeline::advance(Position p, Frame f) const
+{
+	while (p.chunk < m_chunks.size()) {
+		const Chunk& chunk = *m_chunks[p.chunk];
+		if (chunk.back().frame < f) { // Skip the whole chunk
+			p.chunk++;
+			p.pos = 0;
+			continue;
+		}
+		while (chunk[p.pos].frame < f)
+			p.pos++;
+		break;
+	}
+	return p;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+ActionRange Timeline::getActionsOn(Position p, Frame f) const
+{
+	if (p.chunk >= m_chunks.size())
+		return {};
+
+	const Chunk& chunk = *m_chunks[p.chunk];
+
+	size_t last = p.pos;
+	while (last < chunk.size() && chunk[last].frame == f)
+		last++;
+
+	if (last == p.pos)
+		return {};
+	return { chunk.data() + p.pos, chunk.data() + last };
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Frame Timeline::getFrameAfter(Position p, Frame f) const
+{
+	if (p.chunk >= m_chunks.size())
+		return -1;
+
+	/* Actions on frame 'f' are all in the same chunk: the next frame is either 
+	further in this chunk or at the beginning of the next one. */
+
+	const Chunk& chunk = *m_chunks[p.chunk];
+
+	while (p.pos < chunk.size() && chunk[p.pos].frame <= f)
+		p.pos++;
+
+	if (p.pos < chunk.size())
+		return chunk[p.pos].frame;
+	if (p.chunk + 1 < m_chunks.size())
+		return m_chunks[p.chunk + 1]->front().frame;
+	return -1;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void Timeline::assign(std::vector<Action> actions)
+{
+	clear();
+
+	std::stable_sort(actions.begin(), actions.end(), compareFrame_);
+
+	/* Pack actions into chunks, never breaking a frame in two. */
+
+	for (const Action& a : actions) {
+		if (m_chunks.empty() || (m_chunks.back()->size() >= MAX_CHUNK_SIZE && 
+		                         m_chunks.back()->back().frame != a.frame))
+			m_chunks.push_back(std::make_shared<Chunk>());
+		m_chunks.back()->push_back(a);
+		getIndex_(a.id)[a.id] = a.frame;
+	}
+	m_size = actions.size();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void Timeline::clear()
+{
+	m_chunks.clear();
+	m_index.fill(nullptr);
+	m_size = 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void Timeline::insert(const Action& a)
+{
+	getIndex_(a.id)[a.id] = a.frame;
+	m_size++;
+
+	if (m_chunks.empty()) {
+		m_chunks.push_back(std::make_shared<Chunk>(1, a));
+		return;
+	}
+
+	size_t c     = findChunk_(a.frame);
+	Chunk& chunk = getChunk_(c);
+
+	chunk.insert(std::upper_bound(chunk.begin(), chunk.end(), a, compareFrame_), a);
+
+	split_(c);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool Timeline::update(ID id, std::function<void(Action&)> f)
+{
+	Position p = findPosition_(id);
+	if (p.chunk == m_chunks.size())
+		return false;
+
+	Action& a = getChunk_(p.chunk)[p.pos];
+#ifndef NDEBUG
+	Frame frame = a.frame;
+#endif
+	f(a);
+
+	assert(a.id == id);
+	assert(a.frame == frame);
+	return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void Timeline::removeIf(std::function<bool(const Action&)> f)
+{
+	for (size_t i = 0; i < m_chunks.size(); i++) {
+		const Chunk& shared = *m_chunks[i];
+		if (std::none_of(shared.begin(), shared.end(), f))
+			continue;
+
+		Chunk& chunk = getChunk_(i);
+		for (const Action& a : chunk)
+			if (f(a))
+				getIndex_(a.id).erase(a.id);
+
+		auto it = std::remove_if(chunk.begin(), chunk.end(), f);
+		m_size -= chunk.end() - it;
+		chunk.erase(it, chunk.end());
+	}
+
+	m_chunks.erase(std::remove_if(m_chunks.begin(), m_chunks.end(), 
+		[](const std::shared_ptr<Chunk>& c) { return c->empty(); }), m_chunks.end());
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+size_t Timeline::findChunk_(Frame f) const
+{
+	assert(!m_chunks.empty());
+
+	/* Last chunk starting on or before frame 'f', or the first one if 'f' comes
+	before everything else. */
+
+	auto it = std::upper_bound(m_chunks.begin(), m_chunks.end(), f, 
+		[](Frame f, const std::shared_ptr<Chunk>& c) { return f < c->front().frame; });
+
+	return it == m_chunks.begin() ? 0 : it - m_chunks.begin() - 1;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Timeline::Position Timeline::findPosition_(ID id) const
+{
+	const Position notFound = {m_chunks.size(), 0};
+
+	const std::shared_ptr<Index>& bucket = m_index[id % INDEX_BUCKETS];
+	if (bucket == nullptr)
+		return notFound;
+
+	auto it = bucket->find(id);
+	if (it == bucket->end())
+		return notFound;
+
+	Position p = lowerBound(it->second);
+	const Chunk& chunk = *m_chunks[p.chunk];
+	for (; p.pos < chunk.size() && chunk[p.pos].frame == it->second; p.pos++)
+		if (chunk[p.pos].id == id)
+			return p;
+
+	assert(false);
+	return notFound;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Timeline::Chunk& Timeline::getChunk_(size_t i)
+{
+	if (m_chunks[i].use_count() > 1)
+		m_chunks[i] = std::make_shared<Chunk>(*m_chunks[i]);
+	return *m_chunks[i];
+}
+
+
+Timeline::Index& Timeline::getIndex_(ID id)
+{
+	std::shared_ptr<Index>& bucket = m_index[id % INDEX_BUCKETS];
+	if (bucket == nullptr)
+		bucket = std::make_shared<Index>();
+	else
+	if (bucket.use_count() > 1)
+		bucket = std::make_shared<Index>(*bucket);
+	return *bucket;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void Timeline::split_(size_t i)
+{
+	Chunk& chunk = *m_chunks[i];
+	if (chunk.size() <= MAX_CHUNK_SIZE)
+		return;
+
+	/* Look for a frame boundary close to the middle, first forward then 
+	backward. No split at all if the chunk holds a single frame. */
+
+	size_t mid = chunk.size() / 2;
+	size_t cut = mid;
+	while (cut < chunk.size() && chunk[cut].frame == chunk[cut - 1].frame)
+		cut++;
+	if (cut == chunk.size()) {
+		cut = mid;
+		while (cut > 0 && chunk[cut].frame == chunk[cut - 1].frame)
+			cut--;
+		if (cut == 0)
+			return;
+	}
+
+	auto right = std::make_shared<Chunk>(chunk.begin() + cut, chunk.end());
+	chunk.erase(chunk.begin() + cut, chunk.end());
+	m_chunks.insert(m_chunks.begin() + i + 1, right);
+}
+}} // giada::m::
@@ -0,0 +1,199 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#ifndef G_TIMELINE_H
+#define G_TIMELINE_H
+
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include "core/types.h"
+#include "core/action.h"
+
+
+namespace giada {
+namespace m 
+{
+/* ActionRange
+Slice of contiguous actions in the Timeline. */
+
+struct ActionRange
+{
+	const Action* first = nullptr;
+	const Action* last  = nullptr;
+
+	const Action* begin() const { return first; }
+	const Action* end()   const { return last; }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+/* Timeline
+Actions sorted by frame, stored in chunks shared among copies. Copying a 
+Timeline is cheap; editing it copies only the chunk involved (copy-on-write). 
+Actions on the same frame always live in the same chunk and are kept in 
+recording order. An ID -> frame index, shared in buckets the same way, makes 
+lookups by ID independent of the timeline length. */
+
+class Timeline
+{
+public:
+
+	/* Position
+	Location of an action: chunk index + offset in the chunk. */
+
+	struct Position
+	{
+		size_t chunk = 0;
+		size_t pos   = 0;
+	};
+
+	class Iterator
+	{
+	public:
+
+		Iterator(const Timeline& t, Position p);
+
+		const Action& operator *() const;
+		Iterator& operator ++();
+		bool operator !=(const Iterator& o) const;
+
+	private:
+
+		const Timeline& m_timeline;
+		Position        m_position;
+	};
+
+	/* MAX_CHUNK_SIZE
+	Chunks are split in two when growing past this size. A chunk might still be 
+	larger than this, if it contains many actions on the same frame. */
+
+	static constexpr size_t MAX_CHUNK_SIZE = 256;
+
+	Iterator begin() const;
+	Iterator end() const;
+
+	size_t size() const;
+	bool   empty() const;
+
+	/* find
+	Returns a pointer to the action with ID 'id', or nullptr if not found. */
+
+	const Action* find(ID id) const;
+
+	/* lowerBound
+	Returns the position of the first action on or after frame 'f'. */
+
+	Position lowerBound(Frame f) const;
+
+	/* advance
+	Like lowerBound(), but walks forward from position 'p' instead of searching 
+	the whole timeline. Cheap when 'f' is close to 'p'. */
+
+	Position advance(Position p, Frame f) const;
+
+	/* getActionsOn
+	Returns the actions on frame 'f'. Position 'p' must be lowerBound(f). */
+
+	ActionRange getActionsOn(Position p, Frame f) const;
+
+	/* getFrameAfter
+	Returns the first frame after 'f' that holds some actions, or -1 if none. 
+	Position 'p' must be lowerBound(f). */
+
+	Frame getFrameAfter(Position p, Frame f) const;
+
+	/* assign
+	Replaces the whole content with 'actions', in any order. */
+
+	void assign(std::vector<Action> actions);
+
+	void clear();
+
+	/* insert
+	Inserts an action after the ones already on the same frame. */
+
+	void insert(const Action& a);
+
+	/* update
+	Applies 'f' to the action with ID 'id'. The action frame can't change: use
+	remove() + insert() for that. Returns false if the action is not found. */
+
+	bool update(ID id, std::function<void(Action&)> f);
+
+	/* removeIf
+	Removes all actions satisfying 'f'. Only chunks with matching actions are 
+	copied. */
+
+	void removeIf(std::function<bool(const Action&)> f);
+
+private:
+
+	using Chunk = std::vector<Action>;
+	using Index = std::unordered_map<ID, Frame>;
+
+	static constexpr size_t INDEX_BUCKETS = 256;
+
+	/* findChunk_
+	Returns the index of the chunk where frame 'f' belongs. */
+
+	size_t findChunk_(Frame f) const;
+
+	/* findPosition_
+	Returns the position of action 'id' in the timeline. Chunk index equals to
+	the number of chunks if not found. */
+
+	Position findPosition_(ID id) const;
+
+	/* getChunk_, getIndex_
+	Return a chunk or an index bucket ready to be modified, copying it first if 
+	shared with other timelines. */
+
+	Chunk& getChunk_(size_t i);
+	Index& getIndex_(ID id);
+
+	/* split_
+	Splits chunk 'i' in two halves if too big, on a frame boundary. */
+
+	void split_(size_t i);
+
+	/* m_index
+	Buckets are created lazily: an empty timeline holds no index at all. */
+
+	std::vector<std::shared_ptr<Chunk>>               m_chunks;
+	std::array<std::shared_ptr<Index>, INDEX_BUCKETS> m_index;
+	size_t                                            m_size = 0;
+};
+}} // giada::m::
+
+
+#endif
@@ -53,6 +53,7 @@ enum class ChannelMode : int
 enum class RecTriggerMode : int { NORMAL = 0, SIGNAL };
 
 enum class PreviewMode : int { NONE = 0, NORMAL, LOOP };
+enum class ResamplerQuality : int { LINEAR = 0, CUBIC, SINC };
 enum class EventType : int { AUTO = 0, MANUAL };
 };
 
@@ -25,34 +25,57 @@
  * -------------------------------------------------------------------------- */
 
 
+
+#include <algorithm>
 #include <cassert>
 #include <cstring>  // memcpy
 #include "utils/fs.h"
 #include "utils/log.h"
 #include "utils/string.h"
 #include "const.h"
+#include "waveStream.h"
 #include "wave.h"
 
 
 namespace giada {
 namespace m 
 {
-Wave::Wave(ID id)
-: id       (id),
-  m_rate   (0),
-  m_bits   (0),
-  m_logical(false),
-  m_edited (false) 
+Wave::Block::Block(Frame frames, int channels)
+: mem (new float[frames * channels]()),
+  data(mem.get())
+{
+}
+
+
+Wave::Block::Block(const float* data, Frame frames, int channels)
+: mem (new float[frames * channels]),
+  data(mem.get())
+{
+	std::memcpy(this->data, data, frames * channels * sizeof(float));
+}
+
+
+Wave::Block::Block(std::shared_ptr<void> owner, float* data, Frame frames)
+: owner(owner),
+  data (data)
 {
 }
 
 
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
 
-float* Wave::operator [](int offset) const
+Wave::Wave(ID id)
+: id        (id),
+  m_size    (0),
+  m_channels(0),
+  m_rate    (0),
+  m_bits    (0),
+  m_logical (false),
+  m_edited  (false) 
 {
-	return buffer[offset];
 }
 
 
@@ -61,14 +84,26 @@ float* Wave::operator [](int offset) const
 
 Wave::Wave(const Wave& other)
 : id        (other.id), 
+  m_pieces  (other.m_pieces),
+  m_starts  (other.m_starts),
+  m_size    (other.m_size),
+  m_channels(other.m_channels),
   m_rate    (other.m_rate),
   m_bits    (other.m_bits),	
   m_logical (false),
   m_edited  (false),
-  m_path    (other.m_path)
+  m_path    (other.m_path),
+  m_stream  (other.m_stream)
+{
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+const float* Wave::operator [](int offset) const
 {
-	buffer.alloc(other.getSize(), other.getChannels());
-	buffer.copyData(other.getFrame(0), other.getSize());
+	return getFrame(offset);
 }
 
 
@@ -77,10 +112,16 @@ Wave::Wave(const Wave& other)
 
 void Wave::alloc(int size, int channels, int rate, int bits, const std::string& path)
 {
-	buffer.alloc(size, channels);
-	m_rate = rate;
-	m_bits = bits;
-	m_path = path;
+	m_pieces.clear();
+	for (Frame f=0; f<size; f+=G_WAVE_BLOCK_SIZE) {
+		Frame frames = std::min(G_WAVE_BLOCK_SIZE, size - f);
+		m_pieces.push_back({ std::make_shared<Block>(frames, channels), 0, frames });
+	}
+	updateStarts_();
+	m_channels = channels;
+	m_rate     = rate;
+	m_bits     = bits;
+	m_path     = path;
 }
 
 
@@ -97,12 +138,14 @@ std::string Wave::getBasename(bool ext) const
 
 
 int Wave::getRate() const { return m_rate; }
-int Wave::getChannels() const { return buffer.countChannels(); }
+int Wave::getChannels() const { return m_channels; }
 std::string Wave::getPath() const { return m_path; }
-int Wave::getSize() const { return buffer.countFrames(); }
+int Wave::getSize() const { return m_stream ? m_stream->getSize() : m_size; }
 int Wave::getBits() const { return m_bits; }
 bool Wave::isLogical() const { return m_logical; }
 bool Wave::isEdited() const { return m_edited; }
+bool Wave::isStreamed() const { return m_stream != nullptr; }
+WaveStream* Wave::getStream() const { return m_stream.get(); }
 
 
 /* -------------------------------------------------------------------------- */
@@ -110,7 +153,7 @@ bool Wave::isEdited() const { return m_edited; }
 
 int Wave::getDuration() const
 {
-	return buffer.countFrames() / m_rate;
+	return getSize() / m_rate;
 }
 
 
@@ -126,9 +169,69 @@ std::string Wave::getExtension() const
 /* -------------------------------------------------------------------------- */
 
 
-float* Wave::getFrame(int f) const
+const float* Wave::getFrame(int f) const
+{
+	assert(f >= 0 && f < m_size);
+
+	size_t       i = findPiece_(f);
+	const Piece& p = m_pieces[i];
+	return p.block->data + (p.offset + f - m_starts[i]) * m_channels;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+float* Wave::editFrame(int f)
 {
-	return buffer[f];
+	assert(f >= 0 && f < m_size);
+
+	size_t i = findPiece_(f);
+	return editPiece_(i) + (f - m_starts[i]) * m_channels;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+const float* Wave::getData(Frame start, Frame count) const
+{
+	if (count <= 0 || start + count > m_size)
+		return nullptr;
+
+	size_t i = findPiece_(start);
+	if (start + count > m_starts[i] + m_pieces[i].frames)
+		return nullptr;
+	return getFrame(start);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void Wave::read(Frame start, Frame count, float* out) const
+{
+	assert(start >= 0 && start + count <= getSize());
+
+	/* Frames in memory first (all of them, if not streamed). */
+
+	Frame mem = std::max(0, std::min(count, m_size - start));
+	forEachBlock(start, mem, [&out, this](const float* data, Frame frames)
+	{
+		std::memcpy(out, data, frames * m_channels * sizeof(float));
+		out += frames * m_channels;
+	});
+
+	if (m_stream == nullptr)
+		return;
+
+	/* Keep the stream ready to take over from where memory ends, while reading
+	the preloaded part. */
+
+	if (mem == count)
+		m_stream->cue(m_size);
+	else
+		m_stream->read(start + mem, count - mem, out);
 }
 
 
@@ -157,7 +260,69 @@ void Wave::setPath(const std::string& p, int id)
 
 void Wave::copyData(const float* data, int frames, int offset)
 {
-	buffer.copyData(data, frames, offset);
+	editBlocks(offset, frames, [&data, this](float* dest, Frame count)
+	{
+		std::memcpy(dest, data, count * m_channels * sizeof(float));
+		data += count * m_channels;
+	});
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void Wave::cut(Frame a, Frame b)
+{
+	assert(a >= 0 && a <= b && b <= m_size);
+
+	size_t first = split_(a);
+	size_t last  = split_(b);
+	m_pieces.erase(m_pieces.begin() + first, m_pieces.begin() + last);
+	updateStarts_();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void Wave::trim(Frame a, Frame b)
+{
+	assert(a >= 0 && a <= b && b <= m_size);
+
+	size_t first = split_(a);
+	size_t last  = split_(b);
+	m_pieces.erase(m_pieces.begin() + last, m_pieces.end());
+	m_pieces.erase(m_pieces.begin(), m_pieces.begin() + first);
+	updateStarts_();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void Wave::insert(const Wave& src, Frame a)
+{
+	assert(a >= 0 && a <= m_size);
+	assert(src.getChannels() == m_channels);
+
+	std::vector<Piece> pieces = src.m_pieces; // 'src' might be this very Wave
+
+	size_t i = split_(a);
+	m_pieces.insert(m_pieces.begin() + i, pieces.begin(), pieces.end());
+	updateStarts_();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void Wave::rotate(Frame offset)
+{
+	assert(offset >= 0 && offset <= m_size);
+
+	size_t i = split_(m_size - offset);
+	std::rotate(m_pieces.begin(), m_pieces.begin() + i, m_pieces.end());
+	updateStarts_();
 }
 
 
@@ -166,7 +331,98 @@ void Wave::copyData(const float* data, int frames, int offset)
 
 void Wave::moveData(AudioBuffer& b)
 {
-	buffer.moveData(b);
+	alloc(b.countFrames(), b.countChannels(), m_rate, m_bits, m_path);
+	if (b.countFrames() > 0)
+		copyData(b[0], b.countFrames());
+	b.free();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void Wave::mapData(std::shared_ptr<void> owner, float* data, int size, 
+	int channels, int rate, int bits, const std::string& path)
+{
+	m_pieces.clear();
+	for (Frame f=0; f<size; f+=G_WAVE_BLOCK_SIZE) {
+		Frame frames = std::min(G_WAVE_BLOCK_SIZE, size - f);
+		m_pieces.push_back({ std::make_shared<Block>(owner, data + f * channels, frames), 0, frames });
+	}
+	updateStarts_();
+	m_channels = channels;
+	m_rate     = rate;
+	m_bits     = bits;
+	m_path     = path;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void Wave::setStream(std::shared_ptr<WaveStream> s)
+{
+	m_stream = s;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+size_t Wave::findPiece_(Frame f) const
+{
+	assert(!m_starts.empty());
+	return std::upper_bound(m_starts.begin(), m_starts.end(), f) - m_starts.begin() - 1;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+size_t Wave::split_(Frame f)
+{
+	if (f == m_size)
+		return m_pieces.size();
+
+	size_t i = findPiece_(f);
+	Frame  d = f - m_starts[i];
+	if (d == 0)
+		return i;
+
+	Piece right = { m_pieces[i].block, m_pieces[i].offset + d, m_pieces[i].frames - d };
+	m_pieces[i].frames = d;
+	m_pieces.insert(m_pieces.begin() + i + 1, right);
+	m_starts.insert(m_starts.begin() + i + 1, f);
+	return i + 1;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+float* Wave::editPiece_(size_t i)
+{
+	Piece& p = m_pieces[i];
+	if (p.block.use_count() > 1 || p.block->owner != nullptr) {
+		p.block  = std::make_shared<Block>(p.block->data + p.offset * m_channels, 
+			p.frames, m_channels);
+		p.offset = 0;
+	}
+	return p.block->data + p.offset * m_channels;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void Wave::updateStarts_()
+{
+	m_starts.clear();
+	m_size = 0;
+	for (const Piece& p : m_pieces) {
+		m_starts.push_back(m_size);
+		m_size += p.frames;
+	}
 }
 
 }}; // giada::m::
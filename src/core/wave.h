@@ -29,27 +29,104 @@
 #define G_WAVE_H
 
 
+#include <algorithm>
 #include <string>
+#include <memory>
+#include <vector>
 #include "core/audioBuffer.h"
+#include "core/const.h"
 #include "core/types.h"
 
 
 namespace giada {
 namespace m 
 {
+class WaveStream;
+
+/* Wave
+Audio data is stored in blocks of at most G_WAVE_BLOCK_SIZE frames, arranged 
+in a list of pieces: each piece is a range of frames of a block. Blocks are 
+shared among copies of the same Wave, e.g. the ones made by the model on each 
+swap or when a channel is cloned, and are never written while shared: editing
+a frame gives the Wave its own copy of the piece that contains it 
+(copy-on-write). Cutting, trimming, pasting and shifting only rearrange the 
+pieces, no samples are moved around. */
+
 class Wave
 {
 public:
 
 	Wave(ID id);
+
+	/* Wave (copy)
+	Shares audio data with 'other', no samples are copied. */
+
 	Wave(const Wave& other);
 
-	float* operator [](int offset) const;
+	const float* operator [](int offset) const;
 
 	/* getFrame
-	Works like operator []. See AudioBuffer for reference. */
+	Works like operator []. Frames are contiguous within a piece only: use 
+	read() or forEachBlock() for ranges. Streamed Waves only hold their first 
+	part in memory: use read() instead. */
 	
-	float* getFrame(int f) const;
+	const float* getFrame(int f) const;
+
+	/* editFrame
+	Returns frame 'f' for writing. Copies the piece it belongs to first, if 
+	shared with another Wave. Never call it on a Wave living in the model: 
+	clone it first (e.g. with model::onSwap). */
+
+	float* editFrame(int f);
+
+	/* getData
+	Returns a pointer to frames [start, start + count) if they are contiguous in
+	memory, nullptr otherwise. */
+
+	const float* getData(Frame start, Frame count) const;
+
+	/* forEachBlock
+	Calls f(data, frames) on each contiguous chunk of memory holding frames in
+	[start, start + count). Memory-resident frames only. */
+
+	template<typename F>
+	void forEachBlock(Frame start, Frame count, F f) const
+	{
+		if (count <= 0)
+			return;
+		for (size_t i = findPiece_(start); count > 0; i++) {
+			const Piece& p      = m_pieces[i];
+			Frame        offset = start - m_starts[i];
+			Frame        frames = std::min(count, p.frames - offset);
+			f(static_cast<const float*>(p.block->data + (p.offset + offset) * m_channels), frames);
+			start += frames;
+			count -= frames;
+		}
+	}
+
+	/* editBlocks
+	Like forEachBlock(), for writing. Same rules as editFrame(). */
+
+	template<typename F>
+	void editBlocks(Frame start, Frame count, F f)
+	{
+		if (count <= 0)
+			return;
+		for (size_t i = findPiece_(start); count > 0; i++) {
+			float* data   = editPiece_(i);
+			Frame  offset = start - m_starts[i];
+			Frame  frames = std::min(count, m_pieces[i].frames - offset);
+			f(data + offset * m_channels, frames);
+			start += frames;
+			count -= frames;
+		}
+	}
+
+	/* read
+	Copies 'count' frames starting from 'start' into 'out', from memory or from 
+	the disk stream. Audio thread only, if the Wave is streamed. */
+
+	void read(Frame start, Frame count, float* out) const;
 	
 	std::string getBasename(bool ext=false) const;
 	std::string getExtension() const;
@@ -61,6 +138,8 @@ public:
 	int getDuration() const;
 	bool isLogical() const;
 	bool isEdited() const;
+	bool isStreamed() const;
+	WaveStream* getStream() const;
 
 	/* setPath
 	Sets new path 'p'. If 'id' != -1 inserts a numeric id next to the file 
@@ -72,30 +151,123 @@ public:
 	void setLogical(bool l);
 	void setEdited(bool e);
 
+	/* setStream
+	Turns this Wave into a streamed one: data held in memory so far becomes the
+	preloaded part, the rest comes from stream 's'. */
+
+	void setStream(std::shared_ptr<WaveStream> s);
+
 	/* moveData
-	Moves data held by 'b' into this buffer. Then 'b' becomes an empty buffer. */
+	Replaces audio data with the one held by 'b'. Then 'b' becomes an empty 
+	buffer. */
 
 	void moveData(AudioBuffer& b); 
 	
 	/* copyData
-	Copies 'frames' frames from the new 'data' into m_data, starting from frame 
-	'offset'. It takes for granted that the new data contains the same number of 
-	channels than m_channels. */
+	Copies 'frames' frames from the new 'data' into this Wave, starting from 
+	frame 'offset'. It takes for granted that the new data contains the same 
+	number of channels than m_channels. */
 
 	void copyData(const float* data, int frames, int offset=0);
 
+	/* cut
+	Removes frames in range [a, b). */
+
+	void cut(Frame a, Frame b);
+
+	/* trim
+	Keeps frames in range [a, b) only. */
+
+	void trim(Frame a, Frame b);
+
+	/* insert
+	Inserts all frames of 'src' before frame 'a'. Data is shared with 'src'. */
+
+	void insert(const Wave& src, Frame a);
+
+	/* rotate
+	Moves the last 'offset' frames to the beginning. */
+
+	void rotate(Frame offset);
+
+	/* alloc
+	Allocates 'size' frames of silence, in blocks of G_WAVE_BLOCK_SIZE frames:
+	editFrame(f) is contiguous up to the end of the block 'f' belongs to. */
+
 	void alloc(int size, int channels, int rate, int bits, const std::string& path);
 
+	/* mapData
+	Like alloc(), but uses existing read-only 'data' instead of allocating new 
+	memory, e.g. a memory-mapped file. 'owner' keeps it alive. Mapped blocks 
+	are copied when edited, like shared ones. */
+
+	void mapData(std::shared_ptr<void> owner, float* data, int size, int channels, 
+		int rate, int bits, const std::string& path);
+
 	ID id;
 
 private:
 
-	AudioBuffer buffer;
+	/* Block
+	A chunk of interleaved audio data, either owned or borrowed from 'owner'. */
+
+	struct Block
+	{
+		Block(Frame frames, int channels);
+		Block(const float* data, Frame frames, int channels);
+		Block(std::shared_ptr<void> owner, float* data, Frame frames);
+
+		std::unique_ptr<float[]> mem;
+		std::shared_ptr<void>    owner;
+		float*                   data;
+	};
+
+	/* Piece
+	Frames [offset, offset + frames) of a Block. */
+
+	struct Piece
+	{
+		std::shared_ptr<Block> block;
+		Frame                  offset;
+		Frame                  frames;
+	};
+
+	/* findPiece_
+	Returns the index of the piece containing frame 'f'. */
+
+	size_t findPiece_(Frame f) const;
+
+	/* split_
+	Makes sure a piece starts at frame 'f' and returns its index (the number of
+	pieces if 'f' is the end of the Wave). */
+
+	size_t split_(Frame f);
+
+	/* editPiece_
+	Returns the data of piece 'i' for writing, copying it first if needed. */
+
+	float* editPiece_(size_t i);
+
+	/* updateStarts_
+	Recomputes m_starts and m_size after a change in the list of pieces. */
+
+	void updateStarts_();
+
+	std::vector<Piece> m_pieces;
+	std::vector<Frame> m_starts; // First frame of each piece
+	int m_size;         // frames in memory
+	int m_channels;
 	int m_rate;
 	int m_bits;
 	bool m_logical;     // memory only (a take)
 	bool m_edited;      // edited via editor
 	std::string m_path; // E.g. /path/to/my/sample.wav
+
+	/* m_stream
+	Disk stream for long Waves, nullptr if all data is in memory. Shared among
+	copies made by the model: there's only one reader at a time. */
+
+	std::shared_ptr<WaveStream> m_stream;
 };
 }}; // giada::m::
 
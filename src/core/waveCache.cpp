@@ -0,0 +1,302 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+#include "utils/fs.h"
+#include "utils/log.h"
+#include "core/const.h"
+#include "core/wave.h"
+#include "waveCache.h"
+
+
+namespace giada {
+namespace m {
+namespace waveCache
+{
+namespace
+{
+constexpr uint32_t VERSION = 1;
+constexpr auto     MAGIC   = "GDWCACHE";
+
+/* Header
+Cache file header. Interleaved float data follows, 64 bytes from the start of
+the file so that it's suitably aligned for SIMD access. */
+
+struct Header
+{
+	char     magic[8];
+	uint32_t version;
+	uint32_t channels;
+	uint32_t rate;
+	uint32_t bits;
+	uint64_t frames;
+	Key      key;
+	uint8_t  padding[24];
+};
+
+static_assert(sizeof(Header) == 64, "Wrong cache header size");
+
+std::string dir_ = "";
+
+
+/* -------------------------------------------------------------------------- */
+
+/* hash_
+MurmurHash64A, by Austin Appleby. Fast and good enough to tell files apart. */
+
+uint64_t hash_(const unsigned char* data, size_t len, uint64_t seed)
+{
+	const uint64_t m = 0xc6a4a7935bd1e995ULL;
+	const int      r = 47;
+
+	uint64_t h = seed ^ (len * m);
+
+	size_t words = len / 8;
+	for (size_t i = 0; i < words; i++) {
+		uint64_t k;
+		std::memcpy(&k, data + i * 8, 8);
+		k *= m; 
+		k ^= k >> r; 
+		k *= m;
+		h ^= k;
+		h *= m;
+	}
+
+	const unsigned char* tail = data + words * 8;
+	size_t rest = len & 7;
+	for (size_t i = rest; i > 0; i--)
+		h ^= static_cast<uint64_t>(tail[i - 1]) << (8 * (i - 1));
+	if (rest > 0)
+		h *= m;
+
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+	return h;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* map_
+Maps file 'path' read-only in memory. The returned pointer owns the mapping: 
+the file gets unmapped when the last copy goes away. */
+
+std::shared_ptr<void> map_(const std::string& path, size_t& size)
+{
+#if defined(_WIN32)
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, 
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	LARGE_INTEGER s;
+	if (!GetFileSizeEx(file, &s) || s.QuadPart == 0) {
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr)
+		return nullptr;
+
+	void* addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (addr == nullptr)
+		return nullptr;
+
+	size = s.QuadPart;
+	return std::shared_ptr<void>(addr, [](void* a) { UnmapViewOfFile(a); });
+
+#else
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		close(fd);
+		return nullptr;
+	}
+
+	size_t len  = st.st_size;
+	void*  addr = mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		return nullptr;
+
+	size = len;
+	return std::shared_ptr<void>(addr, [len](void* a) { munmap(a, len); });
+
+#endif
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::string makePath_(Key key)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.gwc", static_cast<unsigned long long>(key));
+	return dir_ + G_SLASH + name;
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+void init(const std::string& dir)
+{
+	dir_ = dir;
+}
+
+
+bool isEnabled()
+{
+	return !dir_.empty();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Key makeKey(const std::string& path, int rate, int quality)
+{
+	size_t                size;
+	std::shared_ptr<void> data = map_(path, size);
+	if (data == nullptr)
+		return 0;
+
+	uint64_t content  = hash_(static_cast<const unsigned char*>(data.get()), size, VERSION);
+	uint64_t params[] = { static_cast<uint64_t>(rate), static_cast<uint64_t>(quality) };
+
+	Key key = hash_(reinterpret_cast<const unsigned char*>(params), sizeof(params), content);
+	return key != 0 ? key : 1;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::unique_ptr<Wave> load(Key key, ID id, const std::string& path)
+{
+	if (!isEnabled() || key == 0)
+		return nullptr;
+
+	size_t                size;
+	std::shared_ptr<void> data = map_(makePath_(key), size);
+	if (data == nullptr || size < sizeof(Header))
+		return nullptr;
+
+	Header h;
+	std::memcpy(&h, data.get(), sizeof(Header));
+
+	if (std::memcmp(h.magic, MAGIC, sizeof(h.magic)) != 0 || h.version != VERSION || 
+	    h.key != key || h.channels != G_MAX_IO_CHANS || 
+	    size != sizeof(Header) + h.frames * h.channels * sizeof(float)) {
+		u::log::print("[waveCache::load] invalid cache file for %s, ignored\n", path.c_str());
+		return nullptr;
+	}
+
+	float* frames = reinterpret_cast<float*>(static_cast<char*>(data.get()) + sizeof(Header));
+
+	std::unique_ptr<Wave> wave = std::make_unique<Wave>(id);
+	wave->mapData(data, frames, h.frames, h.channels, h.rate, h.bits, path);
+
+	u::log::print("[waveCache::load] %s mapped from cache, %d frames\n", path.c_str(), 
+		wave->getSize());
+
+	return wave;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void store(Key key, const Wave& w)
+{
+	if (!isEnabled() || key == 0)
+		return;
+
+	if (!u::fs::dirExists(dir_) && !u::fs::mkdir(dir_)) {
+		u::log::print("[waveCache::store] unable to create cache dir %s\n", dir_.c_str());
+		return;
+	}
+
+	Header h = {};
+	std::memcpy(h.magic, MAGIC, sizeof(h.magic));
+	h.version  = VERSION;
+	h.channels = w.getChannels();
+	h.rate     = w.getRate();
+	h.bits     = w.getBits();
+	h.frames   = w.getSize();
+	h.key      = key;
+
+	std::string path = makePath_(key);
+	std::string tmp  = path + "." + 
+		std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "." +
+		std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+
+	FILE* f = fopen(tmp.c_str(), "wb");
+	if (f == nullptr) {
+		u::log::print("[waveCache::store] unable to write %s\n", tmp.c_str());
+		return;
+	}
+
+	bool ok = fwrite(&h, sizeof(Header), 1, f) == 1;
+	w.forEachBlock(0, w.getSize(), [&ok, &w, f](const float* data, Frame frames)
+	{
+		size_t samples = static_cast<size_t>(frames) * w.getChannels();
+		ok = ok && fwrite(data, sizeof(float), samples, f) == samples;
+	});
+	ok = fclose(f) == 0 && ok;
+
+	if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+		u::log::print("[waveCache::store] unable to store %s\n", path.c_str());
+		std::remove(tmp.c_str());
+	}
+}
+}}} // giada::m::waveCache::
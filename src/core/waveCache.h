@@ -0,0 +1,79 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_WAVE_CACHE_H
+#define G_WAVE_CACHE_H
+
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "core/types.h"
+
+
+namespace giada {
+namespace m 
+{
+class Wave;
+namespace waveCache
+{
+/* Key
+Identifies a cache entry: content of the source file, plus the parameters used
+to convert it. 0 means invalid. */
+
+using Key = uint64_t;
+
+/* init
+Sets the directory where cache files live. An empty string disables the 
+cache. */
+
+void init(const std::string& dir);
+
+bool isEnabled();
+
+/* makeKey
+Hashes the content of file 'path' together with the target sample rate and
+resampling quality. Returns 0 if the file can't be read. */
+
+Key makeKey(const std::string& path, int rate, int quality);
+
+/* load
+Returns a new Wave whose data is memory-mapped from the cache file matching 
+'key', or nullptr if there's no such file. Data is mapped read-only and 
+shared: other Giada instances mapping the same file use the same memory. */
+
+std::unique_ptr<Wave> load(Key key, ID id, const std::string& path);
+
+/* store
+Writes a new cache file for Wave 'w'. The file is written under a temporary
+name and then renamed, so that other instances never see it incomplete. */
+
+void store(Key key, const Wave& w);
+}}} // giada::m::waveCache::
+
+
+#endif
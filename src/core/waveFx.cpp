@@ -43,8 +43,9 @@ namespace
 {
 void fadeFrame_(Wave& w, int i, float val)
 {
+	float* frame = w.editFrame(i);
 	for (int j=0; j<w.getChannels(); j++)
-		w[i][j] *= val;
+		frame[j] *= val;
 }
 
 
@@ -54,13 +55,11 @@ void fadeFrame_(Wave& w, int i, float val)
 float getPeak_(const Wave& w, int a, int b)
 {
 	float peak = 0.0f;
-	float abs  = 0.0f;
-	for (int i=a; i<b; i++) {
-		for (int j=0; j<w.getChannels(); j++) // Find highest value in any channel
-			abs = fabs(w[i][j]);
-		if (abs > peak)
-			peak = abs;
-	}
+	w.forEachBlock(a, b - a, [&peak, &w](const float* data, Frame frames)
+	{
+		for (int i=0; i<frames * w.getChannels(); i++) // Highest value in any channel
+			peak = std::max(peak, std::fabs(data[i]));
+	});
 	return peak;
 }
 }; // {anonymous}
@@ -79,10 +78,11 @@ void normalizeHard(ID waveId, int a, int b)
 		if (peak == 0.0f || peak > 1.0f)  // as in ::normalizeSoft
 			return;
 
-		for (int i=a; i<b; i++) {
-			for (int j=0; j<w.getChannels(); j++)
-				w[i][j] = w[i][j] * (1.0f / peak);
-		}
+		w.editBlocks(a, b - a, [peak, &w](float* data, Frame frames)
+		{
+			for (int i=0; i<frames * w.getChannels(); i++)
+				data[i] = data[i] * (1.0f / peak);
+		});
 		w.setEdited(true);
 	});
 }
@@ -99,9 +99,13 @@ int monoToStereo(Wave& w)
 	AudioBuffer newData;
 	newData.alloc(w.getSize(), G_MAX_IO_CHANS);
 
-	for (int i=0; i<newData.countFrames(); i++)
-		for (int j=0; j<newData.countChannels(); j++)
-			newData[i][j] = w[i][0];
+	Frame k = 0;
+	w.forEachBlock(0, w.getSize(), [&newData, &k](const float* data, Frame frames)
+	{
+		for (int i=0; i<frames; i++, k++)
+			for (int j=0; j<newData.countChannels(); j++)
+				newData[k][j] = data[i];
+	});
 
 	w.moveData(newData);
 
@@ -118,9 +122,10 @@ void silence(ID waveId, int a, int b)
 	
 	model::onSwap(m::model::waves, waveId, [&](Wave& w)
 	{
-		for (int i=a; i<b; i++)
-			for (int j=0; j<w.getChannels(); j++)	
-				w[i][j] = 0.0f;
+		w.editBlocks(a, b - a, [&w](float* data, Frame frames)
+		{
+			std::fill(data, data + frames * w.getChannels(), 0.0f);
+		});
 		w.setEdited(true);
 	});
 }
@@ -136,25 +141,9 @@ void cut(ID waveId, int a, int b)
 		if (a < 0) a = 0;
 		if (b > w.getSize()) b = w.getSize();
 
-		/* Create a new temp wave and copy there the original one, skipping the a-b 
-		range. */
-
-		int newSize = w.getSize() - (b - a);
-
-		AudioBuffer newData;
-		newData.alloc(newSize, w.getChannels());
-
 		u::log::print("[wfx::cut] cutting from %d to %d\n", a, b);
 
-		for (int i=0, k=0; i<w.getSize(); i++) {
-			if (i < a || i >= b) {
-				for (int j=0; j<w.getChannels(); j++)	
-					newData[k][j] = w[i][j];
-				k++;
-			}
-		}
-
-		w.moveData(newData);
+		w.cut(a, b);
 		w.setEdited(true);
 	});
 }
@@ -170,18 +159,9 @@ void trim(ID waveId, int a, int b)
 		if (a < 0) a = 0;
 		if (b > w.getSize()) b = w.getSize();
 
-		int newSize = b - a;
-
-		AudioBuffer newData;
-		newData.alloc(newSize, w.getChannels());
-
 		u::log::print("[wfx::trim] trimming from %d to %d (area = %d)\n", a, b, b-a);
 
-		for (int i=0; i<newData.countFrames(); i++)
-			for (int j=0; j<newData.countChannels(); j++)
-				newData[i][j] = w[i+a][j];
-
-		w.moveData(newData);
+		w.trim(a, b);
 		w.setEdited(true);
 	});
 }
@@ -196,17 +176,10 @@ void paste(const Wave& src, ID waveId, int a)
 	{
 		assert(src.getChannels() == des.getChannels());
 
-		AudioBuffer newData;
-		newData.alloc(src.getSize() + des.getSize(), des.getChannels());
-
 		/* |---original data---|///paste data///|---original data---|
 				 des[0, a)      src[0, src.size)   des[a, des.size)	*/
 
-		newData.copyData(des[0], a, 0);
-		newData.copyData(src[0], src.getSize(), a);
-		newData.copyData(des[a], des.getSize() - a, src.getSize() + a);
-
-		des.moveData(newData);
+		des.insert(src, a);
 		des.setEdited(true);
 	});
 }
@@ -261,13 +234,15 @@ void shift(ID waveId, int offset)
 {
 	model::onSwap(m::model::waves, waveId, [&](Wave& w)
 	{
+		if (w.getSize() == 0)
+			return;
 		if (offset < 0)
 			offset = (w.getSize() + w.getChannels()) + offset;
+		offset %= w.getSize();
+		if (offset == 0)
+			return;
 
-		float* begin = w.getFrame(0);
-		float* end   = w.getFrame(0) + (w.getSize() * w.getChannels());
-
-		std::rotate(begin, end - (offset * w.getChannels()), end);
+		w.rotate(offset);
 		w.setEdited(true);
 	});
 }
@@ -281,11 +256,20 @@ void reverse(ID waveId, int a, int b)
 	/* https://stackoverflow.com/questions/33201528/reversing-an-array-of-structures-in-c */
 	model::onSwap(m::model::waves, waveId, [&](Wave& w)
 	{
-		float* begin = w.getFrame(0) + (a * w.getChannels());
-		float* end   = w.getFrame(0) + (b * w.getChannels());
+		if (b <= a)
+			return;
+
+		AudioBuffer range;
+		range.alloc(b - a, w.getChannels());
+		w.read(a, b - a, range[0]);
+
+		float* begin = range[0];
+		float* end   = range[0] + range.countSamples();
 
 		std::reverse(begin, end);
 
+		w.copyData(range[0], b - a, a);
+
 		w.setEdited(true);
 	});
 }
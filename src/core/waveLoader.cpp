@@ -0,0 +1,123 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+
+#include <algorithm>
+#include "utils/log.h"
+#include "core/wave.h"
+#include "core/waveManager.h"
+#include "waveLoader.h"
+
+
+namespace giada {
+namespace m 
+{
+WaveLoader::WaveLoader(std::vector<patch::Wave> waves, int threads)
+: m_waves  (std::move(waves)),
+  m_results(m_waves.size()),
+  m_next   (0),
+  m_done   (0)
+{
+	if (threads <= 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	threads = std::min<size_t>(threads, m_waves.size());
+
+	u::log::print("[WaveLoader] loading %d Waves on %d threads\n", 
+		static_cast<int>(m_waves.size()), threads);
+
+	for (int i=0; i<threads; i++)
+		m_threads.emplace_back(&WaveLoader::worker_, this);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+WaveLoader::~WaveLoader()
+{
+	/* Skip the Waves not yet started, if wait() has never been called. */
+
+	m_next.store(m_waves.size());
+	for (std::thread& t : m_threads)
+		if (t.joinable())
+			t.join();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::vector<std::unique_ptr<Wave>> WaveLoader::wait(Progress progress)
+{
+	if (m_waves.empty())
+		return {};
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	size_t reported = 0;
+	while (true) {
+		m_cond.wait(lock, [&] { return m_done != reported || m_done == m_waves.size(); });
+		reported = m_done;
+		if (progress != nullptr) {
+			lock.unlock();
+			progress(reported / static_cast<float>(m_waves.size()));
+			lock.lock();
+		}
+		if (reported == m_waves.size())
+			break;
+	}
+	lock.unlock();
+
+	for (std::thread& t : m_threads)
+		t.join();
+
+	std::vector<std::unique_ptr<Wave>> out;
+	for (std::unique_ptr<Wave>& w : m_results)
+		if (w != nullptr)
+			out.push_back(std::move(w));
+	return out;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WaveLoader::worker_()
+{
+	size_t i;
+	while ((i = m_next.fetch_add(1)) < m_waves.size()) {
+
+		m_results[i] = waveManager::createFromPatch(m_waves[i]);
+		if (m_results[i] == nullptr)
+			u::log::print("[WaveLoader] unable to load %s\n", m_waves[i].path.c_str());
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_done++;
+		m_cond.notify_one();
+	}
+}
+}} // giada::m::
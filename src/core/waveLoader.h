@@ -0,0 +1,98 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+
+#ifndef G_WAVE_LOADER_H
+#define G_WAVE_LOADER_H
+
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "core/patch.h"
+
+
+namespace giada {
+namespace m 
+{
+class Wave;
+
+/* WaveLoader
+Loads a batch of Waves in the background, on a pool of threads. Decoding, 
+mono to stereo conversion and resampling of each Wave run in parallel, while 
+the creator of the WaveLoader is free to do something else, e.g. instantiating
+plug-ins. */
+
+class WaveLoader
+{
+public:
+
+	/* Progress
+	Called by wait() with the fraction [0.0, 1.0] of Waves loaded so far. */
+
+	using Progress = std::function<void(float)>;
+
+	/* WaveLoader
+	Starts loading 'waves' on 'threads' threads. Zero threads means one per 
+	CPU core. */
+
+	WaveLoader(std::vector<patch::Wave> waves, int threads=0);
+	WaveLoader(const WaveLoader&) = delete;
+	~WaveLoader();
+
+	/* wait
+	Blocks until all Waves are loaded and returns them, in the same order they
+	were given. Waves that failed to load are left out. 'progress' runs on the 
+	calling thread. */
+
+	std::vector<std::unique_ptr<Wave>> wait(Progress progress=nullptr);
+
+private:
+
+	void worker_();
+
+	std::vector<patch::Wave>           m_waves;
+	std::vector<std::unique_ptr<Wave>> m_results;
+	std::vector<std::thread>           m_threads;
+	std::atomic<size_t>                m_next;
+
+	/* m_done
+	Number of Waves processed so far. Guarded by m_mutex. */
+
+	size_t                  m_done;
+	std::mutex              m_mutex;
+	std::condition_variable m_cond;
+};
+}} // giada::m::
+
+
+#endif
@@ -25,14 +25,21 @@
  * -------------------------------------------------------------------------- */
 
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <mutex>
+#include <vector>
 #include <sndfile.h>
 #include <samplerate.h>
 #include "utils/log.h"
 #include "utils/fs.h"
 #include "const.h"
+#include "conf.h"
 #include "idManager.h"
 #include "wave.h"
+#include "waveStream.h"
+#include "waveCache.h"
 #include "patch.h"
 #include "waveFx.h"
 #include "waveManager.h"
@@ -44,7 +51,22 @@ namespace waveManager
 {
 namespace
 {
-IdManager waveId_;
+IdManager  waveId_;
+std::mutex waveIdMutex_;
+
+
+/* -------------------------------------------------------------------------- */
+
+/* makeId_
+Registers 'id' and returns it, or generates a new one if 'id' == 0. Waves are 
+created from multiple threads while loading a patch. */
+
+ID makeId_(ID id=0)
+{
+	std::lock_guard<std::mutex> lock(waveIdMutex_);
+	waveId_.set(id);
+	return waveId_.get(id);
+}
 
 
 /* -------------------------------------------------------------------------- */
@@ -68,6 +90,65 @@ int getBits_(const SF_INFO& header)
 		return 64;
 	return 0;
 }
+
+
+/* -------------------------------------------------------------------------- */
+
+/* isStreamable_
+Streams only files that don't need a sample rate conversion: resampling is
+done once on the whole data, see mh::createWave_(). */
+
+bool isStreamable_(const SF_INFO& header)
+{
+	if (conf::streamThreshold == 0 || header.samplerate != conf::samplerate)
+		return false;
+	sf_count_t bytes = header.frames * G_MAX_IO_CHANS * sizeof(float);
+	return bytes > static_cast<sf_count_t>(conf::streamThreshold) * 1024 * 1024;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+int saveStreamed_(const Wave& w, const std::string& path)
+{
+	/* Already there, e.g. when saving a project twice. Don't overwrite the file
+	being streamed. */
+
+	if (path == w.getStream()->getPath())
+		return G_RES_OK;
+
+	SF_INFO  headerIn;
+	SNDFILE* fileIn = sf_open(w.getStream()->getPath().c_str(), SFM_READ, &headerIn);
+	if (fileIn == nullptr) {
+		u::log::print("[waveManager::save] unable to read %s\n", w.getStream()->getPath().c_str());
+		return G_RES_ERR_IO;
+	}
+
+	SF_INFO header;
+	header.samplerate = headerIn.samplerate;
+	header.channels   = headerIn.channels;
+	header.format     = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+
+	SNDFILE* file = sf_open(path.c_str(), SFM_WRITE, &header);
+	if (file == nullptr) {
+		u::log::print("[waveManager::save] unable to open %s for exporting: %s\n",
+			path.c_str(), sf_strerror(file));
+		sf_close(fileIn);
+		return G_RES_ERR_IO;
+	}
+
+	std::vector<float> chunk(w.getRate() * header.channels);
+	sf_count_t frames;
+	while ((frames = sf_readf_float(fileIn, chunk.data(), w.getRate())) > 0)
+		if (sf_writef_float(file, chunk.data(), frames) != frames)
+			u::log::print("[waveManager::save] warning: incomplete write!\n");
+
+	sf_close(fileIn);
+	sf_close(file);
+
+	return G_RES_OK;
+}
 }; // {anonymous}
 
 
@@ -85,7 +166,7 @@ void init()
 /* -------------------------------------------------------------------------- */
 
 
-Result createFromFile(const std::string& path, ID id)
+Result createFromFile(const std::string& path, ID id, bool stream)
 {
 	if (path == "" || u::fs::isDir(path)) {
 		u::log::print("[waveManager::create] malformed path (was '%s')\n", path.c_str());
@@ -108,19 +189,66 @@ Result createFromFile(const std::string& path, ID id)
 		return { G_RES_ERR_WRONG_DATA };
 	}
 
-	waveId_.set(id);
+	ID waveId = makeId_(id);
 
-	std::unique_ptr<Wave> wave = std::make_unique<Wave>(waveId_.get(id));
-	wave->alloc(header.frames, header.channels, header.samplerate, getBits_(header), path);
+	bool streamed = stream && isStreamable_(header);
 
-	if (sf_readf_float(fileIn, wave->getFrame(0), header.frames) != header.frames)
-		u::log::print("[waveManager::create] warning: incomplete read!\n");
+	/* Resident Waves might be in the cache already, decoded and converted to the
+	current sample rate. */
+
+	waveCache::Key key = 0;
+	if (!streamed && waveCache::isEnabled()) {
+		key = waveCache::makeKey(path, conf::samplerate, conf::rsmpQuality);
+		std::unique_ptr<Wave> wave = waveCache::load(key, waveId, path);
+		if (wave != nullptr) {
+			sf_close(fileIn);
+			return { G_RES_OK, std::move(wave) };
+		}
+	}
+
+	/* Streamed Waves: read only the first part, the rest will come from the 
+	disk stream. */
+
+	sf_count_t frames = header.frames;
+	if (streamed)
+		frames = std::min<sf_count_t>(frames, conf::streamPreload * header.samplerate);
+
+	std::unique_ptr<Wave> wave = std::make_unique<Wave>(waveId);
+	wave->alloc(frames, header.channels, header.samplerate, getBits_(header), path);
+
+	for (sf_count_t f=0; f<frames; f+=G_WAVE_BLOCK_SIZE) {
+		sf_count_t count = std::min<sf_count_t>(G_WAVE_BLOCK_SIZE, frames - f);
+		if (sf_readf_float(fileIn, wave->editFrame(f), count) != count) {
+			u::log::print("[waveManager::create] warning: incomplete read!\n");
+			break;
+		}
+	}
 
 	sf_close(fileIn);
 
 	if (header.channels == 1 && !wfx::monoToStereo(*wave))
 		return { G_RES_ERR_PROCESSING };
 
+	if (streamed) {
+		auto s = std::make_shared<WaveStream>(path, frames, 
+			G_STREAM_BUFFER_SECONDS * header.samplerate);
+		if (!s->isOpen())
+			return { G_RES_ERR_IO };
+		wave->setStream(s);
+		u::log::print("[waveManager::create] Wave will be streamed, %d frames preloaded\n", 
+			static_cast<int>(frames));
+	}
+	else {
+		if (wave->getRate() != conf::samplerate) {
+			u::log::print("[waveManager::create] input rate (%d) != system rate (%d), conversion needed\n",
+				wave->getRate(), conf::samplerate);
+			int res = resample(*wave, conf::rsmpQuality, conf::samplerate);
+			if (res != G_RES_OK)
+				return { res };
+		}
+		waveCache::store(key, *wave);
+	}
+
 	u::log::print("[waveManager::create] new Wave created, %d frames\n", wave->getSize());
 
 	return { G_RES_OK, std::move(wave) };
@@ -132,7 +260,7 @@ Result createFromFile(const std::string& path, ID id)
 std::unique_ptr<Wave> createEmpty(int frames, int channels, int samplerate, 
 	const std::string& name)
 {
-	std::unique_ptr<Wave> wave = std::make_unique<Wave>(waveId_.get());
+	std::unique_ptr<Wave> wave = std::make_unique<Wave>(makeId_());
 	wave->alloc(frames, channels, samplerate, G_DEFAULT_BIT_DEPTH, name);
 	wave->setLogical(true);
 
@@ -148,12 +276,16 @@ std::unique_ptr<Wave> createEmpty(int frames, int channels, int samplerate,
 
 std::unique_ptr<Wave> createFromWave(const Wave& src, int a, int b)
 {
-	int channels = src.getChannels();
-	int frames   = b - a;
+	assert(!src.isStreamed());
+
+	int frames = b - a;
+
+	/* Share the source data and drop the pieces outside the a - b range: no 
+	audio is copied until one of the two Waves gets edited. */
 
-	std::unique_ptr<Wave> wave = std::make_unique<Wave>(waveId_.get());
-	wave->alloc(frames, channels, src.getRate(), src.getBits(), src.getPath());
-	wave->copyData(src.getFrame(a), frames);
+	std::unique_ptr<Wave> wave = std::make_unique<Wave>(src);
+	wave->id = makeId_();
+	wave->trim(a, b);
 	wave->setLogical(true);
 
 	u::log::print("[waveManager::createFromWave] new Wave created, %d frames\n", frames);
@@ -179,11 +311,17 @@ int resample(Wave& w, int quality, int samplerate)
 	float ratio = samplerate / (float) w.getRate();
 	int newSizeFrames = ceil(w.getSize() * ratio);
 
+	/* libsamplerate wants contiguous input data. */
+
+	AudioBuffer oldData;
+	oldData.alloc(w.getSize(), w.getChannels());
+	w.read(0, w.getSize(), oldData[0]);
+
 	AudioBuffer newData;
 	newData.alloc(newSizeFrames, w.getChannels());
 
 	SRC_DATA src_data;
-	src_data.data_in       = w.getFrame(0);
+	src_data.data_in       = oldData[0];
 	src_data.input_frames  = w.getSize();
 	src_data.data_out      = newData[0];
 	src_data.output_frames = newSizeFrames;
@@ -209,6 +347,9 @@ int resample(Wave& w, int quality, int samplerate)
 
 int save(const Wave& w, const std::string& path)
 {
+	if (w.isStreamed())
+		return saveStreamed_(w, path);
+
 	SF_INFO header;
 	header.samplerate = w.getRate();
 	header.channels   = w.getChannels();
@@ -221,8 +362,11 @@ int save(const Wave& w, const std::string& path)
 		return G_RES_ERR_IO;
 	}
 
-	if (sf_writef_float(file, w.getFrame(0), w.getSize()) != w.getSize())
-		u::log::print("[waveManager::save] warning: incomplete write!\n");
+	w.forEachBlock(0, w.getSize(), [file](const float* data, Frame frames)
+	{
+		if (sf_writef_float(file, data, frames) != frames)
+			u::log::print("[waveManager::save] warning: incomplete write!\n");
+	});
 
 	sf_close(file);
 
@@ -56,9 +56,10 @@ void init();
 
 /* create
 Creates a new Wave object with data read from file 'path'. Takes an optional
-'id' parameter for patch persistence. */
+'id' parameter for patch persistence. Files bigger than conf::streamThreshold 
+become streamed Waves, unless 'stream' is false. */
 
-Result createFromFile(const std::string& path, ID id=0);
+Result createFromFile(const std::string& path, ID id=0, bool stream=true);
 
 /* createEmpty
 Creates a new silent Wave object. */
@@ -67,7 +68,8 @@ std::unique_ptr<Wave> createEmpty(int frames, int channels, int samplerate,
     const std::string& name);
 
 /* createFromWave
-Creates a new Wave from an existing one, copying the data in range a - b. */
+Creates a new Wave from an existing one, sharing the data in range a - b. The
+data is copied only when one of the two Waves gets edited. */
 
 std::unique_ptr<Wave> createFromWave(const Wave& src, int a, int b);
 
@@ -79,7 +81,8 @@ std::unique_ptr<Wave> createFromPatch(const patch::Wave& w);
 int resample(Wave& w, int quality, int samplerate); 
 
 /* save
-Writes Wave data to file 'path'. Only 'wav' format is supported for now. */
+Writes Wave data to file 'path'. Only 'wav' format is supported for now. 
+Streamed Waves are copied from their original file. */
 
 int save(const Wave& w, const std::string& path);
 
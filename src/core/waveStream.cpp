@@ -0,0 +1,241 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include "utils/log.h"
+#include "core/const.h"
+#include "core/diskReader.h"
+#include "waveStream.h"
+
+
+namespace giada {
+namespace m 
+{
+namespace
+{
+/* CHUNK
+Max frames read from disk in one go. */
+
+constexpr Frame CHUNK = 16384;
+
+/* HISTORY
+Frames behind the read position kept in the ring buffer, so that the reader
+can step back a little without seeking (e.g. the resampler's filter taps). */
+
+constexpr Frame HISTORY = 1024;
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+WaveStream::WaveStream(const std::string& path, Frame preload, Frame capacity)
+: m_path        (path),
+  m_file        (nullptr),
+  m_fileChannels(0),
+  m_size        (0),
+  m_capacity    (capacity),
+  m_ring        (capacity * G_MAX_IO_CHANS, 0.0f),
+  m_chunk       (CHUNK * G_MAX_IO_CHANS),
+  m_seq         (1),
+  m_base        (preload),
+  m_readPos     (preload),
+  m_reqSeq      (1),
+  m_reqFrame    (preload),
+  m_consumed    (preload),
+  m_ackSeq      (0),
+  m_writeFrame  (preload),
+  m_writePos    (preload),
+  m_underruns   (0)
+{
+	assert(capacity > HISTORY + CHUNK);
+
+	SF_INFO header;
+	m_file = sf_open(path.c_str(), SFM_READ, &header);
+	if (m_file == nullptr) {
+		u::log::print("[WaveStream] unable to open %s: %s\n", path.c_str(), sf_strerror(nullptr));
+		return;
+	}
+	m_fileChannels = header.channels;
+	m_size         = header.frames;
+
+	diskReader::add(this);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+WaveStream::~WaveStream()
+{
+	if (m_file == nullptr)
+		return;
+	diskReader::remove(this);
+	sf_close(m_file);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool        WaveStream::isOpen() const       { return m_file != nullptr; }
+std::string WaveStream::getPath() const      { return m_path; }
+Frame       WaveStream::getSize() const      { return m_size; }
+uint64_t    WaveStream::getUnderruns() const { return m_underruns.load(); }
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool WaveStream::isCued_(Frame f) const
+{
+	return f >= m_base && f <= m_readPos && f >= m_readPos - HISTORY;
+}
+
+
+bool WaveStream::isReady_(Frame f) const
+{
+	return m_ackSeq.load(std::memory_order_acquire) == m_seq && 
+	       m_writeFrame.load(std::memory_order_acquire) >= f;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WaveStream::seek_(Frame f)
+{
+	m_base    = f;
+	m_readPos = f;
+	m_consumed.store(f, std::memory_order_relaxed);
+	m_reqFrame.store(f, std::memory_order_relaxed);
+	m_reqSeq.store(++m_seq, std::memory_order_release);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WaveStream::cue(Frame f)
+{
+	if (!isCued_(f))
+		seek_(f);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WaveStream::read(Frame start, Frame count, float* out)
+{
+	assert(start >= 0 && start + count <= m_size);
+	assert(count <= m_capacity - HISTORY);
+
+	cue(start);
+
+	/* Rendering offline: there's no deadline, so wait for the data instead of 
+	dropping it. The reader fills the ring buffer by itself, in case the disk 
+	reader thread is not running. */
+
+	if (diskReader::isBlocking())
+		while (!isReady_(start + count))
+			fill();
+
+	Frame avail = 0;
+	if (m_ackSeq.load(std::memory_order_acquire) == m_seq)
+		avail = std::max(0, std::min(count, m_writeFrame.load(std::memory_order_acquire) - start));
+
+	for (Frame i = 0; i < avail; ) {
+		Frame k = (start + i) % m_capacity;
+		Frame n = std::min(avail - i, m_capacity - k);
+		std::memcpy(out + i * G_MAX_IO_CHANS, m_ring.data() + k * G_MAX_IO_CHANS, 
+			n * G_MAX_IO_CHANS * sizeof(float));
+		i += n;
+	}
+
+	if (avail < count) {
+		std::fill(out + avail * G_MAX_IO_CHANS, out + count * G_MAX_IO_CHANS, 0.0f);
+		m_underruns.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	m_readPos = std::max(m_readPos, start + count);
+	m_consumed.store(std::max(m_base, m_readPos - HISTORY), std::memory_order_release);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool WaveStream::fill()
+{
+	assert(m_file != nullptr);
+
+	std::lock_guard<std::mutex> lock(m_fillMutex);
+
+	/* A new request from the reader: start over from the requested frame. Data
+	already in the ring buffer is discarded. */
+
+	uint32_t seq = m_reqSeq.load(std::memory_order_acquire);
+	if (seq != m_ackSeq.load(std::memory_order_relaxed)) {
+		m_writePos = std::min(m_reqFrame.load(std::memory_order_relaxed), m_size);
+		sf_seek(m_file, m_writePos, SEEK_SET);
+		m_writeFrame.store(m_writePos, std::memory_order_release);
+		m_ackSeq.store(seq, std::memory_order_release);
+	}
+
+	Frame consumed = m_consumed.load(std::memory_order_acquire);
+	Frame space    = std::max(0, std::min(m_capacity, m_capacity - (m_writePos - consumed)));
+	Frame frames   = std::min({ space, CHUNK, m_size - m_writePos });
+	if (frames <= 0)
+		return false;
+
+	sf_count_t got = sf_readf_float(m_file, m_chunk.data(), frames);
+	if (got < frames)
+		std::fill(m_chunk.begin() + std::max<sf_count_t>(got, 0) * m_fileChannels, 
+			m_chunk.end(), 0.0f);
+
+	for (Frame i = 0; i < frames; i++) {
+		Frame k = (m_writePos + i) % m_capacity;
+		if (m_fileChannels == 1) {
+			m_ring[k * 2]     = m_chunk[i];
+			m_ring[k * 2 + 1] = m_chunk[i];
+		}
+		else {
+			m_ring[k * 2]     = m_chunk[i * 2];
+			m_ring[k * 2 + 1] = m_chunk[i * 2 + 1];
+		}
+	}
+
+	m_writePos += frames;
+	m_writeFrame.store(m_writePos, std::memory_order_release);
+	return true;
+}
+}} // giada::m::
@@ -0,0 +1,141 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_WAVE_STREAM_H
+#define G_WAVE_STREAM_H
+
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sndfile.h>
+#include "core/types.h"
+
+
+namespace giada {
+namespace m 
+{
+/* WaveStream
+Audio data of a long Wave, read from disk while playing. The disk reader thread
+keeps a ring buffer filled ahead of the read position; the audio thread reads 
+from it without locks. Jumping somewhere else (a seek) makes the disk reader 
+start over from the new position: until it catches up the stream plays silence. 
+The first part of the Wave is not read from here: it lives in memory, see 
+Wave::read(). Data is always returned as stereo. */
+
+class WaveStream
+{
+public:
+
+	/* WaveStream
+	Opens file 'path'. 'preload' is the first frame served by the stream, 
+	'capacity' the ring buffer size in frames. */
+
+	WaveStream(const std::string& path, Frame preload, Frame capacity);
+	WaveStream(const WaveStream&) = delete;
+	~WaveStream();
+
+	bool isOpen() const;
+	std::string getPath() const;
+	Frame getSize() const;
+	uint64_t getUnderruns() const;
+
+	/* cue
+	Makes sure the stream is ready to deliver frame 'f' next, seeking if 
+	necessary. Audio thread only. */
+
+	void cue(Frame f);
+
+	/* read
+	Copies 'count' frames starting from 'start' to 'out'. Missing frames are 
+	filled with silence. Audio thread only. */
+
+	void read(Frame start, Frame count, float* out);
+
+	/* fill
+	Reads the next chunk of data from disk into the ring buffer, if there is 
+	room for it. Returns true if something has been read. Disk reader thread 
+	only. */
+
+	bool fill();
+
+private:
+
+	/* isCued_
+	True if frame 'f' can be read without seeking: it belongs to the current 
+	request and it has not been released to the disk reader yet. */
+
+	bool isCued_(Frame f) const;
+
+	/* isReady_
+	True if the disk reader has read everything up to frame 'f'. */
+
+	bool isReady_(Frame f) const;
+
+	void seek_(Frame f);
+
+	std::string        m_path;
+	SNDFILE*           m_file;
+	int                m_fileChannels;
+	Frame              m_size;
+	Frame              m_capacity;
+	std::vector<float> m_ring;
+	std::vector<float> m_chunk;
+	std::mutex         m_fillMutex;
+
+	/* m_seq, m_base, m_readPos
+	Reader side: sequence number of the current request, frame it started 
+	from and the furthest frame read so far. */
+
+	uint32_t m_seq;
+	Frame    m_base;
+	Frame    m_readPos;
+
+	/* m_reqSeq, m_reqFrame, m_consumed
+	Written by the reader: the last request (a seek) and the frame before which 
+	the ring buffer can be overwritten. */
+
+	std::atomic<uint32_t> m_reqSeq;
+	std::atomic<Frame>    m_reqFrame;
+	std::atomic<Frame>    m_consumed;
+
+	/* m_ackSeq, m_writeFrame
+	Written by the disk reader: the request it is serving and the frame it has 
+	read up to. */
+
+	std::atomic<uint32_t> m_ackSeq;
+	std::atomic<Frame>    m_writeFrame;
+	Frame                 m_writePos;
+
+	std::atomic<uint64_t> m_underruns;
+};
+}} // giada::m::
+
+
+#endif
@@ -0,0 +1,192 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#include <cassert>
+#include <chrono>
+#include "workerPool.h"
+
+
+namespace giada {
+namespace m
+{
+namespace
+{
+constexpr uint32_t CLOSED = 0xFFFFFFFF;
+
+
+/* -------------------------------------------------------------------------- */
+
+
+uint64_t makeState_(uint32_t generation, uint32_t index)
+{
+	return (static_cast<uint64_t>(generation) << 32) | index;
+}
+
+uint32_t getGeneration_(uint64_t state) { return state >> 32; }
+uint32_t getIndex_(uint64_t state)      { return state & 0xFFFFFFFF; }
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+WorkerPool::WorkerPool()
+: m_running(false),
+  m_state  (0),
+  m_count  (0),
+  m_done   (0),
+  m_job    (nullptr),
+  m_data   (nullptr)
+{
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+WorkerPool::~WorkerPool()
+{
+	stop();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WorkerPool::start(int workers)
+{
+	stop();
+	m_running.store(true);
+	for (int i=0; i<workers; i++)
+		m_workers.emplace_back(&WorkerPool::worker_, this);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WorkerPool::stop()
+{
+	if (!m_running.load())
+		return;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_running.store(false);
+	}
+	m_cond.notify_all();
+	for (std::thread& t : m_workers)
+		t.join();
+	m_workers.clear();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+int WorkerPool::countWorkers() const
+{
+	return m_workers.size();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WorkerPool::run(size_t count, Job job, void* data)
+{
+	if (count == 0)
+		return;
+
+	/* Close the previous batch first, so that a late worker can't grab a job
+	while job, data and count are being replaced. */
+
+	uint32_t generation = getGeneration_(m_state.load()) + 2;
+	m_state.store(makeState_(generation - 1, CLOSED));
+
+	m_job.store(job);
+	m_data.store(data);
+	m_count.store(count);
+	m_done.store(0);
+
+	/* Publishing the new generation makes the batch visible to workers. The
+	mutex is never taken here: a worker that misses the notification will wake
+	up on its own timeout, while the caller is doing the jobs anyway. */
+
+	m_state.store(makeState_(generation, 0));
+	m_cond.notify_all();
+
+	work_(generation);
+
+	while (m_done.load() < count)
+		; // Busy wait: the last jobs are being finished by the workers
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WorkerPool::work_(uint32_t generation)
+{
+	while (true) {
+		uint64_t state = m_state.load();
+		if (getGeneration_(state) != generation || getIndex_(state) >= m_count.load())
+			return;
+		if (!m_state.compare_exchange_weak(state, state + 1))
+			continue;
+		
+		/* The job is ours now. The next batch can't overwrite job and data 
+		before m_done reaches the count, so reading them here is safe. */
+
+		m_job.load()(getIndex_(state), m_data.load());
+		m_done.fetch_add(1);
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WorkerPool::worker_()
+{
+	uint32_t generation = getGeneration_(m_state.load());
+
+	while (m_running.load()) {
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_cond.wait_for(lock, std::chrono::milliseconds(1), [&]()
+			{
+				return !m_running.load() || getGeneration_(m_state.load()) != generation;
+			});
+		}
+		generation = getGeneration_(m_state.load());
+		work_(generation);
+	}
+}
+}} // giada::m::
@@ -0,0 +1,113 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#ifndef G_WORKER_POOL_H
+#define G_WORKER_POOL_H
+
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace giada {
+namespace m
+{
+/* WorkerPool
+Pool of threads that run a batch of independent jobs in parallel, meant to be 
+driven by the audio thread. The calling thread takes part in the work, so a 
+pool with zero workers just runs everything serially. Running a batch never 
+allocates nor takes a lock: jobs are grabbed with an atomic counter. Idle 
+workers park on a condition variable the caller only notifies. */
+
+class WorkerPool
+{
+public:
+
+	/* Job
+	Plain function pointer (no std::function, it might allocate): 'i' is the 
+	index of the job in the batch, 'data' is the user data passed to run(). */
+
+	using Job = void(*)(size_t i, void* data);
+
+	WorkerPool();
+	WorkerPool(const WorkerPool&) = delete;
+	~WorkerPool();
+
+	/* start
+	Spawns 'workers' threads. Call it from a non real-time thread. */
+
+	void start(int workers);
+
+	/* stop
+	Joins all workers. Call it from a non real-time thread. */
+
+	void stop();
+
+	/* run
+	Runs job(i, data) for each i in [0, count) and returns when they are all 
+	done. Must not be called concurrently from two threads. */
+
+	void run(size_t count, Job job, void* data);
+
+	int countWorkers() const;
+
+private:
+
+	void worker_();
+
+	/* work_
+	Grabs and runs jobs belonging to batch 'generation', until there are no 
+	more left. */
+
+	void work_(uint32_t generation);
+
+	std::vector<std::thread> m_workers;
+	std::atomic<bool>        m_running;
+
+	/* m_state
+	Generation of the current batch in the high 32 bits, index of the next job
+	to grab in the low 32 bits. Keeping both in a single atomic word prevents a 
+	late worker from grabbing a job of the following batch. */
+
+	std::atomic<uint64_t> m_state;
+	std::atomic<size_t>   m_count;
+	std::atomic<size_t>   m_done;
+	std::atomic<Job>      m_job;
+	std::atomic<void*>    m_data;
+
+	std::mutex              m_mutex;
+	std::condition_variable m_cond;
+};
+}} // giada::m::
+
+
+#endif
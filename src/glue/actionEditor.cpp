@@ -87,7 +87,7 @@ void recordNonFirstEnvelopeAction_(ID channelId, Frame frame, int value)
 	namespace mr = m::recorder;
 
 	const m::Action a1 = mr::getClosestAction(channelId, frame, m::MidiEvent::ENVELOPE);
-	const m::Action a3 = a1.next != nullptr ? *a1.next : m::Action{};
+	const m::Action a3 = mr::getAction(a1.nextId);
 
 	assert(a1.isValid());
 	assert(a3.isValid());
@@ -163,14 +163,15 @@ void deleteMidiAction(ID channelId, const m::Action& a)
 	/* Send a note-off first in case we are deleting it in a middle of a 
 	key_on/key_off sequence. Check if 'next' exist first: could be orphaned. */
 	
-	if (a.next != nullptr) {
+	if (a.nextId != 0) {
+		const m::Action next = mr::getAction(a.nextId);
 		m::model::onGet(m::model::channels, channelId, [&](m::Channel& c)
 		{
 			m::MidiChannel& mc = static_cast<m::MidiChannel&>(c);
 			if (mc.isPlaying() && !mc.mute)
-				mc.sendMidi(a.next->event, 0);
+				mc.sendMidi(next.event, 0);
 		});
-		mr::deleteAction(a.id, a.next->id);
+		mr::deleteAction(a.id, a.nextId);
 	}
 	else
 		mr::deleteAction(a.id);
@@ -186,7 +187,7 @@ void updateMidiAction(ID channelId, const m::Action& a, int note, int velocity,
 {
 	namespace mr = m::recorder;
 
-	mr::deleteAction(a.id, a.next->id);
+	mr::deleteAction(a.id, a.nextId);
 	recordMidiAction(channelId, note, velocity, f1, f2);
 }
 
@@ -223,7 +224,7 @@ void updateSampleAction(ID channelId, const m::Action& a, int type,
 	namespace mr = m::recorder;	
 
 	if (isSinglePressMode_(channelId))
-		mr::deleteAction(a.id, a.next->id);
+		mr::deleteAction(a.id, a.nextId);
 	else
 		mr::deleteAction(a.id);
 
@@ -239,8 +240,8 @@ void deleteSampleAction(ID channelId, const m::Action& a)
 	namespace mr = m::recorder;
 	namespace cr = c::recorder;
 
-	if (a.next != nullptr) // For ChannelMode::SINGLE_PRESS combo
-		mr::deleteAction(a.next->id);
+	if (a.nextId != 0) // For ChannelMode::SINGLE_PRESS combo
+		mr::deleteAction(a.nextId);
 	mr::deleteAction(a.id);
 
 	recorder::updateChannel(channelId, /*updateActionEditor=*/false);
@@ -294,13 +295,13 @@ void deleteEnvelopeAction(ID channelId, const m::Action& a)
 		mr::clearActions(channelId, a.event.getStatus());
 	}
 	else {
-		assert(a.prev != nullptr);
-		assert(a.next != nullptr);
-		
-		const m::Action a1     = *a.prev;
-		const m::Action a1prev = *a1.prev;
-		const m::Action a3     = *a.next; 
-		const m::Action a3next = *a3.next; 
+		const m::Action a1     = mr::getAction(a.prevId);
+		const m::Action a1prev = mr::getAction(a1.prevId);
+		const m::Action a3     = mr::getAction(a.nextId); 
+		const m::Action a3next = mr::getAction(a3.nextId); 
+
+		assert(a1.isValid());
+		assert(a3.isValid());
 
 		/* Original status:   a1--->a--->a3
 		   Modified status:   a1-------->a3 
@@ -214,6 +214,18 @@ void setInputMonitor(ID channelId, bool value)
 /* -------------------------------------------------------------------------- */
 
 
+void setResampler(ID channelId, ResamplerQuality q)
+{
+	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& c) 
+	{ 
+		static_cast<m::SampleChannel&>(c).resampler.setQuality(q);
+	});
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void cloneChannel(ID channelId)
 {
 	m::mh::cloneChannel(channelId);
@@ -313,13 +325,13 @@ void toggleSolo(ID channelId)
 /* -------------------------------------------------------------------------- */
 
 
-void start(ID channelId, int velocity, bool record)
+void start(ID channelId, int velocity, bool record, Frame localFrame)
 {
 	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& ch)
 	{
 		if (record && !ch.recordStart(m::clock::canQuantize()))
 			return;
-		ch.start(/*localFrame=*/0, m::clock::canQuantize(), velocity); // Frame 0: user-generated event
+		ch.start(localFrame, m::clock::canQuantize(), velocity);
 	});
 }
 
@@ -327,13 +339,13 @@ void start(ID channelId, int velocity, bool record)
 /* -------------------------------------------------------------------------- */
 
 
-void kill(ID channelId, bool record)
+void kill(ID channelId, bool record, Frame localFrame)
 {
 	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& ch)
 	{
 		if (record && !ch.recordKill())
 			return;
-		ch.kill(/*localFrame=*/0); // Frame 0: user-generated event
+		ch.kill(localFrame);
 	});
 }
 
@@ -83,6 +83,7 @@ Sets several channel properties. */
 void setArm(ID channelId, bool value);
 void toggleArm(ID channelId);
 void setInputMonitor(ID channelId, bool value);
+void setResampler(ID channelId, ResamplerQuality q);
 void setMute(ID channelId, bool value);
 void toggleMute(ID channelId);
 void setSolo(ID channelId, bool value);
@@ -93,8 +94,11 @@ void setPitch(ID channelId, float val, bool gui=true);
 void setPan(ID channelId, float val, bool gui=true);
 void setSampleMode(ID channelId, ChannelMode m);
 
-void start(ID channelId, int velocity, bool record);
-void kill(ID channelId, bool record);
+/* start, kill
+'localFrame' is the frame in the next buffer the event takes place at. */
+
+void start(ID channelId, int velocity, bool record, Frame localFrame=0);
+void kill(ID channelId, bool record, Frame localFrame=0);
 void stop(ID channelId);
 
 /* toggleReadingRecs
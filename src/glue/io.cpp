@@ -65,15 +65,15 @@ namespace giada {
 namespace c {
 namespace io 
 {
-void keyPress(ID channelId, bool ctrl, bool shift, int velocity)
+void keyPress(ID channelId, bool ctrl, bool shift, int velocity, Frame localFrame)
 {
 	if (ctrl)
 		c::channel::toggleMute(channelId);
 	else
 	if (shift)
-		c::channel::kill(channelId, /*record=*/true);
+		c::channel::kill(channelId, /*record=*/true, localFrame);
 	else
-		c::channel::start(channelId, velocity, /*record=*/true);
+		c::channel::start(channelId, velocity, /*record=*/true, localFrame);
 }
 
 
@@ -123,6 +123,7 @@ void midiLearn(m::MidiEvent e, std::atomic<uint32_t>& param, ID channelId)
 	}
 
 	param.store(e.getRawNoVelocity());
+	m::midiDispatcher::invalidate();
 	m::midiDispatcher::stopMidiLearn();
 
 	Fl::lock();
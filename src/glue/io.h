@@ -43,9 +43,12 @@ namespace c {
 namespace io 
 {
 /* keyPress / keyRelease
-Handle the key pressure, either via mouse/keyboard or MIDI. */
+Handle the key pressure, either via mouse/keyboard or MIDI. 'localFrame' is 
+where the key press falls in the next buffer: MIDI events are scheduled at 
+the frame they have been received at, user interactions at frame 0. */
 
-void keyPress  (ID channelId, bool ctrl, bool shift, int velocity);
+void keyPress  (ID channelId, bool ctrl, bool shift, int velocity, 
+	Frame localFrame=0);
 void keyRelease(ID channelId, bool ctrl, bool shift);
 
 /* setSampleChannelKey
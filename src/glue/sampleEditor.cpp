@@ -317,6 +317,7 @@ void reload(ID channelId, ID waveId)
 		m::SampleChannel& sc = static_cast<m::SampleChannel&>(c);
 		newWaveId = sc.waveId;
 	});
+	m::mh::makeWaveResident(newWaveId);
 
 	getSampleEditorWindow()->setWaveId(newWaveId);
 	getSampleEditorWindow()->rebuild();
@@ -25,7 +25,11 @@
  * -------------------------------------------------------------------------- */
 
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <thread>
+#include <vector>
 #include "core/model/model.h"
 #include "core/channels/channel.h"
 #include "core/channels/sampleChannel.h"
@@ -68,31 +72,55 @@ namespace storage
 {
 namespace
 {
+/* WaveJob
+A Wave to be written to the project folder. */
+
+struct WaveJob
+{
+	const m::Wave* wave;
+	ID             id;
+	std::string    path;
+	int            res;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+
 std::string makeWavePath_(const std::string& base, const m::Wave& w, int k)
 {
 	return base + G_SLASH + w.getBasename(/*ext=*/false) + "-" + std::to_string(k) + "." +  w.getExtension();
 } 
 
 
-bool isWavePathUnique_(const m::Wave& skip, const std::string& path)
+/* isWavePathUnique_
+Tells whether 'path' is not used by other Waves, nor by the ones already 
+scheduled for writing in 'jobs'. */
+
+bool isWavePathUnique_(const m::Wave& skip, const std::string& path, 
+	const std::vector<WaveJob>& jobs)
 {
 	m::model::WavesLock l(m::model::waves);
 
 	for (const m::Wave* w : m::model::waves)
 		if (w->id != skip.id && w->getPath() == path)
 			return false;
+	for (const WaveJob& job : jobs)
+		if (job.path == path)
+			return false;
 	return true;
 }
 
-std::string makeUniqueWavePath_(const std::string& base, const m::Wave& w)
+std::string makeUniqueWavePath_(const std::string& base, const m::Wave& w,
+	const std::vector<WaveJob>& jobs)
 {
 	std::string path = base + G_SLASH + w.getBasename(/*ext=*/true);
-	if (isWavePathUnique_(w, path))
+	if (isWavePathUnique_(w, path, jobs))
 		return path;
 
 	int k = 0;
 	path = makeWavePath_(base, w, k);
-	while (!isWavePathUnique_(w, path))
+	while (!isWavePathUnique_(w, path, jobs))
 		path = makeWavePath_(base, w, k++);
 	
 	return path;
@@ -117,13 +145,76 @@ bool savePatch_(const std::string& path, const std::string& name, bool isProject
 /* -------------------------------------------------------------------------- */
 
 
+/* isWaveDirty_
+Tells whether Wave 'w' must be written to 'path'. Untouched Waves already 
+saved there during a previous save can be skipped. */
+
+bool isWaveDirty_(const m::Wave& w, const std::string& path)
+{
+	return w.isLogical() || w.isEdited() || w.getPath() != path || 
+	       !u::fs::fileExists(path);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void saveWavesToProject_(const std::string& base)
 {
-	for (size_t i = 0; i < m::model::waves.size(); i++) {
-		m::model::onSwap(m::model::waves, m::model::getId(m::model::waves, i), [&](m::Wave& w)
+	std::vector<WaveJob> jobs;
+
+	/* Waves are read in place by the workers: the lock keeps them alive until
+	the whole batch is over. */
+
+	m::model::WavesLock l(m::model::waves);
+
+	for (const m::Wave* w : m::model::waves) {
+		std::string path = makeUniqueWavePath_(base, *w, jobs);
+		if (isWaveDirty_(*w, path))
+			jobs.push_back({ w, w->id, path, G_RES_OK });
+	}
+
+	u::log::print("[saveWavesToProject_] %d Waves to write, %d unchanged\n", 
+		static_cast<int>(jobs.size()), 
+		static_cast<int>(m::model::waves.size() - jobs.size()));
+
+	if (jobs.empty())
+		return;
+
+	/* Jobs are grabbed with an atomic counter. The calling thread takes part in
+	the work too, hence the - 1, then sleeps in join() until the slowest file
+	write is over. */
+
+	int threads = m::conf::loadThreads > 0 ? m::conf::loadThreads : std::thread::hardware_concurrency();
+	
+	std::atomic<size_t> next(0);
+	auto work = [&]()
+	{
+		for (size_t i = next++; i < jobs.size(); i = next++)
+			jobs[i].res = m::waveManager::save(*jobs[i].wave, jobs[i].path);
+	};
+
+	std::vector<std::thread> workers;
+	for (int i = 1; i < std::min<int>(threads, jobs.size()); i++)
+		workers.emplace_back(work);
+	work();
+	for (std::thread& t : workers)
+		t.join();
+
+	/* Published Waves are never altered in place: swap in a copy holding the
+	new path and flags. A copy shares the audio data, only its piece list is 
+	cloned. */
+
+	for (WaveJob& job : jobs) {
+		if (job.res != G_RES_OK) {
+			u::log::print("[saveWavesToProject_] unable to save %s\n", job.path.c_str());
+			continue;
+		}
+		m::model::onSwap(m::model::waves, job.id, [&](m::Wave& w)
 		{
-			w.setPath(makeUniqueWavePath_(base, w));
-			m::waveManager::save(w, w.getPath()); // TODO - error checking	
+			w.setPath(job.path);
+			w.setLogical(false);
+			w.setEdited(false);
 		});
 	}
 }
@@ -197,7 +288,14 @@ void loadPatch(void* data)
 
 	m::init::reset();
 
-	if (m::patch::read(fileToLoad, basePath) != G_PATCH_OK) {
+	float loaded = 0.0f;
+	auto progress = [browser, &loaded](float v)
+	{
+		browser->setStatusBar(v - loaded);
+		loaded = v;
+	};
+
+	if (m::patch::read(fileToLoad, basePath, progress) != G_PATCH_OK) {
 		v::gdAlert("This patch is unreadable.");
 		m::mixer::enable();
 		return;
@@ -338,7 +436,7 @@ void saveSample(void* data)
 	wave->setLogical(false);
 	wave->setEdited(false);
 
-	m::model::waves.swap(std::move(wave), waveIndex);
+	m::model::waves.swapById(std::move(wave), waveId);
 
 	/* Finally close the browser. */
 
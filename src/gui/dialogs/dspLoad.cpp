@@ -0,0 +1,207 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#include <algorithm>
+#include <cstdio>
+#include "core/model/model.h"
+#include "core/mixer.h"
+#include "core/const.h"
+#include "utils/gui.h"
+#include "gui/elems/basics/button.h"
+#include "gui/elems/basics/box.h"
+#include "dspLoad.h"
+
+
+namespace giada {
+namespace v 
+{
+namespace
+{
+const char* stageNames_[] = { "Line in", "Sequencer", "Render", "Finalize", "Limit" };
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::string printTime_(m::profiler::Time t, m::profiler::Time deadline)
+{
+	char buf[64];
+	snprintf(buf, sizeof(buf), "%.3f ms (%.1f%%)", t / 1000000.0, 
+		deadline == 0 ? 0.0 : t * 100.0 / deadline);
+	return buf;
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+gdDspLoad::gdDspLoad()
+: gdWindow(360, 520, "DSP load"),
+  m_cycles(0)
+{
+	m_text  = new geBox(8, 8, w()-16, h()-44, "", (Fl_Align) (FL_ALIGN_LEFT | FL_ALIGN_TOP | FL_ALIGN_INSIDE | FL_ALIGN_CLIP));
+	m_close = new geButton(w()-88, h()-28, 80, 20, "Close");
+	end();
+
+	m_close->callback(cb_window_closer, (void*)this);
+
+	update();
+
+	u::gui::setFavicon(this);
+	show();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void gdDspLoad::refresh()
+{
+	if (++m_cycles < UPDATE_RATE)
+		return;
+	m_cycles = 0;
+	update();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::string gdDspLoad::printEntries_(const std::vector<m::profiler::Entry>& curr,
+	Entries& prev, m::profiler::Time deadline, 
+	const std::unordered_map<ID, std::string>& names) const
+{
+	/* Average time per buffer since the last update. Items that haven't been
+	processed in the meantime, or no longer exist, are skipped. */
+
+	std::vector<std::pair<m::profiler::Time, ID>> items;
+
+	for (const m::profiler::Entry& e : curr) {
+		const m::profiler::Entry old = prev.count(e.id) ? prev.at(e.id) : m::profiler::Entry{e.id, 0, 0};
+		prev[e.id] = e;
+		if (e.count == old.count || names.count(e.id) == 0)
+			continue;
+		items.push_back({ (e.time - old.time) / (e.count - old.count), e.id });
+	}
+
+	std::sort(items.rbegin(), items.rend());
+	if (items.size() > MAX_ITEMS)
+		items.resize(MAX_ITEMS);
+
+	std::string out;
+	for (const auto& item : items)
+		out += "    " + names.at(item.second) + ": " + printTime_(item.first, deadline) + "\n";
+	return out;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+#ifdef WITH_VST
+
+std::string gdDspLoad::printMidiDrops_(const std::unordered_map<ID, std::string>& names) const
+{
+	std::string out;
+
+	m::model::ChannelsLock l(m::model::channels);
+	for (const m::Channel* c : m::model::channels) {
+		uint32_t dropped = c->midiQueue->getDropped();
+		if (dropped == 0 || names.count(c->id) == 0)
+			continue;
+		out += "    " + names.at(c->id) + ": " + std::to_string(dropped) + "\n";
+	}
+
+	if (out.empty())
+		return "    None\n";
+	return out + "    (raise 'midi_queue_size' in the configuration file)\n";
+}
+
+#endif
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void gdDspLoad::update()
+{
+	m::profiler::Stats stats = m::profiler::getStats();
+
+	char buf[128];
+	snprintf(buf, sizeof(buf), 
+		"Load: %.1f%% (worst %.1f%%)\nDeadline: %.3f ms\nXruns: %llu - late buffers: %llu\n",
+		stats.load * 100.0, stats.worstLoad * 100.0, stats.deadline / 1000000.0,
+		(unsigned long long) stats.xruns, (unsigned long long) stats.late);
+
+	std::string body = buf;
+
+	body += "\nStages (average per buffer)\n";
+	for (int i = 0; i < m::profiler::STAGES; i++)
+		body += std::string("    ") + stageNames_[i] + ": " + printTime_(stats.stages[i], stats.deadline) + "\n";
+
+	std::unordered_map<ID, std::string> channelNames;
+	{
+		m::model::ChannelsLock l(m::model::channels);
+		for (const m::Channel* c : m::model::channels) {
+			if (c->id == m::mixer::MASTER_OUT_CHANNEL_ID)
+				channelNames[c->id] = "Master out";
+			else
+			if (c->id == m::mixer::MASTER_IN_CHANNEL_ID)
+				channelNames[c->id] = "Master in";
+			else
+				channelNames[c->id] = c->name.empty() ? "Channel " + std::to_string(c->id) : c->name;
+		}
+	}
+
+	body += "\nChannels (heaviest first)\n";
+	body += printEntries_(m::profiler::getChannels(), m_channels, stats.deadline, channelNames);
+
+#ifdef WITH_VST
+
+	std::unordered_map<ID, std::string> pluginNames;
+	{
+		m::model::PluginsLock l(m::model::plugins);
+		for (const m::Plugin* p : m::model::plugins)
+			pluginNames[p->id] = p->valid ? p->getName() : "Plug-in " + std::to_string(p->id);
+	}
+
+	body += "\nPlug-ins (heaviest first)\n";
+	body += printEntries_(m::profiler::getPlugins(), m_plugins, stats.deadline, pluginNames);
+
+	body += "\nMIDI events dropped (queue full)\n";
+	body += printMidiDrops_(channelNames);
+
+#endif
+
+	m_text->copy_label(body.c_str());
+	redraw();
+}
+}} // giada::v::
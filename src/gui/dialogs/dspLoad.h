@@ -0,0 +1,98 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#ifndef GD_DSP_LOAD_H
+#define GD_DSP_LOAD_H
+
+
+#include <string>
+#include <unordered_map>
+#include "core/profiler.h"
+#include "window.h"
+
+
+class geBox;
+class geButton;
+
+
+namespace giada {
+namespace v 
+{
+/* gdDspLoad
+Breakdown of the time spent in the audio callback: stages, channels and 
+plug-ins. Also reports MIDI events dropped by each channel. */
+
+class gdDspLoad : public gdWindow
+{
+public:
+
+	gdDspLoad();
+
+	void refresh() override;
+
+private:
+
+	using Entries = std::unordered_map<ID, m::profiler::Entry>;
+
+	/* UPDATE_RATE
+	Number of GUI refresh cycles between two updates of the text. */
+
+	static constexpr int UPDATE_RATE = 10;
+	static constexpr int MAX_ITEMS   = 10;
+
+	/* printEntries_
+	Prints the heaviest channels or plug-ins since the last update, given the
+	current totals 'curr' and the previous ones 'prev'. */
+
+	std::string printEntries_(const std::vector<m::profiler::Entry>& curr, 
+		Entries& prev, m::profiler::Time deadline, 
+		const std::unordered_map<ID, std::string>& names) const;
+
+#ifdef WITH_VST
+
+	/* printMidiDrops_
+	Prints the channels that lost incoming MIDI events because their queue was
+	full. */
+
+	std::string printMidiDrops_(const std::unordered_map<ID, std::string>& names) const;
+
+#endif
+
+	void update();
+
+	geBox*    m_text;
+	geButton* m_close;
+
+	Entries m_channels;
+	Entries m_plugins;
+	int     m_cycles;
+};
+}} // giada::v::
+
+
+#endif
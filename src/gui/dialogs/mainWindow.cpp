@@ -36,6 +36,7 @@
 #include "gui/elems/mainWindow/mainTimer.h"
 #include "gui/elems/mainWindow/mainTransport.h"
 #include "gui/elems/mainWindow/beatMeter.h"
+#include "gui/elems/mainWindow/dspMeter.h"
 #include "gui/elems/mainWindow/keyboard/keyboard.h"
 #include "warnings.h"
 #include "mainWindow.h"
@@ -65,6 +66,7 @@ gdMainWindow::gdMainWindow(int W, int H, const char* title, int argc, char** arg
 	mainIO        = new v::geMainIO(408, 8);
 	mainTransport = new v::geMainTransport(8, 39);
 	mainTimer     = new v::geMainTimer(598, 44);
+	dspMeter      = new v::geDspMeter(216, 44, 100, 20);
 	beatMeter     = new v::geBeatMeter(100, 83, 609, 20);
 	keyboard      = new v::geKeyboard(8, 122, w()-16, 380);
 
@@ -79,7 +81,8 @@ gdMainWindow::gdMainWindow(int W, int H, const char* title, int argc, char** arg
 
 	Fl_Group* zone2 = new Fl_Group(8, mainTransport->y(), W-16, mainTransport->h());
 	zone2->add(mainTransport);
-	zone2->resizable(new Fl_Box(mainTransport->x()+mainTransport->w()+4, zone2->y(), 80, 20));
+	zone2->add(dspMeter);
+	zone2->resizable(new Fl_Box(dspMeter->x()+dspMeter->w()+4, zone2->y(), 80, 20));
 	zone2->add(mainTimer);
 
 	/* zone 3 - beat meter */
@@ -126,6 +129,7 @@ void gdMainWindow::refresh()
 	mainTimer->refresh();
 	mainTransport->refresh();
 	beatMeter->refresh();
+	dspMeter->refresh();
 	keyboard->refresh();
 }
 
@@ -44,6 +44,7 @@ class geMainMenu;
 class geBeatMeter;
 class geMainTransport;
 class geMainTimer;
+class geDspMeter;
 class gdMainWindow : public gdWindow
 {
 public:
@@ -62,6 +63,7 @@ public:
 	geMainIO*        mainIO;
 	geMainTimer*     mainTimer;
 	geMainTransport* mainTransport;
+	geDspMeter*      dspMeter;
 };
 }} // giada::v::
 
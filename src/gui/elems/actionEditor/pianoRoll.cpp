@@ -31,6 +31,7 @@
 #include "core/conf.h"
 #include "core/const.h"
 #include "core/clock.h"
+#include "core/recorder.h"
 #include "core/action.h"
 #include "core/midiEvent.h"
 #include "utils/log.h"
@@ -372,7 +373,7 @@ void gePianoRoll::rebuild()
 
 		assert(a1.isValid());  // a2 might be null if orphaned
 
-		const m::Action& a2 = a1.next != nullptr ? *a1.next : m::Action{};
+		const m::Action a2 = m::recorder::getAction(a1.nextId);
 
 		Pixel px = x() + m_base->frameToPixel(a1.frame);
 		Pixel py = y() + noteToY(a1.event.getNote());
@@ -59,7 +59,8 @@ geTabAudio::geTabAudio(int X, int Y, int W, int H)
 	channelsIn      = new geChoice(x()+114, y()+149, 55,  20, "Input channels");
 	recTriggerLevel = new geInput (x()+309, y()+149, 55,  20, "Rec threshold (dB)");
 	rsmpQuality     = new geChoice(x()+114, y()+177, 250, 20, "Resampling");
-                      new geBox(x(), rsmpQuality->y()+rsmpQuality->h()+8, w(), 92, "Restart Giada for the changes to take effect.");
+	renderThreads   = new geChoice(x()+114, y()+205, 55,  20, "Render threads");
+                      new geBox(x(), renderThreads->y()+renderThreads->h()+8, w(), 64, "Restart Giada for the changes to take effect.");
 	end();
 
 	labelsize(G_GUI_FONT_SIZE_BASE);
@@ -209,6 +210,11 @@ geTabAudio::geTabAudio(int X, int Y, int W, int H)
 	rsmpQuality->add("Linear (very fast)");
 	rsmpQuality->value(m::conf::rsmpQuality);
 
+	renderThreads->add("Off");
+	for (int i=1; i<=G_MAX_RENDER_THREADS; i++)
+		renderThreads->add(u::string::iToString(i).c_str());
+	renderThreads->value(m::conf::renderThreads);
+
 	recTriggerLevel->value(u::string::fToString(m::conf::recTriggerLevel, 1).c_str());
 
 	limitOutput->value(m::conf::limitOutput);
@@ -511,6 +517,7 @@ void geTabAudio::save()
 	m::conf::channelsIn     = channelsIn->value();
 	m::conf::limitOutput    = limitOutput->value();
 	m::conf::rsmpQuality    = rsmpQuality->value();
+	m::conf::renderThreads  = renderThreads->value();
 
 	/* if sounddevOut is disabled (because of system change e.g. alsa ->
 	 * jack) its value is equal to -1. Change it! */
@@ -61,6 +61,7 @@ public:
 	geChoice* channelsIn;
 	geInput*  recTriggerLevel;
 	geChoice* rsmpQuality;
+	geChoice* renderThreads;
 
 private:
 
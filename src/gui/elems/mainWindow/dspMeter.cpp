@@ -0,0 +1,106 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#include <algorithm>
+#include <string>
+#include <FL/Fl.H>
+#include <FL/fl_draw.H>
+#include "core/const.h"
+#include "core/profiler.h"
+#include "utils/gui.h"
+#include "gui/dialogs/mainWindow.h"
+#include "gui/dialogs/dspLoad.h"
+#include "dspMeter.h"
+
+
+extern giada::v::gdMainWindow* G_MainWin;
+
+
+namespace giada {
+namespace v
+{
+geDspMeter::geDspMeter(int x, int y, int w, int h)
+: Fl_Box     (x, y, w, h),
+  m_load     (0.0f),
+  m_worstLoad(0.0f)
+{
+	tooltip("DSP load (average/worst). Click for details.");
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geDspMeter::refresh()
+{
+	m::profiler::Stats stats = m::profiler::getStats();
+
+	if (stats.load == m_load && stats.worstLoad == m_worstLoad)
+		return;
+	m_load      = stats.load;
+	m_worstLoad = stats.worstLoad;
+	redraw();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+int geDspMeter::handle(int e)
+{
+	if (e != FL_PUSH)
+		return Fl_Box::handle(e);
+	u::gui::openSubWindow(G_MainWin, new gdDspLoad(), WID_DSP_LOAD);
+	return 1;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geDspMeter::draw()
+{
+	int loadW  = (w() - 2) * std::min(m_load, 1.0f);
+	int worstX = (w() - 2) * std::min(m_worstLoad, 1.0f);
+
+	fl_rect(x(), y(), w(), h(), G_COLOR_GREY_4);
+	fl_rectf(x()+1, y()+1, w()-2, h()-2, G_COLOR_GREY_2);
+	fl_rectf(x()+1, y()+1, loadW, h()-2, m_worstLoad >= 1.0f ? G_COLOR_RED_ALERT : G_COLOR_GREY_4);
+
+	/* Worst case marker. */
+
+	if (worstX > 0)
+		fl_rectf(x()+worstX, y()+1, 1, h()-2, G_COLOR_LIGHT_1);
+
+	std::string label = "DSP " + std::to_string(static_cast<int>(m_load * 100)) + "%";
+
+	fl_color(G_COLOR_LIGHT_2);
+	fl_font(FL_HELVETICA, G_GUI_FONT_SIZE_BASE);
+	fl_draw(label.c_str(), x(), y(), w(), h(), FL_ALIGN_CENTER);
+}
+}} // giada::v::
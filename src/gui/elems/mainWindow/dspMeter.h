@@ -0,0 +1,62 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#ifndef GE_DSP_METER_H
+#define GE_DSP_METER_H
+
+
+#include <FL/Fl_Box.H>
+
+
+namespace giada {
+namespace v
+{
+/* geDspMeter
+Shows the average and the worst DSP load of the audio callback. Click on it to
+open the detailed breakdown. */
+
+class geDspMeter : public Fl_Box
+{
+public:
+
+	geDspMeter(int x, int y, int w, int h);
+
+	void draw() override;
+	int  handle(int e) override;
+
+	void refresh();
+
+private:
+
+	float m_load;
+	float m_worstLoad;
+};
+}} // giada::v::
+
+
+#endif
@@ -29,6 +29,7 @@
 #include "core/channels/sampleChannel.h"
 #include "core/model/model.h"
 #include "core/mixer.h"
+#include "core/mixerHandler.h"
 #include "core/conf.h"
 #include "core/clock.h"
 #include "core/graphics.h"
@@ -86,6 +87,11 @@ enum class Menu
 	CLEAR_ACTIONS_VOLUME,
 	CLEAR_ACTIONS_START_STOP,
 	__END_CLEAR_ACTIONS_SUBMENU__,
+	RESAMPLER,
+	RESAMPLER_LINEAR,
+	RESAMPLER_CUBIC,
+	RESAMPLER_SINC,
+	__END_RESAMPLER_SUBMENU__,
 	/*RESIZE,
 	RESIZE_H1,
 	RESIZE_H2,
@@ -149,6 +155,7 @@ void menuCallback(Fl_Widget* w, void* v)
 			break;
 		}
 		case Menu::EDIT_SAMPLE: {
+			m::mh::makeWaveResident(waveId);
 			u::gui::openSubWindow(G_MainWin, new gdSampleEditor(gch->channelId, waveId), 
 				WID_SAMPLE_EDITOR);
 			break;
@@ -160,6 +167,8 @@ void menuCallback(Fl_Widget* w, void* v)
 		}
 		case Menu::CLEAR_ACTIONS:
 		case Menu::__END_CLEAR_ACTIONS_SUBMENU__:
+		case Menu::RESAMPLER:
+		case Menu::__END_RESAMPLER_SUBMENU__:
 		//case Menu::RESIZE:
 		//case Menu::__END_RESIZE_SUBMENU__:
 			break;
@@ -175,6 +184,18 @@ void menuCallback(Fl_Widget* w, void* v)
 			c::recorder::clearStartStopActions(gch->channelId);
 			break;
 		}
+		case Menu::RESAMPLER_LINEAR: {
+			c::channel::setResampler(gch->channelId, ResamplerQuality::LINEAR);
+			break;
+		}
+		case Menu::RESAMPLER_CUBIC: {
+			c::channel::setResampler(gch->channelId, ResamplerQuality::CUBIC);
+			break;
+		}
+		case Menu::RESAMPLER_SINC: {
+			c::channel::setResampler(gch->channelId, ResamplerQuality::SINC);
+			break;
+		}
 		/*case Menu::RESIZE_H1: {
 			gch->changeSize(G_GUI_CHANNEL_H_1);
 			break;
@@ -306,6 +327,7 @@ void geSampleChannel::cb_openMenu()
 	bool isEmptyOrMissing;
 	bool hasActions;
 	bool isAnyLoopMode;
+	ResamplerQuality resampler;
 	m::model::onGet(m::model::channels, channelId, [&](m::Channel& c)
 	{
 		const m::SampleChannel& sc = static_cast<m::SampleChannel&>(c);
@@ -313,6 +335,7 @@ void geSampleChannel::cb_openMenu()
 		isEmptyOrMissing = sc.playStatus == ChannelStatus::EMPTY || sc.playStatus == ChannelStatus::MISSING;
 		hasActions       = sc.hasActions;
 		isAnyLoopMode    = sc.isAnyLoopMode();
+		resampler        = sc.resampler.getQuality();
 	});
 
 	/* If you're recording (input or actions) no menu is allowed; you can't do
@@ -336,6 +359,14 @@ void geSampleChannel::cb_openMenu()
 			{"Volume",     0, menuCallback, (void*) Menu::CLEAR_ACTIONS_VOLUME},
 			{"Start/Stop", 0, menuCallback, (void*) Menu::CLEAR_ACTIONS_START_STOP},
 			{0},
+		{"Resampler",                0, menuCallback, (void*) Menu::RESAMPLER, FL_SUBMENU},
+			{"Linear", 0, menuCallback, (void*) Menu::RESAMPLER_LINEAR,
+				FL_MENU_RADIO | (resampler == ResamplerQuality::LINEAR ? FL_MENU_VALUE : 0)},
+			{"Cubic",  0, menuCallback, (void*) Menu::RESAMPLER_CUBIC,
+				FL_MENU_RADIO | (resampler == ResamplerQuality::CUBIC ? FL_MENU_VALUE : 0)},
+			{"Sinc",   0, menuCallback, (void*) Menu::RESAMPLER_SINC,
+				FL_MENU_RADIO | (resampler == ResamplerQuality::SINC ? FL_MENU_VALUE : 0)},
+			{0},
 /*		{"Resize",    0, menuCallback, (void*) Menu::RESIZE, FL_SUBMENU},
 			{"Normal",  0, menuCallback, (void*) Menu::RESIZE_H1},
 			{"Medium",  0, menuCallback, (void*) Menu::RESIZE_H2},
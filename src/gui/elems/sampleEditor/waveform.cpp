@@ -25,6 +25,7 @@
  * -------------------------------------------------------------------------- */
 
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <FL/fl_draw.H>
@@ -132,29 +133,35 @@ int geWaveform::alloc(int datasize, bool force)
 		float peaksup = 0.0f;
 		float peakinf = 0.0f;
 
-		for (int k = pc; k < pn; k++) { // TODO - int until we switch to uint32_t for Wave size...
+		/* Walk the Wave data block by block: per-frame lookups are slower on
+		heavily edited Waves. */
 
-			if (k >= wave.getSize())
-				continue;
+		int k = pc; // TODO - int until we switch to uint32_t for Wave size...
 
-			/* Compute average of stereo signal. */
+		wave.forEachBlock(pc, std::min(pn, wave.getSize()) - pc, 
+			[&](const float* data, Frame frames)
+		{
+			for (int f = 0; f < frames; f++, k++) {
 
-			float avg = 0.0f;
-			float* frame = wave.getFrame(k);
-			for (int j = 0; j < wave.getChannels(); j++)
-				avg += frame[j];
-			avg /= wave.getChannels();
-			
-			/* Find peaks (greater and lower). */
+				/* Compute average of stereo signal. */
 
-			if      (avg > peaksup)  peaksup = avg;
-			else if (avg <= peakinf) peakinf = avg;
+				float avg = 0.0f;
+				const float* frame = data + f * wave.getChannels();
+				for (int j = 0; j < wave.getChannels(); j++)
+					avg += frame[j];
+				avg /= wave.getChannels();
+				
+				/* Find peaks (greater and lower). */
 
-			/* Fill up grid vector. */
+				if      (avg > peaksup)  peaksup = avg;
+				else if (avg <= peakinf) peakinf = avg;
 
-			if (gridFreq != 0 && (int) k % gridFreq == 0 && k != 0)
-				m_grid.points.push_back(k);
-		}
+				/* Fill up grid vector. */
+
+				if (gridFreq != 0 && k % gridFreq == 0 && k != 0)
+					m_grid.points.push_back(k);
+			}
+		});
 
 		m_data.sup[i] = zero - (peaksup * offset);
 		m_data.inf[i] = zero - (peakinf * offset);
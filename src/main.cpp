@@ -28,6 +28,7 @@
 #include <atomic>
 #include <FL/Fl.H>
 #include "core/init.h"
+#include "core/headless.h"
 
 
 class gdMainWindow* G_MainWin = nullptr;
@@ -37,6 +38,9 @@ int main(int argc, char** argv)
 {
 	using namespace giada;
 
+	if (m::headless::isRequested(argc, argv))
+		return m::headless::run(argc, argv);
+
 	m::init::startup(argc, argv);
 
 	int ret = Fl::run();
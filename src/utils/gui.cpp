@@ -111,6 +111,10 @@ void refresh()
 	/* Refresh Sample Editor (if open) for dynamic play head. */
 
 	refreshSubWindow(WID_SAMPLE_EDITOR);
+
+	/* Refresh DSP load breakdown (if open). */
+
+	refreshSubWindow(WID_DSP_LOAD);
 }
 
 
@@ -0,0 +1,79 @@
+#include "../src/core/channels/sampleChannel.h"
+#include "../src/core/channels/midiChannel.h"
+#include "../src/core/channelTable.h"
+#include "../src/core/rcuList.h"
+#include "../src/core/mixer.h"
+#include <catch.hpp>
+
+
+TEST_CASE("ChannelTable")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	const int BUFFER_SIZE = 64;
+
+	RCUList<Channel, ChannelTable> channels;
+	channels.push(std::make_unique<SampleChannel>(false, BUFFER_SIZE, 1, mixer::MASTER_OUT_CHANNEL_ID));
+	channels.push(std::make_unique<SampleChannel>(false, BUFFER_SIZE, 1, 10));
+	channels.push(std::make_unique<SampleChannel>(false, BUFFER_SIZE, 1, 11));
+	channels.push(std::make_unique<MidiChannel>(BUFFER_SIZE, 1, 12));
+
+	/* Channel 11 has a wave. */
+
+	channels.update(2, [](const Channel& c) { return std::unique_ptr<Channel>(c.clone()); },
+		[](Channel& c)
+	{
+		static_cast<SampleChannel&>(c).pushWave(1, 1000);
+	});
+
+	SECTION("test load")
+	{
+		RCUList<Channel, ChannelTable>::Lock lock(channels);
+		const ChannelTable& table = channels.getTable();
+
+		REQUIRE(table.size() == 4);
+		REQUIRE(table.id[1] == 10);
+		REQUIRE(table.id[2] == 11);
+		REQUIRE(table.channel[2] == channels.get(2));
+		REQUIRE(table.channel[3] == channels.get(3));
+	}
+
+	SECTION("test idle channels")
+	{
+		RCUList<Channel, ChannelTable>::Lock lock(channels);
+		const ChannelTable& table = channels.getTable();
+
+		REQUIRE(table.idle[0] == true);  // Master
+		REQUIRE(table.idle[1] == true);  // Empty
+		REQUIRE(table.idle[2] == false);
+		REQUIRE(table.idle[3] == false);
+	}
+
+	SECTION("test render slots")
+	{
+		RCUList<Channel, ChannelTable>::Lock lock(channels);
+		const ChannelTable& table = channels.getTable();
+
+		REQUIRE(table.render == std::vector<size_t>{ 1, 2, 3 });
+	}
+
+	SECTION("test snapshots")
+	{
+		/* A reader keeps the table of the snapshot it has locked, while writers
+		publish a new one with each change. */
+
+		RCUList<Channel, ChannelTable>::Lock lock(channels);
+		const ChannelTable& old = channels.getTable();
+
+		channels.pop(1);
+
+		const ChannelTable& table = channels.getTable();
+
+		REQUIRE(old.size() == 4);
+		REQUIRE(old.id[1] == 10);
+		REQUIRE(table.size() == 3);
+		REQUIRE(table.id[1] == 11);
+		REQUIRE(table.render == std::vector<size_t>{ 1, 2 });
+	}
+}
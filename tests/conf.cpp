@@ -27,6 +27,7 @@ TEST_CASE("conf")
     conf::midiSystem = 11;
     conf::midiPortOut = 12;
     conf::midiPortIn = 13;
+    conf::midiQueueSize = 512;
     conf::midiMapPath = "path/to/midi/map";
     conf::lastFileMap = "path/to/last/midi/map";
     conf::midiSync = 14;
@@ -100,6 +101,7 @@ TEST_CASE("conf")
     REQUIRE(conf::midiSystem == 11);
     REQUIRE(conf::midiPortOut == 12);
     REQUIRE(conf::midiPortIn == 13);
+    REQUIRE(conf::midiQueueSize == 512);
     REQUIRE(conf::midiMapPath == "path/to/midi/map");
     REQUIRE(conf::lastFileMap == "path/to/last/midi/map");
     REQUIRE(conf::midiSync == 14);
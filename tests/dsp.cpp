@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <random>
+#include "../src/core/dsp.h"
+#include <catch.hpp>
+
+
+using namespace giada::m;
+
+
+TEST_CASE("dsp")
+{
+	/* Odd sizes and offset pointers, to exercise both the unaligned vector 
+	loops and the scalar tails. */
+
+	static const int SAMPLES = 1027;
+	static const int OFFSET  = 1;
+
+	std::mt19937 gen(42);
+	std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+
+	std::vector<float> src(SAMPLES + OFFSET);
+	std::vector<float> dst(SAMPLES + OFFSET);
+	for (size_t i=0; i<src.size(); i++) {
+		src[i] = dist(gen);
+		dst[i] = dist(gen);
+	}
+
+	/* Each kernel runs with the scalar reference first, then with any other 
+	instruction set available: results must be exactly the same. */
+
+	auto compare = [&](auto kernel)
+	{
+		std::vector<float> expected = dst;
+		REQUIRE(dsp::setIsa(dsp::Isa::SCALAR));
+		kernel(expected.data() + OFFSET);
+
+		for (dsp::Isa isa : { dsp::Isa::SSE2, dsp::Isa::AVX2, dsp::Isa::NEON }) {
+			if (!dsp::setIsa(isa))
+				continue;
+			std::vector<float> actual = dst;
+			kernel(actual.data() + OFFSET);
+			REQUIRE(actual == expected);
+		}
+	};
+
+	const dsp::Isa best = dsp::getIsa();
+
+	SECTION("test addGain")
+	{
+		compare([&](float* d) { dsp::addGain(d, src.data() + OFFSET, SAMPLES, 0.7f); });
+	}
+
+	SECTION("test addPanGain")
+	{
+		compare([&](float* d) { dsp::addPanGain(d, src.data() + OFFSET, SAMPLES / 2, 0.3f, 0.9f); });
+	}
+
+	SECTION("test addPanGainRamp")
+	{
+		std::vector<float> ramp(SAMPLES / 2);
+		for (size_t i=0; i<ramp.size(); i++)
+			ramp[i] = i / static_cast<float>(ramp.size());
+
+		compare([&](float* d) { dsp::addPanGainRamp(d, src.data() + OFFSET, ramp.data(), SAMPLES / 2, 0.3f, 0.9f); });
+		
+		/* A constant ramp is the same as a plain addPanGain. */
+
+		std::fill(ramp.begin(), ramp.end(), 1.0f);
+		std::vector<float> expected = dst;
+		std::vector<float> actual   = dst;
+		dsp::addPanGain(expected.data(), src.data(), SAMPLES / 2, 0.3f, 0.9f);
+		dsp::addPanGainRamp(actual.data(), src.data(), ramp.data(), SAMPLES / 2, 0.3f, 0.9f);
+		REQUIRE(actual == expected);
+	}
+
+	SECTION("test copyGain")
+	{
+		compare([&](float* d) { dsp::copyGain(d, src.data() + OFFSET, SAMPLES, 0.5f); });
+		compare([&](float* d) { dsp::copyGain(d, d, SAMPLES, 1.3f); });
+	}
+
+	SECTION("test clamp")
+	{
+		compare([&](float* d) { dsp::clamp(d, SAMPLES, -1.0f, 1.0f); });
+
+		REQUIRE(dsp::setIsa(best));
+		dsp::clamp(dst.data(), dst.size(), -1.0f, 1.0f);
+		for (float f : dst)
+			REQUIRE((f >= -1.0f && f <= 1.0f));
+	}
+
+	SECTION("test peakAbs")
+	{
+		float expected = 0.0f;
+		for (int i=OFFSET; i<SAMPLES + OFFSET; i++)
+			expected = std::max(expected, std::abs(src[i]));
+
+		for (dsp::Isa isa : { dsp::Isa::SCALAR, dsp::Isa::SSE2, dsp::Isa::AVX2, dsp::Isa::NEON })
+			if (dsp::setIsa(isa))
+				REQUIRE(dsp::peakAbs(src.data() + OFFSET, SAMPLES) == expected);
+	}
+
+	SECTION("test dotStereo")
+	{
+		for (int frames : { 1, 2, 7, 16, 64 })
+			compare([&](float* d) { dsp::dotStereo(src.data() + OFFSET, dst.data(), frames, d); });
+	}
+
+	dsp::setIsa(best);
+}
@@ -0,0 +1,149 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <sndfile.h>
+#include "../src/core/headless.h"
+#include <catch.hpp>
+
+
+using namespace giada;
+using namespace giada::m;
+
+
+namespace
+{
+void write_(const std::string& path, const std::vector<float>& data, int channels,
+	int rate)
+{
+	SF_INFO header;
+	header.samplerate = rate;
+	header.channels   = channels;
+	header.format     = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+
+	SNDFILE* file = sf_open(path.c_str(), SFM_WRITE, &header);
+	REQUIRE(file != nullptr);
+	sf_writef_float(file, data.data(), data.size() / channels);
+	sf_close(file);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool parse_(std::vector<const char*> args, headless::Args& a)
+{
+	args.insert(args.begin(), "giada");
+	return headless::parseArgs(args.size(), const_cast<char**>(args.data()), a);
+}
+
+
+bool parse_(std::vector<const char*> args)
+{
+	headless::Args a;
+	return parse_(args, a);
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+TEST_CASE("headless")
+{
+	SECTION("test render request")
+	{
+		std::vector<const char*> yes = { "giada", "--bars", "4", "--render", "p.gptc" };
+		std::vector<const char*> no  = { "giada", "--bars", "4" };
+
+		REQUIRE(headless::isRequested(yes.size(), const_cast<char**>(yes.data())) == true);
+		REQUIRE(headless::isRequested(no.size(), const_cast<char**>(no.data())) == false);
+	}
+
+	SECTION("test parse arguments")
+	{
+		headless::Args a;
+
+		REQUIRE(parse_({ "--render", "p.gptc", "--bars", "4", "--out", "o.wav", 
+			"--stems", "stems", "--compare", "g.wav", "--tolerance", "0.5" }, a) == true);
+		REQUIRE(a.patch == "p.gptc");
+		REQUIRE(a.bars == 4);
+		REQUIRE(a.out == "o.wav");
+		REQUIRE(a.stems == "stems");
+		REQUIRE(a.compare == "g.wav");
+		REQUIRE(a.tolerance == Approx(0.5f));
+	}
+
+	SECTION("test parse defaults")
+	{
+		headless::Args a;
+
+		REQUIRE(parse_({ "--render", "p.gptc", "--bars", "1", "--out", "o.wav" }, a) == true);
+		REQUIRE(a.stems == "");
+		REQUIRE(a.compare == "");
+		REQUIRE(a.tolerance == Approx(0.00001f));
+	}
+
+	SECTION("test parse errors")
+	{
+		/* No output, no bars, bad bars, missing value, unknown option. */
+
+		REQUIRE(parse_({ "--render", "p.gptc", "--bars", "4" }) == false);
+		REQUIRE(parse_({ "--render", "p.gptc", "--out", "o.wav" }) == false);
+		REQUIRE(parse_({ "--render", "p.gptc", "--bars", "0", "--out", "o.wav" }) == false);
+		REQUIRE(parse_({ "--render", "p.gptc", "--bars", "4", "--out" }) == false);
+		REQUIRE(parse_({ "--render", "p.gptc", "--bars", "4", "--out", "o.wav", "--x", "1" }) == false);
+	}
+
+	SECTION("test compare")
+	{
+		static const char* OUT    = "test-headless-out.wav";
+		static const char* GOLDEN = "test-headless-golden.wav";
+
+		const std::vector<float> data = { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f };
+
+		write_(OUT, data, 2, 44100);
+
+		SECTION("test same file")
+		{
+			write_(GOLDEN, data, 2, 44100);
+			REQUIRE(headless::compare(OUT, GOLDEN, 0.0f) == 0);
+		}
+
+		SECTION("test tolerance")
+		{
+			std::vector<float> golden = data;
+			golden[3] += 0.01f;
+			write_(GOLDEN, golden, 2, 44100);
+
+			REQUIRE(headless::compare(OUT, GOLDEN, 0.001f) == 2);
+			REQUIRE(headless::compare(OUT, GOLDEN, 0.1f) == 0);
+		}
+
+		SECTION("test format mismatch")
+		{
+			write_(GOLDEN, data, 1, 44100);
+			REQUIRE(headless::compare(OUT, GOLDEN, 0.1f) == 2);
+
+			write_(GOLDEN, data, 2, 48000);
+			REQUIRE(headless::compare(OUT, GOLDEN, 0.1f) == 2);
+		}
+
+		SECTION("test length mismatch")
+		{
+			std::vector<float> golden = data;
+			golden.push_back(0.7f);
+			golden.push_back(0.8f);
+			write_(GOLDEN, golden, 2, 44100);
+
+			REQUIRE(headless::compare(OUT, GOLDEN, 0.1f) == 2);
+		}
+
+		SECTION("test missing file")
+		{
+			REQUIRE(headless::compare(OUT, "does/not/exist.wav", 0.1f) == 1);
+		}
+
+		std::remove(OUT);
+		std::remove(GOLDEN);
+	}
+}
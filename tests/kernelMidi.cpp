@@ -0,0 +1,44 @@
+#include "../src/core/kernelMidi.h"
+#include <catch.hpp>
+
+
+TEST_CASE("kernelMidi")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	const profiler::Time MS  = 1000000;  // 1 ms in nanoseconds
+	const profiler::Time NOW = 1000 * MS;
+
+	SECTION("test stamp, first message")
+	{
+		profiler::Time last = 0;
+
+		REQUIRE(kernelMidi::stamp(0.5, NOW, last) == NOW);
+		REQUIRE(last == NOW);
+	}
+
+	SECTION("test stamp, from driver deltas")
+	{
+		profiler::Time last = NOW - 5 * MS;
+
+		REQUIRE(kernelMidi::stamp(0.002, NOW, last) == NOW - 3 * MS);
+		REQUIRE(kernelMidi::stamp(0.001, NOW, last) == NOW - 2 * MS);
+		REQUIRE(last == NOW - 2 * MS);
+	}
+
+	SECTION("test stamp, in the future")
+	{
+		profiler::Time last = NOW - MS;
+
+		REQUIRE(kernelMidi::stamp(0.005, NOW, last) == NOW);
+	}
+
+	SECTION("test stamp, drift above limit")
+	{
+		profiler::Time last = NOW - 50 * MS;
+
+		REQUIRE(kernelMidi::stamp(0.001, NOW, last) == NOW);
+		REQUIRE(last == NOW);
+	}
+}
@@ -0,0 +1,71 @@
+#include <memory>
+#include "../src/core/channels/sampleChannel.h"
+#include "../src/core/model/model.h"
+#include "../src/core/midiDispatcher.h"
+#include <catch.hpp>
+
+
+TEST_CASE("midiDispatcher")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	const int BUFFER_SIZE = 64;
+	const ID  CHANNEL_ID  = 20;
+
+	model::channels.push(std::make_unique<SampleChannel>(false, BUFFER_SIZE, 1, CHANNEL_ID));
+
+	/* First refresh: the table has never been built. */
+
+	midiDispatcher::refreshTable();
+
+	REQUIRE(midiDispatcher::refreshTable() == false);
+
+	SECTION("test swap")
+	{
+		/* Swapping a channel doesn't alter the list structure: no rebuild. */
+
+		model::onSwap(model::channels, CHANNEL_ID, [](Channel& c)
+		{
+			c.volume = 0.5f;
+		});
+
+		REQUIRE(midiDispatcher::refreshTable() == false);
+	}
+
+	SECTION("test learn")
+	{
+		model::onGet(model::channels, CHANNEL_ID, [](Channel& c)
+		{
+			c.midiInKeyPress.store(0x903C0000);
+		});
+		midiDispatcher::invalidate();
+
+		REQUIRE(midiDispatcher::refreshTable() == true);
+		REQUIRE(midiDispatcher::refreshTable() == false);
+
+		/* Clearing a learned value. */
+
+		model::onGet(model::channels, CHANNEL_ID, [](Channel& c)
+		{
+			c.midiInKeyPress.store(0x0);
+		});
+		midiDispatcher::invalidate();
+
+		REQUIRE(midiDispatcher::refreshTable() == true);
+	}
+
+	SECTION("test push and pop")
+	{
+		model::channels.push(std::make_unique<SampleChannel>(false, BUFFER_SIZE, 1, CHANNEL_ID + 1));
+
+		REQUIRE(midiDispatcher::refreshTable() == true);
+		REQUIRE(midiDispatcher::refreshTable() == false);
+
+		model::channels.pop(model::getIndex(model::channels, CHANNEL_ID + 1));
+
+		REQUIRE(midiDispatcher::refreshTable() == true);
+	}
+
+	model::channels.pop(model::getIndex(model::channels, CHANNEL_ID));
+}
@@ -0,0 +1,37 @@
+#include "../src/core/mixer.h"
+#include "../src/core/conf.h"
+#include <catch.hpp>
+
+
+TEST_CASE("mixer")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	const profiler::Time MS    = 1000000;  // 1 ms in nanoseconds
+	const profiler::Time START = 1000 * MS;
+	const Frame          SIZE  = 1024;
+
+	conf::samplerate = 44100;
+
+	SECTION("test input frame, no buffer rendered yet")
+	{
+		REQUIRE(mixer::getInputFrame(START, 0, SIZE) == 0);
+	}
+
+	SECTION("test input frame, before the buffer start")
+	{
+		REQUIRE(mixer::getInputFrame(START - MS, START, SIZE) == 0);
+		REQUIRE(mixer::getInputFrame(START, START, SIZE) == 0);
+	}
+
+	SECTION("test input frame, inside the buffer")
+	{
+		REQUIRE(mixer::getInputFrame(START + 10 * MS, START, SIZE) == 441);
+	}
+
+	SECTION("test input frame, past one buffer")
+	{
+		REQUIRE(mixer::getInputFrame(START + 100 * MS, START, SIZE) == SIZE - 1);
+	}
+}
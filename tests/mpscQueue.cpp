@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "../src/core/mpscQueue.h"
+#include <catch.hpp>
+
+
+using namespace giada::m;
+
+
+TEST_CASE("MpscQueue")
+{
+	MpscQueue<int> queue(6); // Rounded up to 8
+
+	SECTION("test push/pop")
+	{
+		int item;
+
+		REQUIRE(queue.getCapacity() == 8);
+		REQUIRE(queue.pop(item) == false);
+
+		for (int i=0; i<8; i++)
+			REQUIRE(queue.push(i) == true);
+		REQUIRE(queue.push(8) == false); // Full
+		REQUIRE(queue.getDropped() == 1);
+
+		for (int i=0; i<8; i++) {
+			REQUIRE(queue.pop(item) == true);
+			REQUIRE(item == i);
+		}
+		REQUIRE(queue.pop(item) == false);
+
+		/* Wrap around. */
+
+		REQUIRE(queue.push(42) == true);
+		REQUIRE(queue.pop(item) == true);
+		REQUIRE(item == 42);
+	}
+
+	SECTION("test bulk push/pop")
+	{
+		int in[10]  = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		int out[10] = {};
+
+		REQUIRE(queue.push(in, 5) == 5);
+		REQUIRE(queue.pop(out, 2) == 2);
+		REQUIRE(out[0] == 0);
+		REQUIRE(out[1] == 1);
+
+		/* Only 5 free cells left: the remaining items are dropped. */
+
+		REQUIRE(queue.push(in, 10) == 5);
+		REQUIRE(queue.getDropped() == 5);
+
+		REQUIRE(queue.pop(out, 10) == 8);
+		REQUIRE(out[0] == 2);
+		REQUIRE(out[2] == 4);
+		REQUIRE(out[3] == 0);
+		REQUIRE(out[7] == 4);
+		REQUIRE(queue.pop(out, 10) == 0);
+	}
+
+	SECTION("test multiple producers")
+	{
+		static const int PRODUCERS = 4;
+		static const int ITEMS     = 10000;
+		static const int BULK      = 3;
+
+		MpscQueue<int> queue(64);
+		std::vector<std::thread> producers;
+
+		for (int p=0; p<PRODUCERS; p++)
+			producers.emplace_back([&queue, p]()
+			{
+				for (int i=0; i<ITEMS; i+=BULK) {
+					int items[BULK];
+					int count = std::min(BULK, ITEMS - i);
+					for (int k=0; k<count; k++)
+						items[k] = p * ITEMS + i + k;
+					for (int k=0; k<count; )
+						k += queue.push(&items[k], count - k);
+				}
+			});
+
+		/* Items from each producer must come out in order, none lost. */
+
+		std::vector<int> last(PRODUCERS, -1);
+		int received = 0;
+		while (received < PRODUCERS * ITEMS) {
+			int items[16];
+			size_t count = queue.pop(items, 16);
+			if (count == 0)
+				std::this_thread::yield();
+			for (size_t k=0; k<count; k++) {
+				int p = items[k] / ITEMS;
+				REQUIRE(items[k] % ITEMS == last[p] + 1);
+				last[p] = items[k] % ITEMS;
+				received++;
+			}
+		}
+
+		for (std::thread& t : producers)
+			t.join();
+	}
+}
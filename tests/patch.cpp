@@ -1,3 +1,10 @@
+#include <cstdio>
+#include "../src/core/channels/sampleChannel.h"
+#include "../src/core/model/model.h"
+#include "../src/core/mixerHandler.h"
+#include "../src/core/kernelAudio.h"
+#include "../src/core/clock.h"
+#include "../src/core/conf.h"
 #include "../src/core/patch.h"
 #include "../src/core/const.h"
 #include "../src/core/types.h"
@@ -239,3 +246,49 @@ TEST_CASE("patch")
 	}
 #endif
 }
+
+
+TEST_CASE("patch read, missing Waves")
+{
+	static const char* FILE = "test-patch.gptc";
+
+	std::FILE* f = std::fopen(FILE, "w");
+	REQUIRE(f != nullptr);
+	std::fputs(R"({
+		"bpm": 120.0, "bars": 1, "beats": 4, "quantize": 0, "samplerate": 44100,
+		"waves": [
+			{ "id": 1, "path": "tests/resources/test.wav" },
+			{ "id": 2, "path": "does/not/exist.wav" }
+		],
+		"channels": [
+			{ "id": 10, "type": 1, "volume": 1.0, "wave_id": 1, "begin": 0, "end": 10 },
+			{ "id": 11, "type": 1, "volume": 1.0, "wave_id": 2, "begin": 0, "end": 10 }
+		]
+	})", f);
+	std::fclose(f);
+
+	kernelAudio::openOffline();
+	clock::init(conf::samplerate, conf::midiTCfps);
+	mh::init();
+
+	REQUIRE(patch::read(FILE, "") == G_PATCH_OK);
+
+	{
+		model::ChannelsLock cl(model::channels);
+
+		const SampleChannel& loaded  = static_cast<SampleChannel&>(model::get(model::channels, 10));
+		const SampleChannel& missing = static_cast<SampleChannel&>(model::get(model::channels, 11));
+
+		REQUIRE(loaded.hasWave == true);
+		REQUIRE(loaded.waveId == 1);
+		REQUIRE(loaded.playStatus == ChannelStatus::OFF);
+
+		REQUIRE(missing.hasWave == false);
+		REQUIRE(missing.waveId == 0);
+		REQUIRE(missing.playStatus == ChannelStatus::EMPTY);
+		REQUIRE(missing.end == 0);
+	}
+
+	mh::close();
+	std::remove(FILE);
+}
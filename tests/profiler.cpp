@@ -0,0 +1,114 @@
+#include <thread>
+#include <vector>
+#include "../src/core/profiler.h"
+#include <catch.hpp>
+
+
+using namespace giada;
+using namespace giada::m;
+
+
+TEST_CASE("profiler")
+{
+	SECTION("Test buffer stats")
+	{
+		profiler::Stats before = profiler::getStats();
+
+		for (int i = 0; i < profiler::WINDOW; i++) {
+			profiler::Time start = profiler::beginBuffer(/*bufferSize=*/1024, 
+				/*samplerate=*/44100, /*xrun=*/i == 0);
+			profiler::Time t = start;
+			profiler::mark(profiler::Stage::RENDER, t);
+			profiler::endBuffer(start);
+		}
+
+		profiler::Stats stats = profiler::getStats();
+
+		REQUIRE(stats.buffers == profiler::WINDOW);
+		REQUIRE(stats.deadline == (1024 * 1000000000ull) / 44100);
+		REQUIRE(stats.xruns == before.xruns + 1);
+		REQUIRE(stats.load >= 0.0f);
+		REQUIRE(stats.load < 1.0f);
+		REQUIRE(stats.worstLoad >= stats.load);
+		REQUIRE(stats.stages[static_cast<int>(profiler::Stage::LINE_IN)] == 0);
+	}
+
+	SECTION("Test channels from multiple threads")
+	{
+		const int THREADS = 4;
+		const int ROUNDS  = 1000;
+
+		profiler::reset();
+
+		std::vector<std::thread> threads;
+		for (int i = 0; i < THREADS; i++)
+			threads.emplace_back([]()
+			{
+				for (int r = 0; r < ROUNDS; r++)
+					for (ID id = 1; id <= 8; id++)
+						profiler::addChannel(id, profiler::now());
+			});
+		for (std::thread& t : threads)
+			t.join();
+
+		std::vector<profiler::Entry> entries = profiler::getChannels();
+
+		REQUIRE(entries.size() == 8);
+		for (const profiler::Entry& e : entries)
+			REQUIRE(e.count == THREADS * ROUNDS);
+	}
+
+	SECTION("Test removal")
+	{
+		profiler::reset();
+
+		profiler::addPlugin(1, profiler::now());
+		profiler::addPlugin(2, profiler::now());
+		profiler::removePlugin(1);
+
+		std::vector<profiler::Entry> entries = profiler::getPlugins();
+
+		REQUIRE(entries.size() == 1);
+		REQUIRE(entries[0].id == 2);
+
+		/* A new plug-in takes the released slot, starting from zero. */
+
+		profiler::addPlugin(1 + 1024, profiler::now());
+		profiler::addPlugin(2, profiler::now());
+
+		entries = profiler::getPlugins();
+
+		REQUIRE(entries.size() == 2);
+		for (const profiler::Entry& e : entries)
+			REQUIRE(e.count == (e.id == 2 ? 2 : 1));
+
+		profiler::reset();
+
+		REQUIRE(profiler::getPlugins().empty());
+	}
+
+	SECTION("Test crowded table")
+	{
+		/* IDs 1024 apart share the same slot: only the first ones within the
+		probing range are tracked, the others are dropped. */
+
+		profiler::reset();
+
+		for (ID id = 1; id <= 1024 * 32; id += 1024)
+			profiler::addChannel(id, profiler::now());
+
+		size_t tracked = profiler::getChannels().size();
+
+		REQUIRE(tracked > 0);
+		REQUIRE(tracked < 32);
+
+		/* Once a slot is released, a new ID can be tracked. */
+
+		profiler::removeChannel(1);
+		profiler::addChannel(1 + 1024 * 32, profiler::now());
+
+		REQUIRE(profiler::getChannels().size() == tracked);
+
+		profiler::reset();
+	}
+}
@@ -1,3 +1,6 @@
+#include <atomic>
+#include <thread>
+#include <vector>
 #include "../src/core/rcuList.h"
 #include "../src/core/types.h"
 #include <catch.hpp>
@@ -60,12 +63,29 @@ TEST_CASE("RCUList")
 				REQUIRE(o->id == id++);
 		}
 
+		SECTION("test find")
+		{
+			RCUList<Object>::Lock l(list);
+
+			REQUIRE((*list.find(2))->id == 2);
+			REQUIRE(list.find(16) == list.end());
+			REQUIRE(list.getIndex(1) == 0);
+			REQUIRE(list.getIndex(3) == 2);
+		}
+
 		SECTION("test pop")
 		{
 			list.pop(0);
 
 			REQUIRE(list.size() == 2);
 			REQUIRE(list.changed == true);
+
+			RCUList<Object>::Lock l(list);
+
+			REQUIRE(list.find(1) == list.end());
+			REQUIRE((*list.find(3))->id == 3);
+			REQUIRE(list.getIndex(2) == 0);
+			REQUIRE(list.getIndex(3) == 1);
 		}
 
 		SECTION("test clear")
@@ -89,5 +109,276 @@ TEST_CASE("RCUList")
 		RCUList<Object>::Lock l(list);
 		
 		REQUIRE(list.get(0)->id == 16);
+		REQUIRE(list.getIndex(16) == 0);
+		REQUIRE(list.find(1) == list.end());
+	}
+
+	SECTION("test batch push")
+	{
+		list.push(std::make_unique<Object>(1));
+
+		std::vector<std::unique_ptr<Object>> batch;
+		batch.push_back(std::make_unique<Object>(2));
+		batch.push_back(std::make_unique<Object>(3));
+		list.push(std::move(batch));
+
+		REQUIRE(list.size() == 3);
+		REQUIRE(list.changed == true);
+
+		RCUList<Object>::Lock l(list);
+
+		REQUIRE(list.get(2)->id == 3);
+		REQUIRE(list.getIndex(2) == 1);
 	}
+
+	SECTION("test version")
+	{
+		std::uint64_t v = list.getVersion();
+
+		list.push(std::make_unique<Object>(1));
+
+		REQUIRE(list.getVersion() > v);
+
+		/* Swapping an element is not a structural change. */
+
+		v = list.getVersion();
+		list.swap(std::make_unique<Object>(2));
+		
+		REQUIRE(list.getVersion() == v);
+		REQUIRE(list.changed == true);
+
+		v = list.getVersion();
+		list.pop(0);
+
+		REQUIRE(list.getVersion() > v);
+
+		list.push(std::make_unique<Object>(2));
+		v = list.getVersion();
+		list.clear();
+
+		REQUIRE(list.getVersion() > v);
+		
+		/* Reading doesn't alter the version. */
+
+		v = list.getVersion();
+		{
+			RCUList<Object>::Lock l(list);
+			REQUIRE(list.find(2) == list.end());
+		}
+
+		REQUIRE(list.getVersion() == v);
+	}
+}
+
+
+TEST_CASE("RCUList nested locks")
+{
+	static std::atomic<int> alive(0);
+
+	struct Object
+	{
+		Object(ID id) : id(id) { alive++; }
+		~Object() { alive--; }
+		ID id;
+	};
+
+	/* Two lists of the same type: locking one inside the other must register
+	the thread as a reader of both. */
+
+	RCUList<Object> a;
+	RCUList<Object> b;
+	a.push(std::make_unique<Object>(1));
+	b.push(std::make_unique<Object>(2));
+
+	a.lock();
+	b.lock();
+
+	REQUIRE(a.isLocked());
+	REQUIRE(b.isLocked());
+
+	const Object* o = b.get(0);
+	b.pop(0);
+	b.collect();
+	b.collect();
+
+	REQUIRE(alive.load() == 2);
+	REQUIRE(o->id == 2);
+
+	b.unlock();
+
+	REQUIRE(a.isLocked());
+	REQUIRE(!b.isLocked());
+
+	a.unlock();
+	b.collect();
+	b.collect();
+
+	REQUIRE(alive.load() == 1);
+}
+
+
+TEST_CASE("RCUList stress")
+{
+	static const int READERS = 4;
+	static const int WRITES  = 20000;
+	static const ID  MAGIC   = 0xABCD;
+
+	static std::atomic<int> alive(0);
+
+	struct Object
+	{
+		Object(ID id) : id(id), magic(MAGIC) { alive++; }
+		Object(const Object& o) : id(o.id), magic(o.magic) { alive++; }
+		~Object() { magic = 0; alive--; }
+		ID id;
+		ID magic;
+	};
+
+	RCUList<Object> list;
+	list.push(std::make_unique<Object>(0));
+	list.push(std::make_unique<Object>(0));
+
+	std::atomic<bool> running(true);
+	std::atomic<bool> corrupted(false);
+
+	/* Readers loop over the list as the audio thread would do, checking that
+	no object has been deleted under their feet. */
+
+	auto reader = [&]()
+	{
+		while (running.load()) {
+			RCUList<Object>::Lock l(list);
+			for (const Object* o : list) {
+				std::this_thread::yield(); // Give writers a chance to step in
+				if (o->magic != MAGIC)
+					corrupted.store(true);
+			}
+		}
+	};
+
+	/* Writers run concurrently: two of them swap the first element and push 
+	new ones, the third one keeps popping the second element. */
+
+	auto swapper = [&]()
+	{
+		for (int i=0; i<WRITES; i++) {
+			std::unique_ptr<Object> o = list.clone();
+			o->id++;
+			list.swap(std::move(o));
+			if (i % 10 == 0)
+				list.push(std::make_unique<Object>(i));
+		}
+	};
+
+	auto popper = [&]()
+	{
+		for (int i=0; i<WRITES; i++)
+			if (list.size() > 2)
+				list.pop(1);
+	};
+
+	/* Memory is collected way more often than the background reclaimer would
+	do, to stress the epoch mechanism. */
+
+	auto collector = [&]()
+	{
+		while (running.load())
+			list.collect();
+	};
+
+	std::vector<std::thread> readers;
+	for (int i=0; i<READERS; i++)
+		readers.emplace_back(reader);
+	std::thread c(collector);
+
+	std::thread w1(swapper);
+	std::thread w2(swapper);
+	std::thread w3(popper);
+	w1.join();
+	w2.join();
+	w3.join();
+
+	running.store(false);
+	for (std::thread& t : readers)
+		t.join();
+	c.join();
+
+	REQUIRE(corrupted.load() == false);
+
+	/* No readers left: two collections free everything retired so far. */
+
+	list.collect();
+	list.collect();
+
+	REQUIRE(alive.load() == static_cast<int>(list.size()));
+}
+
+
+TEST_CASE("RCUList stress, concurrent writers")
+{
+	static const int UPDATERS = 4;
+	static const int UPDATES  = 5000;
+	static const ID  TARGET   = -1;
+
+	struct Object
+	{
+		Object(ID id) : id(id), count(0) {}
+		ID  id;
+		int count;
+	};
+
+	auto copy = [](const Object& o) { return std::make_unique<Object>(o); };
+
+	/* The target element sits at the end of the list, while a popper keeps
+	removing elements before it and a pusher keeps adding new ones: its index
+	changes all the time. */
+
+	RCUList<Object> list;
+	for (ID id=1; id<=100; id++)
+		list.push(std::make_unique<Object>(id));
+	list.push(std::make_unique<Object>(TARGET));
+
+	std::atomic<bool> running(true);
+
+	auto updater = [&]()
+	{
+		for (int i=0; i<UPDATES; i++)
+			list.updateById(TARGET, copy, [](Object& o) { o.count++; });
+	};
+
+	auto popper = [&]()
+	{
+		while (running.load()) {
+			std::this_thread::yield();
+			RCUList<Object>::Lock l(list);
+			if (list.get(0)->id != TARGET)
+				list.pop(0);
+		}
+	};
+
+	auto pusher = [&]()
+	{
+		for (ID id=101; running.load(); id++) {
+			std::this_thread::yield();
+			if (list.size() < 200)
+				list.push(std::make_unique<Object>(id));
+		}
+	};
+
+	std::thread p1(popper);
+	std::thread p2(pusher);
+	std::vector<std::thread> updaters;
+	for (int i=0; i<UPDATERS; i++)
+		updaters.emplace_back(updater);
+	for (std::thread& t : updaters)
+		t.join();
+
+	running.store(false);
+	p1.join();
+	p2.join();
+
+	RCUList<Object>::Lock l(list);
+
+	REQUIRE(list.find(TARGET) != list.end());
+	REQUIRE((*list.find(TARGET))->count == UPDATERS * UPDATES);
 }
@@ -59,6 +59,34 @@ TEST_CASE("recorder")
 		}
 
 
+		SECTION("Test next action frame")
+		{
+			REQUIRE(recorder::getNextActionFrame(0)  == f1);
+			REQUIRE(recorder::getNextActionFrame(f1) == f2);
+			REQUIRE(recorder::getNextActionFrame(f2) == -1);
+		}
+
+		SECTION("Test actions on frame")
+		{
+			const Action a3 = recorder::rec(ch, f1, e2);
+
+			ActionRange r = recorder::getActionsOnFrame(f1);
+
+			REQUIRE(r.last - r.first == 2);
+			REQUIRE(r.first[0].id == a1.id);
+			REQUIRE(r.first[1].id == a3.id);
+			REQUIRE(recorder::getActionsOnFrame(f1 + 1).first == nullptr);
+			REQUIRE(recorder::getActionsOnFrame(f2).first->id == a2.id);
+			REQUIRE(recorder::getActionsOnFrame(0).first == nullptr); // Rewind
+			REQUIRE(recorder::getActionsOnFrame(f1).first->id == a1.id);
+		}
+
+		SECTION("Test get action by ID")
+		{
+			REQUIRE(recorder::getAction(a2.id).frame == f2);
+			REQUIRE(recorder::getAction(0).isValid() == false);
+		}
+
 		SECTION("Test clear all")
 		{
 			recorder::clearAll();
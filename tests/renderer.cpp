@@ -0,0 +1,148 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sndfile.h>
+#include "../src/core/channels/sampleChannel.h"
+#include "../src/core/model/model.h"
+#include "../src/core/renderer.h"
+#include "../src/core/mixer.h"
+#include "../src/core/mixerHandler.h"
+#include "../src/core/kernelAudio.h"
+#include "../src/core/clock.h"
+#include "../src/core/conf.h"
+#include "../src/core/wave.h"
+#include "../src/core/const.h"
+#include "../src/utils/fs.h"
+#include <catch.hpp>
+
+
+using namespace giada;
+using namespace giada::m;
+
+
+namespace
+{
+std::vector<float> read_(const std::string& path, SF_INFO& header)
+{
+	header.format = 0;
+	SNDFILE* file = sf_open(path.c_str(), SFM_READ, &header);
+	REQUIRE(file != nullptr);
+	std::vector<float> data(header.frames * header.channels);
+	REQUIRE(sf_readf_float(file, data.data(), header.frames) == header.frames);
+	sf_close(file);
+	return data;
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+TEST_CASE("renderer")
+{
+	static const char* PATH       = "test-render.wav";
+	static const char* STEMS_DIR  = "test-stems";
+	static const char* STEM_PATH  = "test-stems/10.wav";
+
+	const int   BUFFER_SIZE = 256;
+	const Frame WAVE_SIZE   = 1000;
+	const Frame FRAMES      = 2000;  // Not a multiple of the buffer size
+	const float VALUE       = 0.5f;
+	const ID    WAVE_ID     = 1;
+	const ID    CHANNEL_ID  = 10;
+
+	conf::buffersize  = BUFFER_SIZE;
+	conf::limitOutput = false;
+	kernelAudio::openOffline();
+	clock::init(conf::samplerate, conf::midiTCfps);
+	mh::init();
+
+	/* A single Sample channel, playing a constant wave once. */
+
+	std::unique_ptr<Wave> wave = std::make_unique<Wave>(WAVE_ID);
+	wave->alloc(WAVE_SIZE, G_MAX_IO_CHANS, conf::samplerate, G_DEFAULT_BIT_DEPTH, "test.wav");
+	wave->editBlocks(0, WAVE_SIZE, [&](float* data, Frame frames)
+	{
+		std::fill(data, data + frames * G_MAX_IO_CHANS, VALUE);
+	});
+	model::waves.push(std::move(wave));
+
+	model::channels.push(std::make_unique<SampleChannel>(false, BUFFER_SIZE, 1, CHANNEL_ID));
+	model::onSwap(model::channels, CHANNEL_ID, [&](Channel& c)
+	{
+		SampleChannel& ch = static_cast<SampleChannel&>(c);
+		ch.pushWave(WAVE_ID, WAVE_SIZE);
+		ch.mode       = ChannelMode::SINGLE_BASIC;
+		ch.playStatus = ChannelStatus::PLAY;
+	});
+
+	REQUIRE(u::fs::mkdir(STEMS_DIR));
+
+	renderer::Options o;
+	o.path      = PATH;
+	o.stemsPath = STEMS_DIR;
+	o.frames    = FRAMES;
+
+	std::vector<float> progress;
+	REQUIRE(renderer::render(o, [&](float p) { progress.push_back(p); }) == G_RES_OK);
+
+	SECTION("test master")
+	{
+		SF_INFO header;
+		std::vector<float> data = read_(PATH, header);
+
+		REQUIRE(header.frames == FRAMES);
+		REQUIRE(header.channels == G_MAX_IO_CHANS);
+		REQUIRE(header.samplerate == conf::samplerate);
+
+		for (Frame i=0; i<FRAMES * G_MAX_IO_CHANS; i++)
+			REQUIRE(data[i] == Approx(i < WAVE_SIZE * G_MAX_IO_CHANS ? VALUE : 0.0f));
+	}
+
+	SECTION("test stems")
+	{
+		SF_INFO header;
+		std::vector<float> master = read_(PATH, header);
+		std::vector<float> stem   = read_(STEM_PATH, header);
+
+		REQUIRE(header.frames == FRAMES);
+		REQUIRE(stem == master);
+	}
+
+	SECTION("test progress")
+	{
+		REQUIRE(progress.size() == (FRAMES + BUFFER_SIZE - 1) / BUFFER_SIZE);
+		REQUIRE(progress.back() == 1.0f);
+	}
+
+	SECTION("test sequencer stopped")
+	{
+		REQUIRE(clock::getStatus() == ClockStatus::STOPPED);
+		REQUIRE(clock::getCurrentFrame() == 0);
+	}
+
+	SECTION("test mixer state")
+	{
+		/* The mixer was disabled before rendering: it stays that way, while an
+		active one is enabled again when done. */
+
+		REQUIRE(mixer::isActive() == false);
+
+		mixer::enable();
+
+		REQUIRE(renderer::render(o) == G_RES_OK);
+		REQUIRE(mixer::isActive() == true);
+	}
+
+	SECTION("test bad path")
+	{
+		o.path = "does/not/exist/test-render.wav";
+		REQUIRE(renderer::render(o) == G_RES_ERR_IO);
+	}
+
+	std::remove(STEM_PATH);
+	std::remove(STEMS_DIR);
+	std::remove(PATH);
+	mh::close();
+}
@@ -0,0 +1,89 @@
+#include <vector>
+#include "../src/core/const.h"
+#include "../src/core/resampler.h"
+#include <catch.hpp>
+
+
+TEST_CASE("Resampler")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	static const int SIZE = 4096;
+	static const int OUT  = 256;
+
+	std::vector<float> in(SIZE * G_MAX_IO_CHANS);
+	std::vector<float> out(OUT * G_MAX_IO_CHANS, 0.0f);
+	for (int i=0; i<SIZE; i++) {
+		in[i * 2]     = static_cast<float>(i % 100) / 100.0f;
+		in[i * 2 + 1] = -in[i * 2];
+	}
+
+	auto qualities = { ResamplerQuality::LINEAR, ResamplerQuality::CUBIC, 
+		ResamplerQuality::SINC };
+
+	SECTION("test passthrough")
+	{
+		/* Linear and cubic interpolation go exactly through the original 
+		points. */
+
+		for (ResamplerQuality q : { ResamplerQuality::LINEAR, ResamplerQuality::CUBIC }) {
+			Resampler r(q);
+			REQUIRE(r.process(in.data(), SIZE, 100, SIZE, out.data(), OUT, 1.0f) == OUT);
+			for (int i=0; i<OUT * 2; i++)
+				REQUIRE(out[i] == in[200 + i]);
+		}
+	}
+
+	SECTION("test frames used")
+	{
+		for (ResamplerQuality q : qualities) {
+			for (float pitch : { 0.5f, 1.0f, 2.0f, 4.0f }) {
+				Resampler r(q);
+				REQUIRE(r.process(in.data(), SIZE, 0, SIZE, out.data(), OUT, pitch) == OUT * pitch);
+			}
+		}
+	}
+
+	SECTION("test DC gain")
+	{
+		std::fill(in.begin(), in.end(), 1.0f);
+		for (ResamplerQuality q : qualities) {
+			for (float pitch : { 0.3f, 1.0f, 1.7f, 4.0f }) {
+				Resampler r(q);
+				r.process(in.data(), SIZE, 1000, SIZE, out.data(), OUT, pitch);
+				for (float s : out)
+					REQUIRE(s == Approx(1.0f).margin(0.001f));
+			}
+		}
+	}
+
+	SECTION("test continuity")
+	{
+		/* Two consecutive calls must produce the same output of a single one, 
+		the fractional position being carried over. */
+
+		for (ResamplerQuality q : qualities) {
+			std::vector<float> whole(OUT * 2);
+			std::vector<float> split(OUT * 2);
+
+			Resampler a(q);
+			a.process(in.data(), SIZE, 50, SIZE, whole.data(), OUT, 0.73f);
+
+			Resampler b(q);
+			Frame used = b.process(in.data(), SIZE, 50, SIZE, split.data(), OUT / 2, 0.73f);
+			b.process(in.data(), SIZE, 50 + used, SIZE, split.data() + OUT, OUT / 2, 0.73f);
+
+			for (int i=0; i<OUT * 2; i++)
+				REQUIRE(split[i] == Approx(whole[i]).margin(0.000001f));
+		}
+	}
+
+	SECTION("test end of data")
+	{
+		for (ResamplerQuality q : qualities) {
+			Resampler r(q);
+			REQUIRE(r.process(in.data(), SIZE, SIZE - 10, SIZE, out.data(), OUT, 1.5f) == 10);
+		}
+	}
+}
@@ -0,0 +1,130 @@
+#include <vector>
+#include "../src/core/timeline.h"
+#include <catch.hpp>
+
+
+using namespace giada;
+using namespace giada::m;
+
+
+namespace
+{
+Action makeAction_(ID id, Frame frame)
+{
+	Action a;
+	a.id        = id;
+	a.channelId = 1;
+	a.frame     = frame;
+	return a;
+}
+
+
+std::vector<ID> getIds_(const Timeline& t)
+{
+	std::vector<ID> out;
+	for (const Action& a : t)
+		out.push_back(a.id);
+	return out;
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+TEST_CASE("Timeline")
+{
+	Timeline t;
+
+	REQUIRE(t.empty());
+	REQUIRE(t.find(1) == nullptr);
+	REQUIRE_FALSE(t.begin() != t.end());
+
+	SECTION("Test insert")
+	{
+		t.insert(makeAction_(1, 20));
+		t.insert(makeAction_(2, 10));
+		t.insert(makeAction_(3, 20));
+		t.insert(makeAction_(4, 30));
+
+		REQUIRE(t.size() == 4);
+		REQUIRE(getIds_(t) == std::vector<ID>({2, 1, 3, 4}));
+		REQUIRE(t.find(3)->frame == 20);
+		REQUIRE(t.find(5) == nullptr);
+
+		ActionRange r = t.getActionsOn(t.lowerBound(20), 20);
+		REQUIRE(r.last - r.first == 2);
+		REQUIRE(t.getFrameAfter(t.lowerBound(20), 20) == 30);
+		REQUIRE(t.getFrameAfter(t.lowerBound(30), 30) == -1);
+	}
+
+	SECTION("Test large timeline")
+	{
+		const int ACTIONS = Timeline::MAX_CHUNK_SIZE * 10;
+
+		/* Insert in reverse order, two actions per frame. */
+
+		for (int i = ACTIONS; i > 0; i--)
+			t.insert(makeAction_(i, i / 2));
+
+		REQUIRE(t.size() == ACTIONS);
+
+		Frame prev = -1;
+		for (const Action& a : t) {
+			REQUIRE(a.frame >= prev);
+			prev = a.frame;
+		}
+
+		for (int i = 1; i <= ACTIONS; i++)
+			REQUIRE(t.find(i)->frame == i / 2);
+
+		/* Walking forward gives the same result as searching. */
+
+		Timeline::Position p = t.lowerBound(0);
+		for (Frame f = 0; f <= ACTIONS / 2; f++) {
+			p = t.advance(p, f);
+			ActionRange r1 = t.getActionsOn(p, f);
+			ActionRange r2 = t.getActionsOn(t.lowerBound(f), f);
+			REQUIRE(r1.first == r2.first);
+			REQUIRE(r1.last  == r2.last);
+			REQUIRE(t.getFrameAfter(p, f) == (f < ACTIONS / 2 ? f + 1 : -1));
+		}
+
+		SECTION("Test remove")
+		{
+			t.removeIf([](const Action& a) { return a.id % 2 == 0; });
+
+			REQUIRE(t.size() == ACTIONS / 2);
+			REQUIRE(t.find(2) == nullptr);
+			REQUIRE(t.find(3)->frame == 1);
+		}
+	}
+
+	SECTION("Test copy-on-write")
+	{
+		t.insert(makeAction_(1, 10));
+		t.insert(makeAction_(2, 20));
+
+		const Action* a = t.find(1);
+
+		Timeline copy = t;
+		copy.update(1, [](Action& a) { a.nextId = 2; });
+		copy.removeIf([](const Action& a) { return a.id == 2; });
+
+		REQUIRE(t.find(1) == a);
+		REQUIRE(t.find(1)->nextId == 0);
+		REQUIRE(t.find(2) != nullptr);
+		REQUIRE(copy.find(1)->nextId == 2);
+		REQUIRE(copy.find(2) == nullptr);
+	}
+
+	SECTION("Test assign")
+	{
+		t.insert(makeAction_(9, 10));
+		t.assign({ makeAction_(1, 30), makeAction_(2, 10), makeAction_(3, 30) });
+
+		REQUIRE(t.size() == 3);
+		REQUIRE(t.find(9) == nullptr);
+		REQUIRE(getIds_(t) == std::vector<ID>({2, 1, 3}));
+	}
+}
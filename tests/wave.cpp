@@ -1,5 +1,7 @@
 #include <memory>
+#include <vector>
 #include "../src/core/wave.h"
+#include "../src/core/const.h"
 #include <catch.hpp>
 
 
@@ -46,4 +48,122 @@ TEST_CASE("Wave")
 			REQUIRE(wave.getBasename(true) == "sample.wav");
 		}
 	}
+
+	SECTION("test blocks")
+	{
+		static const int SIZE = G_WAVE_BLOCK_SIZE * 2 + 100;
+
+		m::Wave wave(1);
+		wave.alloc(SIZE, CHANNELS, SAMPLE_RATE, BIT_DEPTH, "path/to/sample.wav");
+		for (int i=0; i<SIZE; i++)
+			for (int k=0; k<CHANNELS; k++)
+				wave.editFrame(i)[k] = static_cast<float>(i);
+
+		SECTION("test read across blocks")
+		{
+			int a = G_WAVE_BLOCK_SIZE - 10;
+
+			std::vector<float> out(20 * CHANNELS);
+			wave.read(a, 20, out.data());
+
+			for (int i=0; i<20; i++)
+				REQUIRE(out[i * CHANNELS] == static_cast<float>(a + i));
+			REQUIRE(wave.getData(a, 20) == nullptr);
+			REQUIRE(wave.getData(a, 10) == wave.getFrame(a));
+		}
+
+		SECTION("test copy-on-write")
+		{
+			m::Wave copy(wave);
+
+			REQUIRE(copy.getSize() == SIZE);
+			REQUIRE(copy.getFrame(0) == wave.getFrame(0));
+
+			copy.editFrame(G_WAVE_BLOCK_SIZE)[0] = -1.0f;
+
+			REQUIRE(copy[G_WAVE_BLOCK_SIZE][0] == -1.0f);
+			REQUIRE(wave[G_WAVE_BLOCK_SIZE][0] == static_cast<float>(G_WAVE_BLOCK_SIZE));
+			
+			/* Only the touched block has been copied. */
+
+			REQUIRE(copy.getFrame(0) == wave.getFrame(0));
+			REQUIRE(copy.getFrame(G_WAVE_BLOCK_SIZE) != wave.getFrame(G_WAVE_BLOCK_SIZE));
+			REQUIRE(copy.getFrame(SIZE - 1) == wave.getFrame(SIZE - 1));
+		}
+
+		SECTION("test cut")
+		{
+			const float* tail = wave.getFrame(200);
+
+			wave.cut(100, 200);
+
+			REQUIRE(wave.getSize() == SIZE - 100);
+			REQUIRE(wave[99][0] == 99.0f);
+			REQUIRE(wave[100][0] == 200.0f);
+			REQUIRE(wave.getFrame(100) == tail); // Data not moved
+		}
+
+		SECTION("test trim")
+		{
+			wave.trim(G_WAVE_BLOCK_SIZE - 10, G_WAVE_BLOCK_SIZE + 10);
+
+			REQUIRE(wave.getSize() == 20);
+			for (int i=0; i<20; i++)
+				REQUIRE(wave[i][0] == static_cast<float>(G_WAVE_BLOCK_SIZE - 10 + i));
+		}
+
+		SECTION("test insert")
+		{
+			m::Wave src(wave);
+			src.trim(0, 50);
+
+			wave.insert(src, 10);
+
+			REQUIRE(wave.getSize() == SIZE + 50);
+			REQUIRE(wave[9][0] == 9.0f);
+			REQUIRE(wave[10][0] == 0.0f);
+			REQUIRE(wave[59][0] == 49.0f);
+			REQUIRE(wave[60][0] == 10.0f);
+			REQUIRE(wave[SIZE + 49][0] == static_cast<float>(SIZE - 1));
+
+			/* Insert into itself. */
+
+			wave.insert(wave, 0);
+
+			REQUIRE(wave.getSize() == (SIZE + 50) * 2);
+			REQUIRE(wave[SIZE + 50][0] == 0.0f);
+			REQUIRE(wave[SIZE + 59][0] == 9.0f);
+		}
+
+		SECTION("test rotate")
+		{
+			wave.rotate(100);
+
+			REQUIRE(wave.getSize() == SIZE);
+			REQUIRE(wave[0][0] == static_cast<float>(SIZE - 100));
+			REQUIRE(wave[100][0] == 0.0f);
+			REQUIRE(wave[SIZE - 1][0] == static_cast<float>(SIZE - 101));
+		}
+
+		SECTION("test edit after splice")
+		{
+			m::Wave copy(wave);
+			copy.cut(0, 10);
+			copy.editFrame(0)[0] = -1.0f;
+
+			REQUIRE(copy[0][0] == -1.0f);
+			REQUIRE(copy[1][0] == 11.0f);
+			REQUIRE(wave[10][0] == 10.0f);
+
+			/* Reading through a chain of pieces. */
+
+			std::vector<float> out(SIZE * CHANNELS);
+			wave.rotate(G_WAVE_BLOCK_SIZE + 1);
+			wave.rotate(SIZE - G_WAVE_BLOCK_SIZE - 1);
+			wave.read(0, SIZE, out.data());
+
+			for (int i=0; i<SIZE; i++)
+				REQUIRE(out[i * CHANNELS + 1] == static_cast<float>(i));
+		}
+	}
 }
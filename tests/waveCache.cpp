@@ -0,0 +1,90 @@
+#include <cstdio>
+#include <memory>
+#include "../src/core/waveManager.h"
+#include "../src/core/waveCache.h"
+#include "../src/core/wave.h"
+#include "../src/core/const.h"
+#include "../src/utils/fs.h"
+#include <catch.hpp>
+
+
+using namespace giada;
+using namespace giada::m;
+
+
+TEST_CASE("waveCache")
+{
+	static const char* PATH = "tests/resources/test.wav";
+	static const char* DIR  = "test-cache";
+
+	std::unique_ptr<Wave> wave = waveManager::createFromFile(PATH, 0, /*stream=*/false).wave;
+	REQUIRE(wave != nullptr);
+
+	waveCache::init(DIR);
+
+	waveCache::Key key = waveCache::makeKey(PATH, wave->getRate(), 0);
+	REQUIRE(key != 0);
+
+	char file[64];
+	snprintf(file, sizeof(file), "%s%c%016llx.gwc", DIR, G_SLASH, 
+		static_cast<unsigned long long>(key));
+
+	SECTION("test key")
+	{
+		REQUIRE(waveCache::makeKey(PATH, wave->getRate(), 0) == key);
+		REQUIRE(waveCache::makeKey(PATH, wave->getRate(), 1) != key);
+		REQUIRE(waveCache::makeKey(PATH, 48000, 0) != key);
+		REQUIRE(waveCache::makeKey("does/not/exist.wav", 44100, 0) == 0);
+	}
+
+	SECTION("test store and load")
+	{
+		REQUIRE(waveCache::load(key, 2, PATH) == nullptr);
+
+		waveCache::store(key, *wave);
+		std::unique_ptr<Wave> cached = waveCache::load(key, 2, PATH);
+
+		REQUIRE(cached != nullptr);
+		REQUIRE(cached->id == 2);
+		REQUIRE(cached->getSize() == wave->getSize());
+		REQUIRE(cached->getChannels() == wave->getChannels());
+		REQUIRE(cached->getRate() == wave->getRate());
+		REQUIRE(cached->getBits() == wave->getBits());
+		REQUIRE(cached->getPath() == PATH);
+		for (int i=0; i<wave->getSize(); i++)
+			for (int k=0; k<wave->getChannels(); k++)
+				REQUIRE(cached->getFrame(i)[k] == wave->getFrame(i)[k]);
+
+		SECTION("test copy of a cached Wave")
+		{
+			Wave copy(*cached);
+			copy.editFrame(0)[0] = 1.0f;
+			REQUIRE(cached->getFrame(0)[0] == wave->getFrame(0)[0]);
+		}
+	}
+
+	SECTION("test corrupt file")
+	{
+		REQUIRE(u::fs::mkdir(DIR));
+		FILE* f = fopen(file, "wb");
+		REQUIRE(f != nullptr);
+		fputs("garbage", f);
+		fclose(f);
+
+		REQUIRE(waveCache::load(key, 2, PATH) == nullptr);
+	}
+
+	SECTION("test cached loading")
+	{
+		REQUIRE(waveManager::createFromFile(PATH, 0, /*stream=*/false).wave != nullptr);
+		REQUIRE(u::fs::fileExists(file));
+
+		std::unique_ptr<Wave> cached = waveManager::createFromFile(PATH, 0, /*stream=*/false).wave;
+		REQUIRE(cached != nullptr);
+		REQUIRE(cached->getSize() == wave->getSize());
+	}
+
+	std::remove(file);
+	std::remove(DIR);
+	waveCache::init("");
+}
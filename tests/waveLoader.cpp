@@ -0,0 +1,49 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "../src/core/waveLoader.h"
+#include "../src/core/wave.h"
+#include <catch.hpp>
+
+
+using namespace giada;
+using namespace giada::m;
+
+
+TEST_CASE("WaveLoader")
+{
+	static const char* PATH = "tests/resources/test.wav";
+
+	std::vector<patch::Wave> waves;
+	for (ID id=1; id<=8; id++)
+		waves.push_back({ id, id == 4 ? "does/not/exist.wav" : PATH });
+
+	SECTION("test loading")
+	{
+		std::vector<float> progress;
+
+		WaveLoader loader(waves, 3);
+		std::vector<std::unique_ptr<Wave>> out = loader.wait([&](float v) { progress.push_back(v); });
+
+		REQUIRE(out.size() == 7);
+		for (size_t i=0; i<out.size(); i++) {
+			REQUIRE(out[i]->id == static_cast<ID>(i < 3 ? i + 1 : i + 2));
+			REQUIRE(out[i]->getSize() == out[0]->getSize());
+		}
+
+		REQUIRE(progress.size() > 0);
+		REQUIRE(progress.back() == 1.0f);
+		REQUIRE(std::is_sorted(progress.begin(), progress.end()));
+	}
+
+	SECTION("test empty batch")
+	{
+		WaveLoader loader({});
+		REQUIRE(loader.wait().empty());
+	}
+
+	SECTION("test destruction without wait")
+	{
+		WaveLoader loader(waves, 2);
+	}
+}
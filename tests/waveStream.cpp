@@ -0,0 +1,92 @@
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../src/core/waveManager.h"
+#include "../src/core/waveStream.h"
+#include "../src/core/diskReader.h"
+#include "../src/core/wave.h"
+#include "../src/core/const.h"
+#include <catch.hpp>
+
+
+using namespace giada;
+using namespace giada::m;
+
+
+TEST_CASE("WaveStream")
+{
+	static const char* PATH     = "tests/resources/test.wav";
+	static const Frame PRELOAD  = 4096;
+	static const Frame CAPACITY = 20000; // Smaller than the file: the ring wraps
+	static const Frame BLOCK    = 512;
+
+	/* The same file, fully loaded and streamed. */
+
+	std::unique_ptr<Wave> resident = waveManager::createFromFile(PATH, 0, /*stream=*/false).wave;
+	REQUIRE(resident != nullptr);
+	REQUIRE(resident->isStreamed() == false);
+
+	Wave streamed(1);
+	streamed.alloc(PRELOAD, G_MAX_IO_CHANS, resident->getRate(), resident->getBits(), PATH);
+	streamed.copyData(resident->getFrame(0), PRELOAD);
+	streamed.setStream(std::make_shared<WaveStream>(PATH, PRELOAD, CAPACITY));
+
+	REQUIRE(streamed.isStreamed() == true);
+	REQUIRE(streamed.getSize() == resident->getSize());
+
+	std::vector<float> expected(BLOCK * G_MAX_IO_CHANS);
+	std::vector<float> actual(BLOCK * G_MAX_IO_CHANS);
+
+	auto compare = [&](Frame start, Frame count)
+	{
+		resident->read(start, count, expected.data());
+		streamed.read(start, count, actual.data());
+		for (int i=0; i<count * G_MAX_IO_CHANS; i++)
+			REQUIRE(actual[i] == expected[i]);
+	};
+
+	SECTION("test sequential read")
+	{
+		diskReader::setBlocking(true);
+		for (Frame f=0; f<streamed.getSize(); f+=BLOCK)
+			compare(f, std::min(BLOCK, streamed.getSize() - f));
+		diskReader::setBlocking(false);
+
+		REQUIRE(streamed.getStream()->getUnderruns() == 0);
+	}
+
+	SECTION("test seek")
+	{
+		diskReader::setBlocking(true);
+		for (Frame f : { 30000, 100, 9000, 8990, PRELOAD - 10, 40000 })
+			compare(f, std::min(BLOCK, streamed.getSize() - f));
+		diskReader::setBlocking(false);
+
+		REQUIRE(streamed.getStream()->getUnderruns() == 0);
+	}
+
+	SECTION("test underrun")
+	{
+		/* No disk reader running: the stream can only play silence. */
+
+		streamed.read(20000, BLOCK, actual.data());
+		for (float s : actual)
+			REQUIRE(s == 0.0f);
+		REQUIRE(streamed.getStream()->getUnderruns() == 1);
+	}
+
+	SECTION("test disk reader")
+	{
+		diskReader::init();
+
+		streamed.getStream()->cue(20000);
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		for (Frame f=20000; f<20000 + BLOCK * 8; f+=BLOCK)
+			compare(f, BLOCK);
+
+		diskReader::close();
+
+		REQUIRE(streamed.getStream()->getUnderruns() == 0);
+	}
+}
@@ -0,0 +1,57 @@
+#include <atomic>
+#include <vector>
+#include "../src/core/workerPool.h"
+#include <catch.hpp>
+
+
+using namespace giada::m;
+
+
+TEST_CASE("WorkerPool")
+{
+	static const size_t JOBS    = 64;
+	static const int    BATCHES = 1000;
+
+	std::vector<std::atomic<int>> counters(JOBS);
+	for (std::atomic<int>& c : counters)
+		c.store(0);
+
+	auto job = [](size_t i, void* data)
+	{
+		(*static_cast<std::vector<std::atomic<int>>*>(data))[i]++;
+	};
+
+	WorkerPool pool;
+
+	SECTION("test serial")
+	{
+		pool.start(0);
+		pool.run(JOBS, job, &counters);
+
+		REQUIRE(pool.countWorkers() == 0);
+		for (const std::atomic<int>& c : counters)
+			REQUIRE(c.load() == 1);
+	}
+
+	SECTION("test parallel")
+	{
+		pool.start(3);
+		for (int i=0; i<BATCHES; i++)
+			pool.run(JOBS, job, &counters);
+
+		REQUIRE(pool.countWorkers() == 3);
+		for (const std::atomic<int>& c : counters)
+			REQUIRE(c.load() == BATCHES);
+	}
+
+	SECTION("test empty batch")
+	{
+		pool.start(2);
+		pool.run(0, job, &counters);
+
+		for (const std::atomic<int>& c : counters)
+			REQUIRE(c.load() == 0);
+	}
+
+	pool.stop();
+}